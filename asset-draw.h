@@ -0,0 +1,58 @@
+#pragma once
+#include "icon-blit.h"
+#include "assets.h"
+
+// =============================================================================
+//     MODULE D'AFFICHAGE DES IMAGES COMPRESSÉES (assets.h)
+// =============================================================================
+// Les images de tools/assets.txt sont rangées en Flash au format de l'écran
+// (pages de 8 points verticaux) et compressées par plages (tools/assets.py).
+// drawAsset() les décompresse au fil de la lecture, directement dans le
+// framebuffer : aucun tampon intermédiaire, quelle que soit la taille.
+//
+// Si y n'est pas un multiple de 8, chaque octet décodé est coupé en deux et
+// combiné avec deux pages de l'écran ; les points hors de l'écran sont ignorés.
+// -----------------------------------------------------------------------------
+
+extern FramebufferSSD1306 display;
+
+// Place un octet décodé (colonne x, page 'page' de l'image décalée de 'shift' lignes).
+inline void assetPut(uint8_t* buffer, int16_t width, int16_t pages, int16_t x, int16_t page,
+                     uint8_t shift, uint8_t bits, uint16_t color) {
+  if (bits == 0 || x < 0 || x >= width) return;
+  if (page >= 0 && page < pages) blitByte(buffer[page * width + x], bits << shift, color);
+  if (shift != 0 && page + 1 >= 0 && page + 1 < pages) blitByte(buffer[(page + 1) * width + x], bits >> (8 - shift), color);
+}
+
+/**
+ * @brief Dessine une image compressée de assets.h.
+ * @param id L'image (ASSET_...).
+ * @param x La colonne du coin haut gauche.
+ * @param y La ligne du coin haut gauche.
+ * @param color SSD1306_WHITE, SSD1306_BLACK ou SSD1306_INVERSE.
+ */
+void drawAsset(AssetId id, int16_t x, int16_t y, uint16_t color = SSD1306_WHITE) {
+  if (id >= ASSET_COUNT) return;
+  const AssetInfo& asset = ASSETS[id];
+  uint8_t* buffer = display.getBuffer();
+  const int16_t width = display.width();
+  const int16_t pages = (display.height() + 7) / 8;
+  const int16_t top = (y >= 0) ? y / 8 : -((7 - y) / 8);  // Page de la ligne y (arrondi vers le bas)
+  const uint8_t shift = y - top * 8;
+
+  const uint8_t* src = ASSET_DATA + asset.offset;
+  const uint8_t* end = src + asset.size;
+  int16_t col = 0, page = top;
+  while (src < end) {
+    uint8_t control = *src++;
+    bool repeat = (control & 0x80) != 0;
+    uint8_t count = repeat ? (control & 0x7F) + 2 : control + 1;
+    uint8_t value = repeat ? *src++ : 0;
+    while (count--) {
+      assetPut(buffer, width, pages, x + col, page, shift, repeat ? value : *src++, color);
+      if (++col == asset.width) { col = 0; page++; }
+    }
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,73 @@
+#pragma once
+
+// =============================================================================
+//     IMAGES COMPRESSÉES (FICHIER GÉNÉRÉ PAR tools/assets.py, NE PAS MODIFIER)
+// =============================================================================
+// Sources : tools/assets.txt. Format : voir tools/assets.py et asset-draw.h.
+// -----------------------------------------------------------------------------
+
+struct AssetInfo {
+  uint8_t width;
+  uint8_t height;
+  uint16_t offset;  // Position dans ASSET_DATA
+  uint16_t size;    // Octets compressés
+};
+
+enum AssetId : uint8_t {
+  ASSET_BOOTSCREEN,
+  ASSET_SCREENSAVER_0,
+  ASSET_SCREENSAVER_90,
+  ASSET_SCREENSAVER_180,
+  ASSET_SCREENSAVER_270,
+  ASSET_COUNT
+};
+
+const uint8_t ASSET_DATA[] PROGMEM = {
+  // ASSET_BOOTSCREEN : Image BootScreen/bootscreen_128x32.bmp
+  0x89, 0x0c, 0x04, 0xfc, 0xfc, 0x00, 0xff, 0xff, 0x83, 0x80, 0x16, 0xe0, 0xe0, 0x78, 0x78, 0x60,
+  0x60, 0x78, 0x78, 0x60, 0x60, 0x78, 0x60, 0x60, 0x78, 0x78, 0x60, 0x60, 0x78, 0x78, 0xe0, 0xe0,
+  0x80, 0x80, 0x82, 0x00, 0x05, 0x7e, 0x7e, 0x66, 0x66, 0x7e, 0x7e, 0x88, 0x00, 0x01, 0xfe, 0xfe,
+  0x81, 0xc6, 0x35, 0x00, 0x00, 0xe0, 0xe0, 0x60, 0x60, 0x00, 0xc0, 0xe0, 0x60, 0x60, 0xe0, 0xc0,
+  0x00, 0x00, 0xc0, 0xe0, 0x60, 0x60, 0xe0, 0xc0, 0x00, 0x00, 0xfe, 0xfe, 0x00, 0x00, 0xc0, 0xe0,
+  0x60, 0x60, 0xe0, 0xe0, 0x00, 0x00, 0xe0, 0xe0, 0x60, 0x60, 0xe0, 0xc0, 0x00, 0xc0, 0xe0, 0x60,
+  0x60, 0x00, 0x00, 0xc0, 0xe0, 0x60, 0x60, 0xe0, 0xc0, 0x8c, 0x00, 0x04, 0x80, 0x80, 0x9f, 0x9f,
+  0x98, 0x85, 0x99, 0x0b, 0xff, 0xff, 0x00, 0x00, 0x03, 0x03, 0x00, 0x03, 0x03, 0x00, 0x03, 0x03,
+  0x81, 0x00, 0x07, 0x6c, 0x6c, 0x00, 0x00, 0xff, 0xff, 0x99, 0x99, 0x82, 0x00, 0x05, 0x3f, 0x3f,
+  0x33, 0x33, 0x3f, 0x3f, 0x88, 0x00, 0x01, 0x3f, 0x3f, 0x83, 0x00, 0x01, 0x3f, 0x3f, 0x81, 0x00,
+  0x2e, 0x1f, 0x3f, 0x33, 0x33, 0x3b, 0x1b, 0x00, 0x00, 0x1f, 0x3f, 0x33, 0x33, 0x3b, 0x1b, 0x00,
+  0x00, 0x3f, 0x3f, 0x00, 0x00, 0x1f, 0x3f, 0x30, 0x18, 0x3f, 0x3f, 0x00, 0x00, 0x3f, 0x3f, 0x00,
+  0x00, 0x3f, 0x3f, 0x00, 0x1f, 0x3f, 0x30, 0x30, 0x00, 0x00, 0x1f, 0x3f, 0x33, 0x33, 0x3b, 0x1b,
+  0x83, 0x00, 0x87, 0x18, 0x05, 0x1f, 0x1f, 0x01, 0xf9, 0xf9, 0x19, 0x84, 0xd9, 0x03, 0xff, 0xff,
+  0x00, 0x00, 0x82, 0x60, 0x85, 0x00, 0x07, 0x3f, 0x3f, 0x00, 0x00, 0xff, 0xff, 0xc9, 0xc9, 0x85,
+  0x00, 0x01, 0xf8, 0xf8, 0x92, 0x00, 0x03, 0xe0, 0xfc, 0xfc, 0xe0, 0x81, 0x00, 0x00, 0x80, 0x81,
+  0xc0, 0x03, 0xfe, 0xfe, 0x00, 0x80, 0x81, 0xc0, 0x04, 0xfe, 0xfe, 0x00, 0x00, 0x80, 0x82, 0xc0,
+  0x02, 0x80, 0x00, 0x00, 0x83, 0xc0, 0x02, 0x80, 0x00, 0x80, 0x82, 0xc0, 0x8b, 0x00, 0x8a, 0x18,
+  0x04, 0x1f, 0x1f, 0x00, 0xff, 0xff, 0x82, 0x00, 0x14, 0x03, 0x03, 0x1f, 0x1f, 0x03, 0x03, 0x1f,
+  0x1f, 0x03, 0x03, 0x1f, 0x03, 0x03, 0x1f, 0x1f, 0x03, 0x03, 0x7f, 0x7f, 0x63, 0x63, 0x84, 0x60,
+  0x05, 0x00, 0x60, 0x60, 0x07, 0x67, 0x60, 0x8f, 0x00, 0x2b, 0x60, 0x7e, 0x1f, 0x18, 0x18, 0x1f,
+  0x7e, 0x60, 0x00, 0x3f, 0x7f, 0x60, 0x60, 0x7f, 0x7f, 0x00, 0x3f, 0x7f, 0x60, 0x60, 0x7f, 0x7f,
+  0x00, 0x00, 0x3f, 0x7f, 0x60, 0x60, 0x7f, 0x3f, 0x00, 0x00, 0x7f, 0x7f, 0x00, 0x00, 0x7f, 0x7f,
+  0x00, 0x63, 0x67, 0x6e, 0x7c, 0x38, 0x8b, 0x00,
+  // ASSET_SCREENSAVER_0 : icones screensaver/icon_screensaver_0.bmp
+  0x81, 0x00, 0x09, 0xc0, 0x20, 0x90, 0xc8, 0x68, 0x68, 0x08, 0x10, 0x20, 0xc0, 0x84, 0x00, 0x09,
+  0x03, 0x04, 0x09, 0x10, 0x10, 0x14, 0x12, 0x08, 0x04, 0x03, 0x81, 0x00,
+  // ASSET_SCREENSAVER_90 : icones screensaver/icon_screensaver_90.bmp
+  0x81, 0x00, 0x09, 0xc0, 0x20, 0x10, 0x08, 0x28, 0x68, 0xc8, 0x90, 0x20, 0xc0, 0x84, 0x00, 0x09,
+  0x03, 0x04, 0x09, 0x12, 0x10, 0x10, 0x11, 0x09, 0x04, 0x03, 0x81, 0x00,
+  // ASSET_SCREENSAVER_180 : icones screensaver/icon_screensaver_180.bmp
+  0x81, 0x00, 0x09, 0xc0, 0x20, 0x10, 0x48, 0x28, 0x08, 0x08, 0x90, 0x20, 0xc0, 0x84, 0x00, 0x09,
+  0x03, 0x04, 0x08, 0x10, 0x16, 0x16, 0x13, 0x09, 0x04, 0x03, 0x81, 0x00,
+  // ASSET_SCREENSAVER_270 : icones screensaver/icon_screensaver_270.bmp
+  0x81, 0x00, 0x09, 0xc0, 0x20, 0x90, 0x88, 0x08, 0x08, 0x48, 0x90, 0x20, 0xc0, 0x84, 0x00, 0x09,
+  0x03, 0x04, 0x09, 0x13, 0x16, 0x14, 0x10, 0x08, 0x04, 0x03, 0x81, 0x00,
+};
+
+const AssetInfo ASSETS[ASSET_COUNT] = {
+  { 128, 32, 0, 376 },  // ASSET_BOOTSCREEN
+  { 16, 16, 376, 28 },  // ASSET_SCREENSAVER_0
+  { 16, 16, 404, 28 },  // ASSET_SCREENSAVER_90
+  { 16, 16, 432, 28 },  // ASSET_SCREENSAVER_180
+  { 16, 16, 460, 28 },  // ASSET_SCREENSAVER_270
+};
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,171 @@
+#pragma once
+#include "index-seq.h"
+
+// =============================================================================
+//     MODULE DES ACCORDS (COMBINAISONS DE TOUCHES)
+// =============================================================================
+// Une touche seule déclenche sa macro (KEYMAP). Plusieurs touches pressées
+// ensemble, à moins de COMBO_WINDOW_MS d'écart, déclenchent à la place
+// l'action d'un accord de la table COMBOS (config.h) : 9 touches donnent
+// bien plus de 9 actions par couche.
+//
+// Les touches retenues forment un masque (bit 0 = K1 ... bit 8 = K9).
+// COMBO_INDEX a une case par couche et par masque (2^NUM_KEYS = 512),
+// calculée à la compilation et rangée en Flash : trouver l'accord d'un
+// masque = lire une case, quel que soit le nombre d'accords.
+//   bits 0-6 : numéro de l'accord dans COMBOS, ou COMBO_NONE
+//   bit 7    : le masque est une partie d'un accord plus grand (on attend)
+//
+// Une touche qui ne fait partie d'aucun accord de la couche part tout de
+// suite. Sinon sa macro est retenue jusqu'à ce que :
+//  - l'accord soit complet : son action part, les macros des touches sont supprimées ;
+//  - une touche retenue soit relâchée, ou la fenêtre écoulée : l'accord exact
+//    part s'il y en a un, sinon les macros retenues partent dans l'ordre d'appui ;
+//  - une touche étrangère aux touches retenues soit pressée : idem, puis
+//    cette touche est traitée à son tour.
+// -----------------------------------------------------------------------------
+
+const uint8_t COMBO_NONE = 0x7F;      // Pas d'accord pour ce masque
+const uint8_t COMBO_PREFIX = 0x80;    // Partie d'un accord plus grand
+const uint16_t COMBO_MASKS = 1u << NUM_KEYS;
+static_assert(NUM_KEYS <= 10, "COMBO_INDEX a 2^NUM_KEYS cases par couche");
+
+// --- Index calculé à la compilation ---
+struct ComboRow {
+  uint8_t entry[COMBO_MASKS];
+};
+template <size_t L>
+struct ComboIndex {
+  ComboRow layers[L];
+};
+
+constexpr bool comboOnLayer(const Combo& c, uint8_t layer) {
+  return c.layer == layer || c.layer == COMBO_ALL_LAYERS;
+}
+
+// Case du masque 'mask' sur la couche 'layer' (le premier accord de la table l'emporte).
+constexpr uint8_t comboEntry(const Combo* combos, size_t count, uint8_t layer, uint16_t mask,
+                             size_t i = 0, uint8_t found = COMBO_NONE, bool prefix = false) {
+  return i >= count ? (uint8_t)(found | (prefix ? COMBO_PREFIX : 0))
+       : !comboOnLayer(combos[i], layer) ? comboEntry(combos, count, layer, mask, i + 1, found, prefix)
+       : comboEntry(combos, count, layer, mask, i + 1,
+                    (found == COMBO_NONE && combos[i].keys == mask) ? (uint8_t)i : found,
+                    prefix || (mask != 0 && mask != combos[i].keys && (mask & ~combos[i].keys) == 0));
+}
+
+template <size_t... M>
+constexpr ComboRow comboRow(const Combo* combos, size_t count, uint8_t layer, IndexSeq<M...>) {
+  return ComboRow{ { comboEntry(combos, count, layer, (uint16_t)M)... } };
+}
+
+template <size_t L, size_t... I>
+constexpr ComboIndex<L> comboIndexFrom(const Combo* combos, size_t count, IndexSeq<I...>) {
+  return ComboIndex<L>{ { comboRow(combos, count, (uint8_t)I, typename MakeIndexSeq<COMBO_MASKS>::type())... } };
+}
+
+// Construit l'index de toutes les couches : utilisable dans un constexpr.
+// La table peut être vide : aucune touche n'attend alors.
+template <size_t L>
+constexpr ComboIndex<L> comboIndex(const Combo* combos, size_t count) {
+  return comboIndexFrom<L>(combos, count, typename MakeIndexSeq<L>::type());
+}
+
+// --- Déclarations des fonctions externes ---
+void wakeUp();
+void fireMacro(uint8_t id);
+
+// --- Déclaration des variables GLOBALES utilisées par ce module ---
+extern uint8_t currentLayer;
+
+// --- Variables propres à ce module ---
+constexpr ComboIndex<NUM_LAYERS> COMBO_INDEX PROGMEM = comboIndex<NUM_LAYERS>(COMBOS, NUM_COMBOS);
+uint16_t comboPending = 0;            // Touches retenues (masque)
+uint8_t comboOrder[NUM_KEYS];         // Les mêmes, dans l'ordre d'appui
+uint32_t comboPressUs[NUM_KEYS];      // Instant de l'appui de chaque touche retenue
+uint8_t comboCount = 0;
+uint8_t comboLayer = 0;               // Couche au premier appui retenu
+uint32_t comboChords = 0;             // Accords déclenchés
+uint32_t comboHeld = 0;               // Appuis retenus
+uint32_t comboReleased = 0;           // Appuis retenus rendus à leur macro
+
+inline uint8_t comboLookup(uint8_t layer, uint16_t mask) {
+  return COMBO_INDEX.layers[layer].entry[mask];
+}
+
+// Macro d'une touche seule ; le délai est mesuré depuis son appui.
+void comboFireKey(uint8_t key, uint32_t timeUs) {
+  profileInput(timeUs, LATENCY_KEY);
+  fireMacro(key);
+  profileInputDone();
+}
+
+void comboFireChord(uint8_t chord, uint32_t timeUs) {
+  if (chord >= NUM_COMBOS) return;
+  comboChords++;
+  profileInput(timeUs, LATENCY_KEY);
+  COMBOS[chord].action.handler(COMBOS[chord].action);
+  profileInputDone();
+}
+
+// Rend les touches retenues à leurs macros, dans l'ordre d'appui.
+void comboFlush() {
+  const uint8_t count = comboCount;
+  comboCount = 0;
+  comboPending = 0;
+  comboReleased += count;
+  for (uint8_t i = 0; i < count; i++) comboFireKey(comboOrder[i], comboPressUs[comboOrder[i]]);
+}
+
+// Fin de l'attente : l'accord exact des touches retenues, sinon leurs macros.
+void comboResolve() {
+  const uint8_t chord = comboLookup(comboLayer, comboPending) & COMBO_NONE;
+  if (chord == COMBO_NONE) { comboFlush(); return; }
+  const uint32_t timeUs = comboPressUs[comboOrder[comboCount - 1]];
+  comboCount = 0;
+  comboPending = 0;
+  comboFireChord(chord, timeUs);
+}
+
+/**
+ * @brief Appui d'une touche en mode normal (à la place de fireMacro()).
+ * @param key La touche (de 0 à NUM_KEYS - 1).
+ * @param timeUs L'instant de l'appui (InputEvent::timeUs).
+ */
+void comboKeyDown(uint8_t key, uint32_t timeUs) {
+  if (key >= NUM_KEYS || currentLayer >= NUM_LAYERS) return;
+  wakeUp(); // Tout de suite, même si la macro attend : l'écran et la veille suivent l'appui
+  if (comboCount == 0) comboLayer = currentLayer;
+  const uint16_t bit = 1u << key;
+  uint8_t entry = comboLookup(comboLayer, comboPending | bit);
+  if (comboCount > 0 && entry == COMBO_NONE) {
+    comboFlush();                  // Touche étrangère aux touches retenues
+    comboLayer = currentLayer;     // Une macro rendue a pu changer de couche
+    entry = comboLookup(comboLayer, bit);
+  }
+  if (entry == COMBO_NONE) { comboFireKey(key, timeUs); return; }
+
+  comboPending |= bit;
+  comboOrder[comboCount++] = key;
+  comboPressUs[key] = timeUs;
+  comboHeld++;
+  if (entry & COMBO_PREFIX) return; // Un accord plus grand reste possible
+  comboResolve();                   // Accord complet
+}
+
+/**
+ * @brief Relâchement d'une touche : une touche retenue termine l'attente.
+ * @param key La touche (de 0 à NUM_KEYS - 1).
+ */
+void comboKeyUp(uint8_t key) {
+  if (key < NUM_KEYS && (comboPending & (1u << key))) comboResolve();
+}
+
+/**
+ * @brief Termine l'attente quand la fenêtre est écoulée ; à appeler à chaque tour de loop().
+ * @param nowUs L'instant présent (micros()).
+ */
+void comboTick(uint32_t nowUs) {
+  if (comboCount > 0 && nowUs - comboPressUs[comboOrder[0]] >= COMBO_WINDOW_MS * 1000UL) comboResolve();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
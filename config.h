@@ -1,23 +1,34 @@
 #pragma once // Empêche le fichier d'être inclus plusieurs fois par erreur
 
 // --- Déclaration des variables GLOBALES utilisées ---
-extern Adafruit_SSD1306 display;
+extern FramebufferSSD1306 display;
 extern USBHIDConsumerControl Consumer;
+extern uint8_t oledBrightness;
+extern bool muted;
 // ---
 
-// Voici un exemple complet pour lancer le Bloc-notes sur la touche 1.
-// Pour l'activer, retirez les '/*' et '*/' et supprimez la ligne du TODO en dessous.  
+// Voici un exemple complet pour lancer le Bloc-notes sur la touche 1 de la couche 0.
+// Remplacez simplement la case correspondante de la table KEYMAP ci-dessous :
   /*
-  case K1: showMessage("NOTEPAD"); openViaRun("notepad.exe"); 
-  case K7: showMessage("Macro 7"); sendAltTab(); break;
-  case K8: showMessage("Macro 8"); sendWinD(); break;
-    break;
+  RunCmd("notepad.exe", "NOTEPAD", icon_notpad_16x16),   // K1
+  AltTab(),                                              // K7
+  WinD(),                                                // K8
   */
 
 // =============================================================================
 //     FICHIER DE CONFIGURATION DES MACROS
 // =============================================================================
 // C'est ici que vous définissez les actions pour chaque touche et chaque couche.
+// Actions disponibles (voir keymap.h) :
+//   Message("texte")                    : affiche seulement un texte
+//   RunCmd("cmd", "texte", icone)       : ouvre une commande via Win+R
+//   Ctrl('c', "texte")                  : Ctrl + touche
+//   CtrlShift('t', "texte")             : Ctrl + Shift + touche
+//   AltTab(), WinD()                    : raccourcis Windows
+//   Media(HID_USAGE_CONSUMER_..., "texte") : touche multimédia
+//   LayerNext()                         : passe à la couche suivante
+//   Program("bytecode", "texte", icone) : macro en bytecode (macro-vm.h,
+//                                         assemblée par tools/macro_asm.py)
 // -----------------------------------------------------------------------------
 
 // --- gérer la logique d'affichage personnalisé ---
@@ -25,71 +36,131 @@ void displayCustomAction(const char* label, const unsigned char* icon) {
   // Ensuite, on prépare l'affichage
   display.clearDisplay();
   // 2. On dessine l'icône
-  display.drawBitmap((SCREEN_WIDTH - 16) / 2, 14, icon, 16, 16, SSD1306_WHITE);
-  // 3. On prépare et dessine le texte
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(42, 2); // Vous pouvez ajuster cette position
-  display.print(F(label));
+  display.drawIcon16((SCREEN_WIDTH - 16) / 2, 14, icon, SSD1306_WHITE);
+  // 3. On dessine le texte
+  display.drawText(42, 2, label); // Vous pouvez ajuster cette position
   // 4. On affiche le tout en une seule fois
   display.display();
 }
 
-void executeMacroForLayer0(uint8_t id) {
-  showMessage("Layer 0");
-  switch (id) {
-    case K1:
-      // D'abord, on exécute la macro qui prend du temps
-      openViaRun("notepad3.exe");
-      displayCustomAction("NOTEPAD.3", icon_notpad_16x16);
-      break;
+// Une ligne par couche, une case par touche (K1 à K9).
+// Pour ajouter une couche, copiez un bloc { ... } : NUM_LAYERS suit tout seul.
+constexpr KeyAction KEYMAP[][NUM_KEYS] PROGMEM = {
+  { // --- Couche 0 ---
+    /* K1 */ RunCmd("notepad3.exe", "NOTEPAD.3", icon_notpad_16x16),
+    /* K2 */ RunCmd("cmd", "(CMD) Commandes", icon_menu_parametres_16x16),
+    /* K3 */ Message("Macro 3.0"), /* TODO */
+    // Exemple en bytecode : /* K3 */ Program("\x04\x0a\x03s\x04\x00", "Capture"), // MODS gui shift, TAP s, MODS 0 : Win+Shift+S
+    /* K4 */ Message("Macro 4.0"), /* TODO */
+    /* K5 */ Message("Macro 5.0"), /* TODO */
+    /* K6 */ Message("Macro 6.0"), /* TODO */
+    /* K7 */ Message("Macro 7.0"), /* TODO */
+    /* K8 */ AltTab(),
+    /* K9 */ LayerNext(),
+  },
+  { // --- Couche 1 ---
+    /* K1 */ Ctrl('c', "Copier"),
+    /* K2 */ Ctrl('v', "Coller"),
+    /* K3 */ Ctrl('x', "Couper"),
+    /* K4 */ Ctrl('z', "Annuler"),
+    /* K5 */ CtrlShift('t', "Re-Open Tab"),   // Envoie le raccourci Ctrl+Shift+T
+    /* K6 */ Message("Macro 6.1"), /* TODO */
+    /* K7 */ Message("Macro 7.1"), /* TODO */
+    /* K8 */ WinD(),
+    /* K9 */ LayerNext(),
+  },
+  { // --- Couche 2 ---
+    /* K1 */ Media(HID_USAGE_CONSUMER_PLAY_PAUSE, "Play/Pause"),
+    /* K2 */ Media(HID_USAGE_CONSUMER_SCAN_NEXT, "Suivant"),
+    /* K3 */ Media(HID_USAGE_CONSUMER_SCAN_PREVIOUS, "Precedent"),
+    /* K4 */ Message("Macro 4.2"), /* TODO */
+    /* K5 */ Message("Macro 5.2"), /* TODO */
+    /* K6 */ Message("Macro 6.2"), /* TODO */
+    /* K7 */ Message("Macro 7.2"), /* TODO */
+    /* K8 */ Message("Macro 8.2"), /* TODO */
+    /* K9 */ LayerNext(),
+  },
+};
 
-    case K2:
-      // D'abord, on exécute la macro qui prend du temps
-      openViaRun("cmd");
-      displayCustomAction("(CMD) Commandes", icon_menu_parametres_16x16);
-      break;
+const uint8_t NUM_LAYERS = sizeof(KEYMAP) / sizeof(KEYMAP[0]); // Nombre total de couches
 
-    case K3: showMessage("Macro 3.0"); /* TODO */ break;
-    case K4: showMessage("Macro 4.0"); /* TODO */ break;
-    case K5: showMessage("Macro 5.0"); /* TODO */ break;
-    case K6: showMessage("Macro 6.0"); /* TODO */ break;
-    case K7: showMessage("Macro 7.0"); /* TODO */ break;
-    case K8: sendAltTab(); break;
-  }
-}
+// --- Accords : touches pressées ensemble (voir combo.h) ---
+// Les touches d'un accord pressées à moins de COMBO_WINDOW_MS d'écart
+// déclenchent son action à la place de leurs propres macros. Seules les
+// touches qui font partie d'un accord de la couche attendent ce délai.
+// Les exemples sont désactivés : décommentez ceux que vous voulez (la table
+// peut rester vide, aucune touche n'attend alors).
+const unsigned long COMBO_WINDOW_MS = 50;
 
-void executeMacroForLayer1(uint8_t id) {
-  showMessage("Layer 1");
-  switch (id) {
-    case K1: showMessage("Copier");  sendCombo_Ctrl('c'); break;
-    case K2: showMessage("Coller");  sendCombo_Ctrl('v'); break;
-    case K3: showMessage("Couper");  sendCombo_Ctrl('x'); break;
-    case K4: showMessage("Annuler"); sendCombo_Ctrl('z'); break;
+constexpr Combo COMBOS[] PROGMEM = {
+  // Chord(0, Keys(K1, K2), Ctrl('s', "Enregistrer")),
+  // Chord(0, Keys(K4, K5), Message("Accord 4+5")),   // Exemple : remplacez Message() par l'action voulue
+  // Chord(1, Keys(K1, K2), CtrlShift('v', "Coller texte")),
+  // Chord(1, Keys(K3, K4), Ctrl('y', "Retablir")),
+  // Chord(2, Keys(K2, K3), Media(HID_USAGE_CONSUMER_STOP, "Stop")),
+  // Chord(COMBO_ALL_LAYERS, Keys(K6, K7), CtrlShift('n', "Nouv. fenetre")),
+};
 
-    case K5: 
-      showMessage("Re-Open Tab"); // 1. Affiche un message sur l'écran
-      sendCombo_CtrlShift('t');   // 2. Envoie le raccourci Ctrl+Shift+T
-      break;                      // 3. Ne pas oublier le break;
-      
-    case K6: showMessage("Macro 6.1"); /* TODO */ break;
-    case K7: showMessage("Macro 7.1"); /* TODO */ break;
-    case K8: sendWinD(); break;
-  }
-}
+const uint8_t NUM_COMBOS = sizeof(COMBOS) / sizeof(Combo); // Nombre d'accords (0 si la table est vide)
 
-void executeMacroForLayer2(uint8_t id) {
-  showMessage("Layer 2");
-  switch (id) {
-    case K1: showMessage("Play/Pause"); Consumer.press(HID_USAGE_CONSUMER_PLAY_PAUSE); Consumer.release(); break;
-    case K2: showMessage("Suivant");    Consumer.press(HID_USAGE_CONSUMER_SCAN_NEXT); Consumer.release(); break;
-    case K3: showMessage("Precedent");  Consumer.press(HID_USAGE_CONSUMER_SCAN_PREVIOUS); Consumer.release(); break;
-    case K4: showMessage("Macro 4.2"); /* TODO */ break;
-    case K5: showMessage("Macro 5.2"); /* TODO */ break;
-    case K6: showMessage("Macro 6.2"); /* TODO */ break;
-    case K7: showMessage("Macro 7.2"); /* TODO */ break;
-    case K8: showMessage("Macro 8.2"); /* TODO */ break;
-  }
-}
+// --- Accélération de l'encodeur (une ligne par mode, voir encoder.h) ---
+// Si deux crans sont séparés de moins de 'fasterThanMs' ms, chaque cran
+// compte 'multiplier' pas. Une rotation lente donne toujours 1 pas par cran.
+// Mettez les multiplicateurs à 1 pour désactiver l'accélération d'un mode.
+const EncoderAccel ENCODER_ACCEL[] = {
+  /* MODE_VOLUME    */ { { 20, 40, 80 }, { 4, 3, 2 } },
+  /* MODE_SCROLL    */ { { 20, 40, 80 }, { 8, 4, 2 } },
+  /* MODE_HSCROLL   */ { { 20, 40, 80 }, { 4, 2, 2 } },
+  /* MODE_UNDO_REDO */ { {  0,  0,  0 }, { 1, 1, 1 } }, // Annuler : toujours pas à pas
+};
+
+// --- Profils par application (compagnon tools/macropad_host.py, voir host-link.h) ---
+// Quand l'ordinateur signale l'application au premier plan, le premier profil
+// dont le texte apparaît dans son nom (sans tenir compte des majuscules)
+// choisit la couche et le mode de l'encodeur. Une application absente de la
+// table rend la couche et le mode choisis à la main.
+const AppProfile APP_PROFILES[] = {
+  { "code",      1,                  MODE_UNDO_REDO },  // Visual Studio Code
+  { "notepad",   1,                  MODE_UNDO_REDO },
+  { "firefox",   PROFILE_KEEP_LAYER, MODE_SCROLL },
+  { "chrome",    PROFILE_KEEP_LAYER, MODE_SCROLL },
+  { "spotify",   2,                  MODE_VOLUME },
+  { "vlc",       2,                  MODE_VOLUME },
+};
+
+// --- Menu de configuration (appui très long sur l'encodeur, voir menu.h) ---
+// Chaque sous-menu est un tableau d'entrées ; une liste plus longue que
+// l'écran (4 lignes) défile d'elle-même.
+// Une entrée par couche de KEYMAP ("Couche 0", "Couche 1"...), générée (menu.h).
+constexpr MenuLabels<NUM_LAYERS> LAYER_LABELS PROGMEM = MenuNumberedLabels<NUM_LAYERS>("Couche ");
+constexpr MenuList<NUM_LAYERS + 2> MENU_LAYERS PROGMEM =
+  MenuNumbered(LAYER_LABELS, selectLayer, MenuAction("Suivante", selectLayer, SELECT_NEXT));
+constexpr MenuNode MENU_ENCODER[] PROGMEM = {
+  MenuAction("Volume", selectEncoderMode, MODE_VOLUME),
+  MenuAction("Scroll", selectEncoderMode, MODE_SCROLL),
+  MenuAction("Scroll H", selectEncoderMode, MODE_HSCROLL),
+  MenuAction("Undo/Redo", selectEncoderMode, MODE_UNDO_REDO),
+  MenuBack(),
+};
+constexpr MenuNode CONFIG_ITEMS[] PROGMEM = {
+  MenuValue("Luminosite", &oledBrightness, 0, 255, 15, setBrightness),
+  MenuToggle("Muet", &muted, setMute),
+  MenuSubmenu("Couche", MENU_LAYERS.items),
+  MenuSubmenu("Encodeur", MENU_ENCODER),
+  MenuAction("Menu Principal", returnToIconMenu),
+  MenuBack("Sortir"),
+};
+constexpr MenuNode CONFIG_MENU = MenuSubmenu("Configuration", CONFIG_ITEMS);
+
+// --- Vérifications à la compilation ---
+static_assert(sizeof(ENCODER_ACCEL) / sizeof(ENCODER_ACCEL[0]) == NUM_ENCODER_MODES, "ENCODER_ACCEL doit avoir une ligne par mode de l'encodeur");
+static_assert(NUM_KEYS == K9 + 1, "KEY_PINS et KeyIds n'ont pas le meme nombre de touches");
+static_assert(sizeof(KEYMAP[0]) / sizeof(KEYMAP[0][0]) == NUM_KEYS, "Chaque couche doit avoir NUM_KEYS cases");
+static_assert(sizeof(KEYMAP) / sizeof(KEYMAP[0]) >= 1 && sizeof(KEYMAP) / sizeof(KEYMAP[0]) <= 255, "Entre 1 et 255 couches");
+static_assert(keymapComplete(KEYMAP), "Une touche de KEYMAP n'a pas d'action (case manquante ?)");
+static_assert(combosValid(COMBOS, NUM_COMBOS, NUM_KEYS, NUM_LAYERS), "Un accord de COMBOS est invalide (moins de 2 touches, couche ou touche inexistante ?)");
+static_assert(sizeof(COMBOS) / sizeof(Combo) < 0x7F, "Au plus 126 accords (COMBO_NONE, combo.h)");
+static_assert(menuNumberedFits("Couche ", NUM_LAYERS), "Trop de couches pour les textes du menu (MENU_LABEL_LEN, menu.h)");
+static_assert(menuDepth(CONFIG_ITEMS) <= MENU_MAX_DEPTH, "Trop de niveaux de sous-menus (MENU_MAX_DEPTH, menu.h)");
 
 /* ------------------------------ Fin du code -------------------------------- */
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+#include <stdint.h>
+
+// =============================================================================
+//     MODULE ANTI-REBOND DES TOUCHES (COMPTEURS VERTICAUX)
+// =============================================================================
+// Toutes les touches sont traitées en parallèle : un bit par touche dans un
+// mot de 32 bits, et deux mots de compteurs "verticaux" (bit 0 et bit 1 de
+// chaque compteur). Un balayage = une lecture du registre d'entrées GPIO et
+// une quinzaine d'opérations logiques, quel que soit le nombre de touches.
+//
+// Deux modes par touche :
+//  - DEBOUNCE_EAGER    : l'appui est signalé dès le premier front, puis la
+//                        touche est verrouillée pendant DEBOUNCE_SAMPLES
+//                        échantillons (latence minimale).
+//  - DEBOUNCE_DEFERRED : le changement n'est validé qu'après DEBOUNCE_SAMPLES
+//                        échantillons identiques (insensible aux parasites).
+//
+// La partie "moteur" (VerticalDebouncer) ne dépend pas d'Arduino : elle est
+// testée sur PC avec des traces de rebond synthétiques
+// (host/tests/debounce-test.cpp).
+// -----------------------------------------------------------------------------
+
+enum DebounceMode : uint8_t { DEBOUNCE_EAGER, DEBOUNCE_DEFERRED };
+
+const uint8_t DEBOUNCE_SAMPLES = 4;               // Fixé par les compteurs 2 bits
+const unsigned long DEBOUNCE_SAMPLE_US = 1250;    // 4 x 1,25 ms = 5 ms de filtrage
+
+/**
+ * @brief Moteur d'anti-rebond à compteurs verticaux sur 32 lignes.
+ * Les masques sont exprimés dans l'espace de bits de l'échantillon
+ * (1 = touche appuyée).
+ */
+struct VerticalDebouncer {
+  uint32_t activeMask = 0;   // Lignes surveillées
+  uint32_t eagerMask = 0;    // Lignes en mode DEBOUNCE_EAGER
+  uint32_t state = 0;        // État stable (1 = appuyé)
+  uint32_t ct0 = ~0u, ct1 = ~0u;  // Compteurs du mode différé (11 = au repos)
+  uint32_t lk0 = 0, lk1 = 0;      // Verrouillage du mode immédiat (00 = libre)
+  uint32_t lastSample = 0;
+  uint32_t pressed = 0;      // Fronts d'appui en attente de lecture
+  uint32_t released = 0;     // Fronts de relâchement en attente de lecture
+
+  void reset(uint32_t active, uint32_t eager, uint32_t initialSample) {
+    activeMask = active;
+    eagerMask = eager & active;
+    state = lastSample = initialSample & active;
+    ct0 = ct1 = ~0u;
+    lk0 = lk1 = 0;
+    pressed = released = 0;
+  }
+
+  /**
+   * @brief Intègre un échantillon de toutes les lignes.
+   * @param sample Un bit par ligne, 1 = contact fermé.
+   * @return Le masque des lignes ayant rebondi sur cet échantillon.
+   */
+  uint32_t update(uint32_t sample) {
+    const uint32_t s = sample & activeMask;
+    const uint32_t delta = s ^ state;
+    const uint32_t deferredMask = activeMask & ~eagerMask;
+    const uint32_t busy = lk0 | lk1;
+
+    // Un front brut alors que la ligne n'est pas stabilisée = un rebond
+    const uint32_t unsettled = (deferredMask & ~(ct0 & ct1)) | busy;
+    const uint32_t chatter = (s ^ lastSample) & unsettled;
+    lastSample = s;
+
+    // Mode différé : compteur remis à 11 dès que l'échantillon rejoint l'état,
+    // décompté sinon ; le retour à 11 après 4 échantillons bascule l'état.
+    ct0 = ~(ct0 & delta);
+    ct1 = ct0 ^ (ct1 & delta);
+    uint32_t toggle = delta & ct0 & ct1 & deferredMask;
+
+    // Mode immédiat : bascule si la ligne est libre, puis verrouillage 3 -> 0
+    const uint32_t eagerToggle = delta & ~busy & eagerMask;
+    const uint32_t nextLk0 = (~lk0 & busy) | eagerToggle;
+    const uint32_t nextLk1 = ((lk1 ^ ~lk0) & busy) | eagerToggle;
+    lk0 = nextLk0;
+    lk1 = nextLk1;
+    toggle |= eagerToggle;
+
+    state ^= toggle;
+    pressed |= toggle & state;
+    released |= toggle & ~state;
+    return chatter;
+  }
+
+  // Vrai tant qu'une ligne est en cours de validation (compteur ou verrou actif).
+  bool settling() const {
+    return ((lk0 | lk1) | (activeMask & ~eagerMask & ~(ct0 & ct1))) != 0;
+  }
+};
+
+
+#if defined(ARDUINO)
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+
+#ifndef digitalPinToGPIONumber
+  #define digitalPinToGPIONumber(p) (p)
+#endif
+
+// --- Variables propres à ce module ---
+const uint8_t MAX_SCAN_KEYS = 32;
+VerticalDebouncer keyDebouncer;
+uint8_t scanKeyCount = 0;
+uint8_t keyGpioBit[MAX_SCAN_KEYS];     // Touche -> bit du registre GPIO
+int8_t gpioBitToKey[32];               // Bit du registre GPIO -> touche (-1 = aucune)
+uint16_t keyChatterCount[MAX_SCAN_KEYS];
+unsigned long lastKeySampleUs = 0;
+
+// Lit d'un coup l'état des GPIO 0 à 31 (actif bas : 1 = touche appuyée).
+inline uint32_t readKeyPort() {
+  return ~REG_READ(GPIO_IN_REG);
+}
+
+// Convertit un masque exprimé en bits GPIO en masque indexé par touche.
+uint32_t gpioMaskToKeys(uint32_t gpioMask) {
+  uint32_t keys = 0;
+  while (gpioMask) {
+    int8_t key = gpioBitToKey[__builtin_ctz(gpioMask)];
+    if (key >= 0) keys |= (1UL << key);
+    gpioMask &= gpioMask - 1;
+  }
+  return keys;
+}
+
+/**
+ * @brief Configure les broches des touches et initialise l'anti-rebond.
+ * @param pins Broches Arduino des touches (toutes sur les GPIO 0 à 31).
+ * @param modes Mode d'anti-rebond de chaque touche.
+ * @param count Nombre de touches.
+ */
+void keyScanBegin(const uint8_t* pins, const DebounceMode* modes, uint8_t count) {
+  uint32_t active = 0, eager = 0;
+  scanKeyCount = min(count, MAX_SCAN_KEYS);
+  memset(gpioBitToKey, -1, sizeof(gpioBitToKey));
+  for (uint8_t i = 0; i < scanKeyCount; i++) {
+    pinMode(pins[i], INPUT_PULLUP);
+    keyGpioBit[i] = digitalPinToGPIONumber(pins[i]);
+    gpioBitToKey[keyGpioBit[i]] = i;
+    active |= (1UL << keyGpioBit[i]);
+    if (modes[i] == DEBOUNCE_EAGER) eager |= (1UL << keyGpioBit[i]);
+    keyChatterCount[i] = 0;
+  }
+  keyDebouncer.reset(active, eager, readKeyPort());
+  lastKeySampleUs = micros();
+}
+
+/**
+ * @brief Prend un échantillon des touches si la période est écoulée.
+ * À appeler à chaque tour de loop(), quel que soit l'écran actif.
+ */
+void keyScan() {
+  unsigned long now = micros();
+  if (now - lastKeySampleUs < DEBOUNCE_SAMPLE_US) return;
+  lastKeySampleUs = now;
+
+  uint32_t chatter = keyDebouncer.update(readKeyPort());
+  while (chatter) {
+    int8_t key = gpioBitToKey[__builtin_ctz(chatter)];
+    if (key >= 0 && keyChatterCount[key] < UINT16_MAX) keyChatterCount[key]++;
+    chatter &= chatter - 1;
+  }
+}
+
+// Vrai si l'anti-rebond attend encore des échantillons pour valider une touche.
+bool keySettling() {
+  return keyDebouncer.settling();
+}
+
+// Retourne (et consomme) les touches nouvellement appuyées, un bit par touche.
+uint32_t keyTakePresses() {
+  uint32_t gpioMask = keyDebouncer.pressed;
+  keyDebouncer.pressed = 0;
+  return gpioMask ? gpioMaskToKeys(gpioMask) : 0;
+}
+
+// Retourne (et consomme) les touches nouvellement relâchées, un bit par touche.
+uint32_t keyTakeReleases() {
+  uint32_t gpioMask = keyDebouncer.released;
+  keyDebouncer.released = 0;
+  return gpioMask ? gpioMaskToKeys(gpioMask) : 0;
+}
+
+// Retourne l'état stable courant des touches, un bit par touche.
+uint32_t keyPressedMask() {
+  return gpioMaskToKeys(keyDebouncer.state);
+}
+
+#endif // ARDUINO
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -26,8 +26,21 @@ void parseSerialCommand(String cmd) {
   if (cmd.startsWith("help")) {
     Serial.println(F("--- Commandes disponibles ---"));
     Serial.println(F("help          : Affiche cette aide"));
-    Serial.println(F("layer [0-2]   : Change la couche active. Ex: 'layer 1'"));
+    Serial.print(F("layer [0-")); Serial.print(NUM_LAYERS - 1);
+    Serial.println(F("]   : Change la couche active. Ex: 'layer 1'"));
     Serial.println(F("test [1-9]    : Simule un appui sur la touche Kx. Ex: 'test 3'"));
+    Serial.println(F("clavier [nom] : Disposition de l'hote (us, us-intl, uk, fr, de). Ex: 'clavier fr'"));
+    Serial.println(F("frappe [cps]  : Statistiques de frappe de texte, change la vitesse visee. Ex: 'frappe 300'"));
+    Serial.println(F("encodeur      : Compteurs de l'encodeur (transitions invalides, crans perdus)"));
+    Serial.println(F("ecran         : Statistiques d'envoi a l'ecran (octets, durees, images fusionnees)"));
+    Serial.println(F("boucle [raz]  : Cout de loop() et delai touche -> rapport HID par ecran. 'raz' remet a zero"));
+    Serial.println(F("stats [raz]   : Delai entree -> rapport HID par type (p50, p99, max). 'raz' remet a zero"));
+    Serial.println(F("veille [raz]  : Temps passe dans chaque etat d'energie, reveils, consommation estimee"));
+    Serial.println(F("hote          : Canal HID vendeur : volume recu, application et profil actifs"));
+    Serial.println(F("accords       : Accords de la couche active, accords declenches, appuis retenus"));
+    Serial.println(F("bytecode      : Compare le cout d'une macro en bytecode et d'une macro en fonctions C++"));
+    Serial.println(F("icones        : Compare drawBitmap() et drawIcon16() sur 8 icones 16x16"));
+    Serial.println(F("texte         : Compare print(), drawText() et drawStrip() sur un titre de 15 caracteres"));
     Serial.println(F("---------------------------"));
   } else if (cmd.startsWith("layer")) {
     int layerNum = cmd.substring(6).toInt();
@@ -50,27 +63,212 @@ void parseSerialCommand(String cmd) {
     } else {
       Serial.println(F("Erreur: Numero de touche invalide (1-9)."));
     }
-  } else {
-    Serial.println(F("Erreur: Commande inconnue. Tapez 'help'."));
-  }
-}
-
-/**
- * @brief Gère la lecture des commandes sur le port série.
- * Cette fonction doit être appelée à chaque tour de la boucle loop().
- */
-void handleSerialCommands() {
-  static String serialBuffer = "";
-  while (Serial.available() > 0) {
-    char c = Serial.read();
-    if (c == '\n') {
-      if (serialBuffer.length() > 0) {
-        parseSerialCommand(serialBuffer);
+  } else if (cmd.startsWith("clavier")) {
+    String name = cmd.substring(8);
+    name.trim();
+    for (uint8_t i = 0; i < LAYOUT_COUNT; i++) {
+      if (name == KEYBOARD_LAYOUTS[i].name) hostLayout = (KeyboardLayoutId)i;
+    }
+    Serial.print(F("Disposition de l'hote -> "));
+    Serial.println(KEYBOARD_LAYOUTS[hostLayout].name);
+  } else if (cmd.startsWith("frappe")) {
+    int cps = cmd.substring(7).toInt();
+    if (cps > 0) typistTargetCps = cps;
+    Serial.print(F("Vitesse visee (car/s)  : ")); Serial.println(typistTargetCps);
+    Serial.print(F("Caracteres tapes       : ")); Serial.println(typistChars);
+    Serial.print(F("Rapports HID envoyes   : ")); Serial.println(typistReports);
+    if (typistChars > 0) {
+      Serial.print(F("Rapports par caractere : ")); Serial.println((float)typistReports / typistChars, 2);
+    }
+    if (typistBusyUs > 0) {
+      Serial.print(F("Vitesse effective      : ")); Serial.println(typistChars * 1000000.0 / typistBusyUs, 1);
+    }
+  } else if (cmd.startsWith("encodeur")) {
+    Serial.print(F("Position (quarts de cran) : ")); Serial.println(encoderRawPosition);
+    Serial.print(F("Transitions invalides     : ")); Serial.println(encoderInvalidTransitions);
+    Serial.print(F("Crans perdus (file pleine): ")); Serial.println(encoderOverflows);
+    Serial.print(F("Molette haute resolution  : ")); Serial.println(Mouse.wheelHighResolution() ? F("oui (x4)") : F("non (crans entiers)"));
+    Serial.print(F("Defilement H haute resol. : ")); Serial.println(Mouse.panHighResolution() ? F("oui (x4)") : F("non (crans entiers)"));
+  } else if (cmd.startsWith("ecran")) {
+    Serial.print(F("Dernier envoi (octets) : ")); Serial.println(display.lastFlushBytes);
+    Serial.print(F("Nombre d'envois        : ")); Serial.println(display.flushCount);
+    Serial.print(F("Moyenne par envoi      : "));
+    Serial.println(display.flushCount ? display.totalFlushBytes / display.flushCount : 0);
+    Serial.print(F("Duree dernier / max (us): ")); Serial.print(display.lastFlushUs);
+    Serial.print(F(" / ")); Serial.println(display.maxFlushUs);
+    Serial.print(F("Images deposees        : ")); Serial.println(display.framesSubmitted);
+    Serial.print(F("Images fusionnees      : ")); Serial.println(display.framesMerged);
+    Serial.print(F("Images perdues (I2C)   : ")); Serial.println(display.framesDropped);
+  } else if (cmd.startsWith("stats")) {
+    if (cmd.indexOf("raz") > 0) {
+      profileLatencyReset();
+      Serial.println(F("Histogrammes remis a zero."));
+      return;
+    }
+    Serial.println(F("Delai detection -> rapport HID (us)"));
+    Serial.println(F("Type        Nombre    p50     p99     max"));
+    for (uint8_t i = 0; i < LATENCY_CLASS_COUNT; i++) {
+      const LatencyHistogram& h = latencyHistograms[i];
+      char line[64];
+      snprintf(line, sizeof(line), "%-10s %7lu %7lu %7lu %7lu", LATENCY_CLASS_NAMES[i],
+               (unsigned long)h.count, (unsigned long)latencyPercentile(h, 50),
+               (unsigned long)latencyPercentile(h, 99), (unsigned long)h.maxUs);
+      Serial.println(line);
+    }
+  } else if (cmd.startsWith("boucle")) {
+    if (cmd.indexOf("raz") > 0) {
+      profileLoopReset();
+      Serial.println(F("Profils de boucle remis a zero."));
+      return;
+    }
+    for (uint8_t i = 0; i < PROFILE_SLOT_COUNT; i++) {
+      const LoopProfile& p = loopProfiles[i];
+      Serial.print(F("[")); Serial.print(PROFILE_SLOT_NAMES[i]); Serial.println(F("]"));
+      Serial.print(F("  Tours de boucle        : ")); Serial.println(p.iterations);
+      Serial.print(F("  Duree moy / max (us)   : "));
+      Serial.print(p.iterations ? (uint32_t)(p.totalUs / p.iterations) : 0);
+      Serial.print(F(" / ")); Serial.println(p.maxUs);
+      Serial.print(F("  Entrees -> HID         : ")); Serial.println(p.inputs);
+      Serial.print(F("  Delai moy / max (us)   : "));
+      Serial.print(p.inputs ? (uint32_t)(p.latencyTotalUs / p.inputs) : 0);
+      Serial.print(F(" / ")); Serial.println(p.latencyMaxUs);
+    }
+  } else if (cmd.startsWith("veille")) {
+    if (cmd.indexOf("raz") > 0) {
+      powerStats.reset();
+      powerStats.enter(powerState);
+      powerStateSince = millis();
+      powerWakes = 0;
+      Serial.println(F("Mesures remises a zero."));
+      return;
+    }
+    Serial.print(F("Etat actuel            : ")); Serial.println(POWER_STATE_NAMES[powerState]);
+    Serial.print(F("Bus USB suspendu       : ")); Serial.println(powerUsbSuspended ? F("oui") : F("non"));
+    Serial.println(F("Etat          Entrees   Temps (s)   mA estim."));
+    for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) {
+      uint32_t ms = powerStats.ms[i] + ((i == powerState) ? millis() - powerStateSince : 0);
+      char line[64];
+      snprintf(line, sizeof(line), "%-12s %8lu %11lu %9u", POWER_STATE_NAMES[i],
+               (unsigned long)powerStats.entries[i], (unsigned long)(ms / 1000), POWER_STATE_MA[i]);
+      Serial.println(line);
+    }
+    Serial.print(F("Reveils par un front   : ")); Serial.println(powerWakes);
+    Serial.print(F("Conso. moyenne estimee : ")); Serial.print(powerAverageMa(), 1); Serial.println(F(" mA (valeurs supposees, non mesurees : POWER_STATE_MA)"));
+    const LatencyHistogram& h = latencyHistograms[LATENCY_WAKE];
+    Serial.print(F("Reveil -> HID p50/p99/max (us): "));
+    Serial.print(latencyPercentile(h, 50)); Serial.print(F(" / "));
+    Serial.print(latencyPercentile(h, 99)); Serial.print(F(" / ")); Serial.println(h.maxUs);
+  } else if (cmd.startsWith("hote")) {
+    Serial.print(F("Rapports recus         : ")); Serial.print(hostReports);
+    Serial.print(F(" (perdus : ")); Serial.print(HostLink.overflows); Serial.println(F(")"));
+    Serial.print(F("Volume                 : ")); Serial.print(currentVol);
+    Serial.println(hostVolumeKnown ? F(" % (ordinateur)") : F(" % (estime)"));
+    Serial.print(F("Application            : ")); Serial.println(hostAppName[0] ? hostAppName : "(aucune)");
+    Serial.print(F("Profil d'application   : "));
+    if (hostAppProfile == HOST_NO_PROFILE) Serial.println(F("aucun (choix manuel)"));
+    else Serial.println(APP_PROFILES[hostAppProfile].match);
+  } else if (cmd.startsWith("accords")) {
+    Serial.print(F("Fenetre (ms)           : ")); Serial.println(COMBO_WINDOW_MS);
+    Serial.print(F("Index (octets, Flash)  : ")); Serial.println(sizeof(COMBO_INDEX));
+    for (uint16_t mask = 0; mask < COMBO_MASKS; mask++) {
+      uint8_t chord = comboLookup(currentLayer, mask) & COMBO_NONE;
+      if (chord >= NUM_COMBOS) continue; // COMBO_NONE
+      Serial.print(F("  "));
+      for (uint8_t k = 0; k < NUM_KEYS; k++) {
+        if (mask & (1u << k)) { Serial.print(F("K")); Serial.print(k + 1); Serial.print(F(" ")); }
+      }
+      Serial.print(F("-> "));
+      Serial.println(COMBOS[chord].action.label ? COMBOS[chord].action.label : "(sans texte)");
+    }
+    Serial.print(F("Accords declenches     : ")); Serial.println(comboChords);
+    Serial.print(F("Appuis retenus         : ")); Serial.print(comboHeld);
+    Serial.print(F(" (rendus a leur macro : ")); Serial.print(comboReleased); Serial.println(F(")"));
+  } else if (cmd.startsWith("bytecode")) {
+    // La même macro (Ctrl+C, comme sendCombo_Ctrl) sous ses deux formes. Les
+    // deux chemins produisent les mêmes 5 étapes, jouées ensuite par le même
+    // code (macroRunStep) : on ne mesure que ce qui diffère, sans rien envoyer.
+    // La comparaison complète (appui et jeu, action C++ de la table KEYMAP
+    // contre programme) est host/bench/macro-vm-bench.cpp.
+    static const char CTRL_C[] = "\x04\x01\x01" "c\x09\x28\x02" "c\x04\x00"; // MODS ctrl, DOWN c, WAIT 40, UP c, MODS 0
+    const uint16_t RUNS = 1000;
+    if (!macroIdle(MACRO_TRACK_MENU)) { Serial.println(F("Une macro joue encore, reessayez.")); return; }
+    MacroTrack& t = macroTracks[MACRO_TRACK_MENU];
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < RUNS; i++) {
+      sendCombo_Ctrl('c', MACRO_TRACK_MENU); // 5 étapes mises en file...
+      t.head = t.tail;                       // ... puis retirées sans être jouées
+    }
+    uint32_t queueUs = micros() - start;
+    volatile uint8_t sink = 0;
+    start = micros();
+    for (uint16_t i = 0; i < RUNS; i++) {
+      MacroStep op;
+      uint8_t pc = 0, size;
+      while ((size = macroVmDecode((const uint8_t*)CTRL_C, pc, op)) != 0) { pc += size; sink = sink + op.type; }
+    }
+    uint32_t vmUs = micros() - start;
+    Serial.println(F("Macro Ctrl+C (5 etapes), moyenne sur 1000"));
+    Serial.print(F("Fonctions C++ : ")); Serial.print(queueUs / (float)RUNS, 2);
+    Serial.print(F(" us, ")); Serial.print(5 * sizeof(MacroStep)); Serial.println(F(" octets de file"));
+    Serial.print(F("Bytecode      : ")); Serial.print(vmUs / (float)RUNS, 2);
+    Serial.print(F(" us, ")); Serial.print(sizeof(CTRL_C)); Serial.println(F(" octets de programme"));
+  } else if (cmd.startsWith("icones")) {
+    // Une rangée de 8 icônes dessinée 100 fois de chaque façon, à y aligné (16) puis
+    // décalé (13), dans le framebuffer seulement : l'écran n'est pas touché.
+    const uint16_t RUNS = 100;
+    uint8_t saved[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+    memcpy(saved, display.getBuffer(), sizeof(saved));
+    Serial.println(F("8 icones 16x16, moyenne sur 100 (us)"));
+    Serial.println(F("y       drawBitmap  drawIcon16"));
+    const int16_t ys[] = { 16, 13 };
+    for (uint8_t k = 0; k < 2; k++) {
+      uint32_t start = micros();
+      for (uint16_t r = 0; r < RUNS; r++) {
+        for (uint8_t i = 0; i < 8; i++) display.drawBitmap(i * 16, ys[k], ICON_PAGES[i].bitmap, 16, 16, SSD1306_WHITE);
+      }
+      uint32_t gfxUs = micros() - start;
+      start = micros();
+      for (uint16_t r = 0; r < RUNS; r++) {
+        for (uint8_t i = 0; i < 8; i++) display.drawIcon16(i * 16, ys[k], ICON_PAGES[i].bitmap, SSD1306_WHITE);
+      }
+      uint32_t blitUs = micros() - start;
+      char line[48];
+      snprintf(line, sizeof(line), "%-7d %10.1f %11.1f", ys[k], gfxUs / (float)RUNS, blitUs / (float)RUNS);
+      Serial.println(line);
+    }
+    memcpy(display.getBuffer(), saved, sizeof(saved));
+  } else if (cmd.startsWith("texte")) {
+    // Le même titre dessiné 100 fois de chaque façon, à y aligné (8) puis
+    // décalé (10), dans le framebuffer seulement : l'écran n'est pas touché.
+    const uint16_t RUNS = 100;
+    static constexpr auto TITLE = textStrip("Mode: Undo/Redo");
+    uint8_t saved[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+    memcpy(saved, display.getBuffer(), sizeof(saved));
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    Serial.println(F("\"Mode: Undo/Redo\", moyenne sur 100 (us)"));
+    Serial.println(F("y       print()  drawText  drawStrip"));
+    const int16_t ys[] = { 8, 10 };
+    for (uint8_t k = 0; k < 2; k++) {
+      uint32_t start = micros();
+      for (uint16_t r = 0; r < RUNS; r++) {
+        display.setCursor(0, ys[k]);
+        display.print(F("Mode: Undo/Redo"));
       }
-      serialBuffer = "";
-    } else if (c >= 32) {
-      serialBuffer += c;
+      uint32_t gfxUs = micros() - start;
+      start = micros();
+      for (uint16_t r = 0; r < RUNS; r++) display.drawText(0, ys[k], "Mode: Undo/Redo");
+      uint32_t textUs = micros() - start;
+      start = micros();
+      for (uint16_t r = 0; r < RUNS; r++) display.drawStrip(0, ys[k], TITLE);
+      uint32_t stripUs = micros() - start;
+      char line[48];
+      snprintf(line, sizeof(line), "%-7d %7.1f %9.1f %10.1f", ys[k], gfxUs / (float)RUNS, textUs / (float)RUNS, stripUs / (float)RUNS);
+      Serial.println(line);
     }
+    memcpy(display.getBuffer(), saved, sizeof(saved));
+  } else {
+    Serial.println(F("Erreur: Commande inconnue. Tapez 'help'."));
   }
 }
 
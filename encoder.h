@@ -0,0 +1,129 @@
+#pragma once
+#include <stdint.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+
+// =============================================================================
+//     MODULE DE L'ENCODEUR ROTATIF (INTERRUPTIONS)
+// =============================================================================
+// Le décodage en quadrature de ENC_A/ENC_B se fait dans une interruption sur
+// changement d'état des deux broches : aucun pas n'est perdu quand loop() est
+// occupée (rafraîchissement de l'écran, macros, etc.).
+// Chaque cran complet (STEPS_PER_DETENT transitions) est déposé dans une file
+// circulaire sans verrou : un seul producteur (l'interruption) et un seul
+// consommateur (loop()).
+// -----------------------------------------------------------------------------
+
+// Table de transition Gray : index = (ancien AB << 2) | nouvel AB.
+// Les zéros hors diagonale sont des transitions impossibles (pas manqué).
+DRAM_ATTR const int8_t transTable[16] = { 0, -1, +1, 0, +1, 0, 0, -1, -1, 0, 0, +1, 0, +1, -1, 0 };
+const uint8_t STEPS_PER_DETENT = 4;
+
+// Un cran de l'encodeur, horodaté au moment où l'interruption l'a détecté.
+struct EncoderStep {
+  int8_t delta;     // +1 ou -1
+  uint32_t timeUs;  // micros() au moment du cran
+};
+
+const uint8_t ENCODER_QUEUE_SIZE = 32; // Puissance de 2 obligatoire
+static_assert((ENCODER_QUEUE_SIZE & (ENCODER_QUEUE_SIZE - 1)) == 0, "ENCODER_QUEUE_SIZE doit etre une puissance de 2");
+
+// --- Variables propres à ce module ---
+EncoderStep encoderQueue[ENCODER_QUEUE_SIZE];
+volatile uint32_t encoderHead = 0;  // Écrit uniquement par l'interruption
+volatile uint32_t encoderTail = 0;  // Écrit uniquement par loop()
+volatile uint32_t encoderInvalidTransitions = 0; // Transitions Gray impossibles
+volatile uint32_t encoderOverflows = 0;          // Crans perdus, file pleine
+volatile int32_t encoderRawPosition = 0;         // Position en quarts de cran
+uint8_t encoderBitA = 0, encoderBitB = 0;        // Bits GPIO de ENC_A / ENC_B
+uint8_t encoderLastAB = 0;
+int8_t encoderAccum = 0;
+void (*encoderEdgeHook)() = nullptr;             // Appelé à chaque front (réveil, power.h) ; doit être en IRAM
+
+// Lit l'état des deux phases (A en bit 1, B en bit 0).
+inline uint8_t IRAM_ATTR encoderReadAB() {
+  uint32_t in = REG_READ(GPIO_IN_REG);
+  return (((in >> encoderBitA) & 1) << 1) | ((in >> encoderBitB) & 1);
+}
+
+// Interruption sur changement de ENC_A ou ENC_B.
+void IRAM_ATTR encoderISR() {
+  if (encoderEdgeHook != nullptr) encoderEdgeHook();
+  uint8_t nowAB = encoderReadAB();
+  if (nowAB == encoderLastAB) return;
+
+  int8_t dir = transTable[(encoderLastAB << 2) | nowAB];
+  encoderLastAB = nowAB;
+  if (dir == 0) {
+    encoderInvalidTransitions = encoderInvalidTransitions + 1;
+    return;
+  }
+
+  encoderRawPosition = encoderRawPosition + dir;
+  encoderAccum += dir;
+  if (encoderAccum >= STEPS_PER_DETENT || encoderAccum <= -STEPS_PER_DETENT) {
+    uint32_t head = encoderHead;
+    if (head - __atomic_load_n(&encoderTail, __ATOMIC_ACQUIRE) < ENCODER_QUEUE_SIZE) {
+      encoderQueue[head & (ENCODER_QUEUE_SIZE - 1)].delta = (encoderAccum > 0) ? 1 : -1;
+      encoderQueue[head & (ENCODER_QUEUE_SIZE - 1)].timeUs = micros();
+      __atomic_store_n(&encoderHead, head + 1, __ATOMIC_RELEASE);
+    } else {
+      encoderOverflows = encoderOverflows + 1;
+    }
+    encoderAccum = 0;
+  }
+}
+
+/**
+ * @brief Configure les broches de l'encodeur et attache les interruptions.
+ * @param pinA Broche Arduino de la phase A.
+ * @param pinB Broche Arduino de la phase B.
+ */
+void encoderBegin(uint8_t pinA, uint8_t pinB) {
+  pinMode(pinA, INPUT_PULLUP);
+  pinMode(pinB, INPUT_PULLUP);
+  encoderBitA = digitalPinToGPIONumber(pinA);
+  encoderBitB = digitalPinToGPIONumber(pinB);
+  encoderLastAB = encoderReadAB();
+  attachInterrupt(digitalPinToInterrupt(pinA), encoderISR, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(pinB), encoderISR, CHANGE);
+}
+
+/**
+ * @brief Retire le plus ancien cran de la file.
+ * @param step Reçoit le cran retiré.
+ * @return false si la file est vide.
+ */
+bool encoderPop(EncoderStep& step) {
+  uint32_t tail = encoderTail;
+  if (tail == __atomic_load_n(&encoderHead, __ATOMIC_ACQUIRE)) return false;
+  step = encoderQueue[tail & (ENCODER_QUEUE_SIZE - 1)];
+  __atomic_store_n(&encoderTail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+// --- Accélération (volume, défilement) ---
+// Plus deux crans successifs sont rapprochés, plus chacun compte : sous
+// fasterThanMs[i] millisecondes, un cran vaut multiplier[i] pas. Les seuils
+// sont rangés du plus court au plus long ; au-delà du dernier, un cran = 1 pas.
+const uint8_t ENCODER_ACCEL_LEVELS = 3;
+
+struct EncoderAccel {
+  uint16_t fasterThanMs[ENCODER_ACCEL_LEVELS];
+  uint8_t multiplier[ENCODER_ACCEL_LEVELS];
+};
+
+/**
+ * @brief Donne le nombre de pas que vaut un cran selon sa vitesse.
+ * @param curve La courbe d'accélération du mode actif.
+ * @param intervalMs Temps écoulé depuis le cran précédent (même sens).
+ * @return Le multiplicateur (1 pour une rotation lente).
+ */
+uint8_t encoderAccelMultiplier(const EncoderAccel& curve, uint32_t intervalMs) {
+  for (uint8_t i = 0; i < ENCODER_ACCEL_LEVELS; i++) {
+    if (intervalMs < curve.fasterThanMs[i]) return max((uint8_t)1, curve.multiplier[i]);
+  }
+  return 1;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -16,16 +16,16 @@
  * - 1x Écran OLED I2C 0.91" (128x32, driver SSD1306)
  * * 👉 Comment personnaliser ?
  * - La configuration des broches (pins) se trouve dans la section "PINS".
- * - Les actions des touches se personnalisent dans la fonction "fireMacro()".
+ * - Les actions des touches se personnalisent dans la table "KEYMAP" de config.h.
  */
  
 #include "USB.h"
-#include "USBHIDMouse.h"
+#include "hires-mouse.h"  // Souris avec molette haute résolution
 #include "USBHIDKeyboard.h"
 #include <USBHIDConsumerControl.h>
 
 // On crée les objets pour chaque périphérique USB
-USBHIDMouse Mouse;
+HiResMouse Mouse;
 USBHIDKeyboard Keyboard;
 USBHIDConsumerControl Consumer;
 
@@ -33,27 +33,21 @@ USBHIDConsumerControl Consumer;
 #include <Wire.h> 
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include "oled-buffer.h"
 #include "icondata.h" 
+#include "asset-draw.h" // Images compressées (écran de démarrage, économiseur d'écran)
+#include "screensaver.h" // Économiseur d'écran animé, sans delay()
 #include "key-shortcut.h"
-
-/* ---------------- Conversion FR → EN pour Win+R ---------------- */
-String fr2en(String text){
-  int i = 0;
-  String _en = " =qwertyuiopasdfghjkl;zxcvbnQWERTYUIOPASDFGHJKL:ZXCVBNm,./M<>?1234567890!@#$%^&*()",
-         _fr = " =azertyuiopqsdfghjklmwxcvbnAZERTYUIOPQSDFGHJKLMWXCVBN,;:!?./ & \"'(- _  1234567890",
-         str = "";
-  while (text[i] != 0){
-    str = str + (String)_en[_fr.indexOf((String)text[i++])];
-  }
-  return str;
-}
+#include "debounce.h"
+#include "encoder.h"
+#include "input-events.h" // Entrées lues une fois par tour, distribuées en événements
 
 /* ---------------------------------------------- */
 /* -------------------- OLED -------------------- */
 /* ---------------------------------------------- */
 const int SCREEN_WIDTH = 128;  // Largeur de l'écran OLED, en pixels
 const int SCREEN_HEIGHT = 32;  // Hauteur de l'écran OLED, en pixels
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+FramebufferSSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1); // N'envoie que les zones modifiées
 const uint8_t OLED_ADDR = 0x3C;  // Adresse I2C (souvent 0x3C ou 0x3D)
 
 
@@ -70,6 +64,13 @@ const uint8_t ENC_SW = A2;  // Bouton de l'encodeur
 // la touche dédiée (K9) est pressée, on change de couche.
 const uint8_t KEY_PINS[] = { D2, D3, D4, D5, D6, D7, D8, D9, D10 };
 const uint8_t NUM_KEYS = sizeof(KEY_PINS) / sizeof(KEY_PINS[0]);
+// Mode d'anti-rebond de chaque touche (voir debounce.h) :
+// DEBOUNCE_EAGER = réaction immédiate, DEBOUNCE_DEFERRED = validation après 5 ms.
+const DebounceMode KEY_DEBOUNCE_MODES[] = {
+  DEBOUNCE_EAGER, DEBOUNCE_EAGER, DEBOUNCE_EAGER,
+  DEBOUNCE_EAGER, DEBOUNCE_EAGER, DEBOUNCE_EAGER,
+  DEBOUNCE_EAGER, DEBOUNCE_EAGER, DEBOUNCE_EAGER
+};
 
 
 /* ---------------------------------------------------- */
@@ -77,19 +78,19 @@ const uint8_t NUM_KEYS = sizeof(KEY_PINS) / sizeof(KEY_PINS[0]);
 /* ---------------------------------------------------- */
 // Identifiants symboliques pour les touches
 enum KeyIds { K1, K2, K3, K4, K5, K6, K7, K8, K9 };
-bool lastKeyState[NUM_KEYS]; // Tableau pour l'anti-rebond des touches
 
 // Variables pour la gestion des couches (layers)
-const uint8_t NUM_LAYERS = 3; // Nombre total de couches (0, 1, 2)
+// Le nombre de couches (NUM_LAYERS) découle de la table KEYMAP de config.h.
 uint8_t currentLayer = 0;     // Couche actuellement active
 
-// Variables pour l'encodeur
-int8_t transTable[16] = { 0, -1, +1, 0, +1, 0, 0, -1, -1, 0, 0, +1, 0, +1, -1, 0 };
-uint8_t lastAB = 0;
-int8_t accum = 0;
-const uint8_t STEPS_PER_DETENT = 4;
-unsigned long lastStepMs = 0, lastClickMs = 0;
-const unsigned long STEP_COOLDOWN_MS = 2, CLICK_DEBOUNCE_MS = 200;
+// Variables pour l'encodeur (le décodage lui-même est dans encoder.h)
+unsigned long lastStepMs = 0;
+const unsigned long STEP_COOLDOWN_MS = 2;
+int8_t lastStepDir = 0;                // Sens du dernier cran (pour l'accélération)
+int16_t pendingScrollUnits = 0;        // Pas ajoutés par l'accélération, envoyés avec le prochain EV_ROTATE
+bool scrollDetentPending = false;      // Un cran attend son rapport de défilement
+uint32_t scrollDetentUs = 0;           // Date de ce cran (profilage)
+const int16_t VOLUME_MAX_STEPS = 50;   // 50 pas de 2 % = toute la plage de volume
 
 // Variables pour la mise en veille de l'OLED
 unsigned long lastActionTime = 0;
@@ -101,82 +102,77 @@ int currentVol = 50;
 bool muted = false;
 
 // Variables pour les modes de l'encodeur
-enum EncoderMode { MODE_VOLUME, MODE_SCROLL, MODE_UNDO_REDO };
+enum EncoderMode { MODE_VOLUME, MODE_SCROLL, MODE_HSCROLL, MODE_UNDO_REDO };
+const uint8_t NUM_ENCODER_MODES = MODE_UNDO_REDO + 1;
 EncoderMode currentEncoderMode = MODE_VOLUME;
-unsigned long buttonPressStartTime = 0;
-const unsigned long LONG_PRESS_DURATION = 500; // 500 ms pour un appui long
 
 // --- Variables pour le menu de configuration ---
-bool isInMenu = false;
-const char* menuItems[] = { "Luminosite", "Menu Principal", "Sortir" };
-const uint8_t NUM_MENU_ITEMS = sizeof(menuItems) / sizeof(menuItems[0]);
-int8_t selectedMenuItem = 0;
+bool isInMenu = false;        // Menu ouvert (l'arbre CONFIG_MENU est dans config.h, le moteur dans menu.h)
 uint8_t oledBrightness = 255; // 255 = max, 0 = min
-const unsigned long VERY_LONG_PRESS_DURATION = 1500; // 1.5s pour entrer dans le menu
-bool blockMenuClickUntilRelease = false; // Sécurité pour éviter le clic instantané
 
 // --- Variables pour le screensaver configuration ---
 const unsigned long SCREENSAVER_DELAY = SLEEP_DELAY - 15000; // Se lance 15s avant la veille
-bool isScreensaverActive = false;
-int8_t iconX = 0, iconY = 0;   // Position de l'icône
-int8_t iconDX = 1, iconDY = 1;  // Direction de l'icône (vitesse)
-// Tableau contenant les 4 frames de l'animation de rotation
-const unsigned char* screensaverFrames[] = { // Tableau contenant les 4 frames de l'animation de rotation
-  icon_screensaver_0_16x16,
-  icon_screensaver_90_16x16,
-  icon_screensaver_180_16x16,
-  icon_screensaver_270_16x16
-};
-uint8_t currentFrame = 0; // Pour suivre l'image actuelle de l'animation
 
 // --- Variables pour le menu d'icônes ---
 enum ProgramState { STATE_ICON_MENU, STATE_NORMAL };
 ProgramState currentState = STATE_ICON_MENU;
 
+// --- Écran différé (remplace les delay() avant un changement d'écran) ---
+void (*deferredScreen)() = nullptr;
+unsigned long deferredScreenAt = 0;
+
 
 /* ---------------------------------------------------------- */
 /* ---------------- PROTOTYPES DES FONCTIONS ---------------- */
 /* ---------------------------------------------------------- */
 void showMessage(const char* msg);
 void showVolume();
+void drawVolume();
+void refreshVolumeScreen();
 void wakeUp();
-void drawMenu();
 void setBrightness(uint8_t brightness);
+void setMute(uint8_t on);
+const uint8_t SELECT_NEXT = 0xFF; // Pour selectLayer() / selectEncoderMode() : la couche ou le mode suivant
+void selectLayer(uint8_t layer);
+void selectEncoderMode(uint8_t mode);
 void fireMacro(uint8_t id);
-void handleSerialCommands();
 void drawIconMenu();
-void drawScreensaver();
-String fr2en(String text);
+void scheduleScreen(void (*screen)(), unsigned long delayMs);
 void returnToIconMenu();
-void handleIconMenu();
-void handleNormalMode();
-
-#include "debug.h"  // Dépend des fonctions du fichier principal (qui seront déclarées juste après)
+void dispatchInput(const InputEvent& e);
+void iconMenuEvent(const InputEvent& e);
+void normalModeEvent(const InputEvent& e);
+int16_t accelerateStep(const EncoderStep& step);
+
+#include "macro-vm.h"   // Macros en bytecode (jouées par l'exécuteur de macros, dépend de SELECT_NEXT)
+#include "keymap.h" // Types et actions de la table des touches
+#include "menu.h"   // Moteur des menus : arbre constexpr, lignes dessinées une fois
+#include "host-link.h" // Canal HID vendeur : volume réel et profil par application
 #include "config.h" // Dépend des fonctions et variables du fichier principal
+#include "combo.h"  // Accords : plusieurs touches pressées ensemble (dépend de config.h)
+#include "power.h"  // Veille : somnolence / light sleep, réveil par les touches et l'encodeur
+#include "debug.h"  // Dépend des fonctions du fichier principal et de NUM_LAYERS (config.h)
 #include "iconmenu.h"
+#include "settings.h" // Dépend des variables du fichier principal et de iconmenu.h
+#include "keymap-store.h" // Touches redéfinies depuis l'ordinateur (dépend de config.h)
+#include "protocol.h"     // Port série : commandes texte (debug.h) et trames binaires
 
 /* =============================================== */
 /* ==================== SETUP ==================== */
 /* =============================================== */
 void setup() {
-  // Initialisation de la communication Série en premier pour le débogage
+  // Initialisation de la communication Série (protocole de configuration et débogage)
+  Serial.begin(115200);
   #if defined(DEBUG_MODE_ENABLED)
-    Serial.begin(115200);
     // Attente de la connexion du port série
     //while (!Serial);  // <-- "On commente //" "ou supprime" cette ligne pour un démarrage autonome
   #endif
 
-  // Initialisation des broches des touches
-  for (uint8_t i = 0; i < NUM_KEYS; i++) {
-    pinMode(KEY_PINS[i], INPUT_PULLUP);
-    lastKeyState[i] = digitalRead(KEY_PINS[i]);
-  }
+  // Initialisation des broches de l'encodeur (décodage sous interruption)
+  encoderBegin(ENC_A, ENC_B);
 
-  // Initialisation des broches de l'encodeur
-  pinMode(ENC_A, INPUT_PULLUP);
-  pinMode(ENC_B, INPUT_PULLUP);
-  pinMode(ENC_SW, INPUT_PULLUP);
-  lastAB = (digitalRead(ENC_A) << 1) | digitalRead(ENC_B);
+  // Initialisation des touches et du bouton de l'encodeur (un seul anti-rebond)
+  inputBegin(KEY_PINS, KEY_DEBOUNCE_MODES, NUM_KEYS, ENC_SW);
 
   // Initialisation de l'I2C
   //Wire.begin(A4 /*SDA*/, A5 /*SCL*/);
@@ -191,27 +187,34 @@ void setup() {
     #endif
     for (;;);
   }
+  // Les envois vers l'écran se font désormais en arrière-plan sur l'autre cœur
+  display.startFlushTask();
 
   // Initialisation du bus USB
   Keyboard.begin();
   Mouse.begin();
   Consumer.begin();
+  HostLink.begin();
 
   // Écran de démarrage
   display.clearDisplay();
-  display.drawBitmap(0, 0, bootscreen_128x32, 128, 32, SSD1306_WHITE);
+  drawAsset(ASSET_BOOTSCREEN, 0, 0, SSD1306_WHITE);
   display.display();
   delay(2000);
 
-  // On applique la luminosité par défaut
+  // Les touches redéfinies sont lues directement dans la partition "keymap"
+  keymapStoreBegin();
+
+  // On restaure les réglages sauvegardés (luminosité, couche, mode...) en une lecture
+  settingsBegin();
+  selectedIconIndex = activeProfile;
   setBrightness(oledBrightness);
   display.setTextSize(1);
   lastActionTime = millis();
 
-  // --- On active le profil par défaut ---
-  currentLayer = 0;
-  currentEncoderMode = MODE_VOLUME;
-  
+  // Sources de réveil de la veille : touches, bouton et phases de l'encodeur
+  powerBegin(KEY_PINS, NUM_KEYS, ENC_SW, ENC_A, ENC_B);
+
   // Affichage du menu d'icônes initial
   drawIconMenu();
 }
@@ -222,37 +225,47 @@ void setup() {
 /* ================================================================== */
 
 void loop() {
-  // Le gestionnaire de commandes série est toujours actif
-  #if defined(DEBUG_MODE_ENABLED)
-    handleSerialCommands();
-  #endif
+  // Mesure du tour de boucle, rangée selon l'écran actif (profiler.h)
+  profileLoopBegin(currentState == STATE_ICON_MENU ? PROFILE_ICON_MENU : (isInMenu ? PROFILE_CONFIG_MENU : PROFILE_NORMAL));
 
-  // Le "chef d'orchestre" : appelle la bonne fonction selon l'état
-  switch (currentState) {
-    case STATE_ICON_MENU:
-      handleIconMenu();
-      break;
-    case STATE_NORMAL:
-      handleNormalMode();
-      break;
-  }
+  // Une table des touches fraîchement écrite en Flash prend effet entre deux tours
+  keymapStoreTick();
 
-  // La gestion de l'inactivité est toujours active
-  unsigned long idleTime = millis() - lastActionTime;
-  if (isSleeping) {
-    // Ne rien faire
-  } else if (idleTime > SLEEP_DELAY) {
-    display.ssd1306_command(SSD1306_DISPLAYOFF);
-    isSleeping = true;
-    isScreensaverActive = false;
-  } else if (idleTime > SCREENSAVER_DELAY) {
-    if (!isScreensaverActive) {
-      isScreensaverActive = true;
-      iconX = 0; iconY = 0;
-      iconDX = 1; iconDY = 1;
-    }
-    drawScreensaver();
+  // Le port série est toujours lu : trames de configuration et commandes de debug
+  protocolPoll();
+
+  // État poussé par l'ordinateur : vrai volume, application au premier plan
+  hostLinkPoll(APP_PROFILES);
+
+  // Les entrées sont lues une seule fois par tour, quel que soit l'écran actif
+  inputScan();
+
+  // Les macros en cours avancent d'un pas, sans jamais bloquer la boucle
+  macroTick();
+
+  // Les réglages modifiés sont écrits en Flash après un moment de calme
+  settingsTick();
+
+  // Changement d'écran programmé (ex: retour au menu d'icônes après 2 s)
+  if (deferredScreen != nullptr && (long)(millis() - deferredScreenAt) >= 0) {
+    void (*screen)() = deferredScreen;
+    deferredScreen = nullptr;
+    screen();
   }
+
+  // Le "chef d'orchestre" : chaque événement va à l'écran actif
+  InputEvent event;
+  while (inputPop(event)) dispatchInput(event);
+
+  // Un accord commencé mais pas terminé rend ses touches à leurs macros
+  comboTick(micros());
+
+  profileLoopEnd();
+
+  // La gestion de l'inactivité est toujours active : économiseur d'écran,
+  // écran éteint, puis veille jusqu'au prochain front (power.h). Placée
+  // après la mesure : le temps passé à dormir n'est pas un coût de loop().
+  powerTick();
 }
 
 /* ================================================================== */
@@ -260,201 +273,218 @@ void loop() {
 /* ================================================================== */
 
 /**
- * @brief Gère la logique du mode de fonctionnement normal.
- * Appelée à chaque tour de boucle lorsque currentState == STATE_NORMAL.
+ * @brief Distribue un événement d'entrée à l'écran actif.
+ * @param e L'événement retiré de la file (input-events.h).
  */
-void handleNormalMode() {
-  if (isInMenu) {
-    // --- GESTION DU MENU DE CONFIGURATION ---
-    uint8_t nowAB = (digitalRead(ENC_A) << 1) | digitalRead(ENC_B);
-    if (nowAB != lastAB) {
-      int8_t dir = transTable[(lastAB << 2) | nowAB];
-      if (dir != 0) {
-        accum += dir;
-        if (accum >= STEPS_PER_DETENT) { selectedMenuItem = (selectedMenuItem + 1) % NUM_MENU_ITEMS; accum = 0; } 
-        else if (accum <= -STEPS_PER_DETENT) { selectedMenuItem = (selectedMenuItem - 1 + NUM_MENU_ITEMS) % NUM_MENU_ITEMS; accum = 0; }
-        drawMenu();
-      }
-      lastAB = nowAB;
-    }
+void dispatchInput(const InputEvent& e) {
+  if (currentState == STATE_ICON_MENU) iconMenuEvent(e);
+  else if (isInMenu) menuEvent(e);
+  else normalModeEvent(e);
+}
 
-    if (digitalRead(ENC_SW) == HIGH) { blockMenuClickUntilRelease = false; }
-
-    if (!blockMenuClickUntilRelease && digitalRead(ENC_SW) == LOW && (millis() - lastClickMs > CLICK_DEBOUNCE_MS)) {
-      lastClickMs = millis();
-      switch (selectedMenuItem) {
-        case 0: // Option "Luminosite"
-          showMessage("Tournez pour regler");
-          while (digitalRead(ENC_SW) == LOW) { delay(10); }
-          while (digitalRead(ENC_SW) == HIGH) {
-            nowAB = (digitalRead(ENC_A) << 1) | digitalRead(ENC_B);
-            if (nowAB != lastAB) {
-              int8_t dir = transTable[(lastAB << 2) | nowAB];
-              if (dir != 0) {
-                accum += dir;
-                if (accum >= STEPS_PER_DETENT || accum <= -STEPS_PER_DETENT) {
-                  int8_t direction = (accum > 0) ? 1 : -1;
-                  setBrightness(max(0, min(255, oledBrightness + (15 * direction))));
-                  display.clearDisplay(); display.setCursor(0, 8);
-                  display.print("Luminosite: "); display.print(oledBrightness);
-                  display.display();
-                  accum = 0;
-                }
-              }
-              lastAB = nowAB;
-            }
-          }
-          while (digitalRead(ENC_SW) == LOW) { delay(10); }
-          drawMenu();
-          break;
-        case 1: // Option "Menu Principal"
-          returnToIconMenu();
-          break;
-        case 2: // Option "Sortir"
-          isInMenu = false;
-          showVolume();
-          break;
-      }
-    }
-  } else {
-    // --- MODE DE FONCTIONNEMENT HORS-MENU ---
-    for (uint8_t i = 0; i < NUM_KEYS; i++) {
-      bool pressed = (digitalRead(KEY_PINS[i]) == LOW);
-      if (pressed && !lastKeyState[i]) { wakeUp(); fireMacro(i); }
-      lastKeyState[i] = pressed;
-    }
+/**
+ * @brief Mode de fonctionnement normal : macros des touches et encodeur
+ * selon son mode (volume, défilement, annuler/rétablir).
+ */
+void normalModeEvent(const InputEvent& e) {
+  switch (e.type) {
+    case EV_KEY_DOWN: // Macro de la touche, ou retenue le temps de reconnaître un accord
+      comboKeyDown(e.value, e.timeUs);
+      break;
 
-    uint8_t nowAB = (digitalRead(ENC_A) << 1) | digitalRead(ENC_B);
-    if (nowAB != lastAB) {
-      int8_t dir = transTable[(lastAB << 2) | nowAB];
-      if (dir != 0) {
-        accum += dir;
-        if (accum >= STEPS_PER_DETENT || accum <= -STEPS_PER_DETENT) {
-          wakeUp();
-          int8_t direction = (accum > 0) ? 1 : -1;
-          switch (currentEncoderMode) {
-            case MODE_VOLUME:
-              if (direction > 0) Consumer.press(HID_USAGE_CONSUMER_VOLUME_INCREMENT);
-              else Consumer.press(HID_USAGE_CONSUMER_VOLUME_DECREMENT);
-              Consumer.release();
-              currentVol = max(0, min(100, currentVol + (2 * direction)));
-              break;
-            case MODE_SCROLL: Mouse.move(0, 0, direction); break;
-            case MODE_UNDO_REDO: if (direction > 0) sendCombo_Ctrl('y'); else sendCombo_Ctrl('z'); break;
-          }
-          showVolume();
-          accum = 0;
-        }
+    case EV_KEY_UP:
+      comboKeyUp(e.value);
+      break;
+
+    case EV_DETENT: {
+      int16_t steps = accelerateStep(EncoderStep{ (int8_t)e.value, e.timeUs });
+      if (currentEncoderMode == MODE_SCROLL || currentEncoderMode == MODE_HSCROLL) {
+        // Le défilement part au quart de cran (EV_ROTATE, qui suit toujours
+        // les crans) ; l'accélération y ajoute ses pas.
+        pendingScrollUnits += (steps - e.value) * STEPS_PER_DETENT;
+        if (!scrollDetentPending) scrollDetentUs = e.timeUs;
+        scrollDetentPending = true;
+        break;
+      }
+      if (steps == 0) break;
+      int8_t direction = (steps > 0) ? 1 : -1;
+      if (currentEncoderMode == MODE_VOLUME) {
+        // Pas de quantité dans un rapport multimédia : un appui par pas, joué
+        // par l'exécuteur à raison d'un par tour. Les crans rapides s'ajoutent
+        // à l'étape encore en file, dans la limite de la plage du volume.
+        int16_t count = min(VOLUME_MAX_STEPS, (int16_t)abs(steps));
+        uint16_t usage = (direction > 0) ? HID_USAGE_CONSUMER_VOLUME_INCREMENT : HID_USAGE_CONSUMER_VOLUME_DECREMENT;
+        profileInput(e.timeUs, LATENCY_VOLUME); // Mesuré par l'exécuteur de macros
+        macroRepeat(MACRO_TRACK_ENCODER, STEP_CONSUMER, 0, usage, count, VOLUME_MAX_STEPS);
+        profileInputDone();
+        currentVol = max(0, min(100, currentVol + (2 * direction * count)));
+      } else {
+        // Un raccourci par pas, joué par l'exécuteur un par tour : aucun cran perdu
+        profileInput(e.timeUs, LATENCY_SHORTCUT); // Mesuré par l'exécuteur de macros
+        repeatCombo_Ctrl(direction > 0 ? 'y' : 'z', min((int16_t)255, (int16_t)abs(steps)), MACRO_TRACK_ENCODER);
+        profileInputDone();
       }
-      lastAB = nowAB;
+      wakeUp();
+      showVolume();
+      break;
     }
 
-    bool buttonState = (digitalRead(ENC_SW) == LOW);
-    static bool lastButtonState = false;
-    static unsigned long buttonPressStartTime = 0;
-    static bool actionTakenOnPress = false;
-    if (buttonState && !lastButtonState) { buttonPressStartTime = millis(); actionTakenOnPress = false; }
-    if (buttonState && !actionTakenOnPress && (millis() - buttonPressStartTime > VERY_LONG_PRESS_DURATION)) {
-      isInMenu = !isInMenu;
-      if (isInMenu) { wakeUp(); selectedMenuItem = 0; blockMenuClickUntilRelease = true; drawMenu(); } 
-      else { showVolume(); }
-      actionTakenOnPress = true;
-    }
-    if (!buttonState && lastButtonState) {
-      if (!actionTakenOnPress) {
+    case EV_ROTATE: {
+      if (currentEncoderMode != MODE_SCROLL && currentEncoderMode != MODE_HSCROLL) {
+        pendingScrollUnits = 0;
+        scrollDetentPending = false;
+        break;
+      }
+      // Défilement au quart de cran, plus les pas ajoutés par l'accélération
+      int16_t units = e.value + pendingScrollUnits;
+      pendingScrollUnits = 0;
+      if (units != 0) {
+        if (scrollDetentPending) profileHidReport(profileMark(scrollDetentUs, LATENCY_SCROLL));
+        if (currentEncoderMode == MODE_SCROLL) Mouse.scrollQuarters(units, 0);
+        else Mouse.scrollQuarters(0, units);
         wakeUp();
-        unsigned long pressDuration = millis() - buttonPressStartTime;
-        if (pressDuration > LONG_PRESS_DURATION) {
-          if (currentEncoderMode == MODE_VOLUME) currentEncoderMode = MODE_SCROLL;
-          else if (currentEncoderMode == MODE_SCROLL) currentEncoderMode = MODE_UNDO_REDO;
-          else if (currentEncoderMode == MODE_UNDO_REDO) currentEncoderMode = MODE_VOLUME;
-        } else {
-          switch (currentEncoderMode) {
-            case MODE_VOLUME: muted = !muted; Consumer.press(HID_USAGE_CONSUMER_MUTE); Consumer.release(); break;
-            case MODE_SCROLL: Mouse.click(MOUSE_MIDDLE); break;
-            case MODE_UNDO_REDO: break;
-          }
-        }
-        showVolume();
+        if (scrollDetentPending) showVolume();
       }
+      scrollDetentPending = false;
+      break;
     }
-    lastButtonState = buttonState;
+
+    case EV_BUTTON_VERY_LONG: // Menu de configuration
+      wakeUp();
+      menuOpen(CONFIG_MENU);
+      break;
+
+    case EV_BUTTON_LONG: // Mode suivant de l'encodeur
+      wakeUp();
+      selectEncoderMode(SELECT_NEXT);
+      break;
+
+    case EV_BUTTON_SHORT:
+      wakeUp();
+      switch (currentEncoderMode) {
+        case MODE_VOLUME: setMute(!muted); break;
+        case MODE_SCROLL:
+        case MODE_HSCROLL: Mouse.click(MOUSE_MIDDLE); break;
+        case MODE_UNDO_REDO: break;
+      }
+      showVolume();
+      break;
+
+    default:
+      break;
   }
 }
 
+/**
+ * @brief Convertit un cran de l'encodeur en nombre de pas signé.
+ * La vitesse est mesurée entre deux crans de même sens (courbe ENCODER_ACCEL
+ * du mode actif, config.h). Un changement de sens repart à 1 pas ; un retour
+ * en arrière plus rapide que STEP_COOLDOWN_MS est un rebond et est ignoré.
+ * @param step Le cran horodaté retiré de la file.
+ * @return Le nombre de pas à appliquer (0 si ignoré).
+ */
+int16_t accelerateStep(const EncoderStep& step) {
+  unsigned long stepMs = step.timeUs / 1000;
+  unsigned long intervalMs = stepMs - lastStepMs;
+  bool reversed = (step.delta != lastStepDir);
+  if (reversed && lastStepDir != 0 && intervalMs < STEP_COOLDOWN_MS) return 0;
+  lastStepMs = stepMs;
+  lastStepDir = step.delta;
+  if (reversed) return step.delta;
+  return step.delta * encoderAccelMultiplier(ENCODER_ACCEL[currentEncoderMode], intervalMs);
+}
+
 /**
  * @brief Point central pour déclencher les macros.
  * @param id L'identifiant de la touche pressée (de 0 à 8).
- * @note C'EST ICI QU'IL FAUT PERSONNALISER LES ACTIONS DE CHAQUE TOUCHE.
+ * @note Les actions de chaque touche se personnalisent dans la table KEYMAP (config.h).
  */
 void fireMacro(uint8_t id) {
-  // --- GESTION DU CHANGEMENT DE COUCHE ---
-  // Si la touche dédiée (K9) est pressée, on change de couche et on s'arrête là.
-  if (id == K9) {
-    currentLayer = (currentLayer + 1) % NUM_LAYERS;
-    char layerMsg[10];
-    sprintf(layerMsg, "Layer %d", currentLayer);
-    showMessage(layerMsg);
-    return;
-  }
+  if (id >= NUM_KEYS || currentLayer >= NUM_LAYERS) return;
+  KeyAction scratch;
+  const KeyAction& action = keymapLookup(currentLayer, id, scratch); // Redéfinition ou KEYMAP
+  action.handler(action);
+}
 
-  // Appelle la fonction de macro correspondante à la couche active
-  switch (currentLayer) {
-    case 0:
-      executeMacroForLayer0(id);
-      break;
-    case 1:
-      executeMacroForLayer1(id);
-      break;
-    case 2:
-      executeMacroForLayer2(id);
-      break;
-  }
+/**
+ * @brief Change de couche et l'affiche.
+ * @param layer La couche voulue, ou SELECT_NEXT pour la suivante.
+ */
+void selectLayer(uint8_t layer) {
+  if (layer == SELECT_NEXT) layer = (currentLayer + 1) % NUM_LAYERS;
+  if (layer >= NUM_LAYERS) return;
+  currentLayer = layer;
+  char layerMsg[10];
+  sprintf(layerMsg, "Layer %d", currentLayer);
+  showMessage(layerMsg);
+}
+
+/**
+ * @brief Change le mode de l'encodeur et l'affiche.
+ * @param mode Le mode voulu (EncoderMode), ou SELECT_NEXT pour le suivant.
+ */
+void selectEncoderMode(uint8_t mode) {
+  if (mode == SELECT_NEXT) mode = (currentEncoderMode + 1) % NUM_ENCODER_MODES;
+  if (mode >= NUM_ENCODER_MODES) return;
+  currentEncoderMode = (EncoderMode)mode;
+  showVolume();
 }
 
 // Affiche un message temporaire sur l'écran OLED.
 void showMessage(const char* msg) {
   wakeUp();
   display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 8);
-  display.println(msg);
+  display.drawText(0, 8, msg, TEXT_WHITE, true);
   display.display();
 }
 
+// Textes fixes de showVolume(), rendus à la compilation (text-blit.h)
+constexpr auto TITLE_VOLUME = textStrip("Mode: Volume");
+constexpr auto TITLE_SCROLL = textStrip("Mode: Scroll");
+constexpr auto TITLE_HSCROLL = textStrip("Mode: Scroll H");
+constexpr auto TITLE_UNDO_REDO = textStrip("Mode: Undo/Redo");
+constexpr auto LABEL_MUTE = textStrip("ETAT: MUTE");
+constexpr auto LABEL_STATE = textStrip("ETAT: ");
+
 // Affiche la barre de volume sur l'écran OLED.
 void showVolume() {
   wakeUp();
+  drawVolume();
+}
+
+/**
+ * @brief Redessine l'écran visible après un changement venu de l'ordinateur
+ * (host-link.h), sans compter comme une action : l'écran ne se rallume pas
+ * et le minuteur d'inactivité continue.
+ */
+void refreshVolumeScreen() {
+  if (powerState != POWER_ACTIVE || deferredScreen != nullptr || isInMenu) return;
+  if (currentState == STATE_ICON_MENU) drawIconMenu();
+  else drawVolume();
+}
+
+// Dessine l'écran de l'encodeur (mode, volume ou muet).
+void drawVolume() {
   display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 0);
 
   // Affiche le titre en fonction du mode de l'encodeur
   switch (currentEncoderMode) {
     case MODE_VOLUME:
-      display.print(F("Mode: Volume"));
+      display.drawStrip(0, 0, TITLE_VOLUME);
       break;
     case MODE_SCROLL:
-      display.print(F("Mode: Scroll"));
+      display.drawStrip(0, 0, TITLE_SCROLL);
       // On affiche l'icône de scroll au lieu du texte
-      display.drawBitmap(
-        (SCREEN_WIDTH - 16) / 2, // Centré en X
-        20,                       // En haut de l'écran en Y
-        icon_scroll_16x16,       // Données de l'icône
-        16, 16,                  // Largeur et hauteur
-        SSD1306_WHITE);
+      display.drawIcon16((SCREEN_WIDTH - 16) / 2, 20, icon_scroll_16x16, SSD1306_WHITE);
+      break;
+    case MODE_HSCROLL:
+      display.drawStrip(0, 0, TITLE_HSCROLL);
+      display.drawIcon16((SCREEN_WIDTH - 16) / 2, 20, icon_scroll_16x16, SSD1306_WHITE);
       break;
     case MODE_UNDO_REDO:
-      display.print(F("Mode: Undo/Redo"));
+      display.drawStrip(0, 0, TITLE_UNDO_REDO);
       // On affiche l'icône de undo_redo et le texte
-      display.drawBitmap(
-        (SCREEN_WIDTH - 16) / 2, // Centré en X
-        20,                       // En haut de l'écran en Y
-        icon_undo_redo_16x16,       // Données de l'icône
-        16, 16,                  // Largeur et hauteur
-        SSD1306_WHITE);      
+      display.drawIcon16((SCREEN_WIDTH - 16) / 2, 20, icon_undo_redo_16x16, SSD1306_WHITE);
       break;
   }
 
@@ -462,30 +492,19 @@ void showVolume() {
   if (currentEncoderMode == MODE_VOLUME) {
     if (muted) {
       // 1. On affiche d'abord le texte en haut de l'écran
-      display.setCursor(0, 10); // Position X (environ centré), Position Y (en haut)
-      display.println(F("ETAT: MUTE"));
+      display.drawStrip(0, 10, LABEL_MUTE);
 
       // 2. Ensuite, on dessine l'icône en dessous du texte
-      display.drawBitmap(
-        (SCREEN_WIDTH - 16) / 2,  // Position X (centrée)
-        20,                       // Position Y (plus bas pour ne pas chevaucher le texte)
-        icon_mute_16x16,          // Le tableau de l'icône
-        16, 16,                   // Largeur et hauteur
-        SSD1306_WHITE);           // Couleur
+      display.drawIcon16((SCREEN_WIDTH - 16) / 2, 20, icon_mute_16x16, SSD1306_WHITE);
         
     } else {
       // Sinon, on affiche l'état normal et la barre de volume
-      display.setCursor(0, 10);
-      display.print(F("ETAT: "));
+      int16_t x = display.drawStrip(0, 10, LABEL_STATE);
       // On affiche l'icône de sound et le texte
-      display.drawBitmap(
-        (SCREEN_WIDTH - 16) / 2 + 40, // Centré en X
-        1,                       // En haut de l'écran en Y
-        icon_sound_16x16,       // Données de l'icône
-        16, 16,                  // Largeur et hauteur
-        SSD1306_WHITE);            
-      display.print(currentVol);
-      display.println('%');
+      display.drawIcon16((SCREEN_WIDTH - 16) / 2 + 40, 1, icon_sound_16x16, SSD1306_WHITE);
+      char volume[8];
+      snprintf(volume, sizeof(volume), hostVolumeKnown ? "%d%%" : "~%d%%", currentVol); // ~ : estimé
+      display.drawText(x, 10, volume);
       int barW = map(currentVol, 0, 100, 0, SCREEN_WIDTH - 10);
       display.drawRect(5, 22, SCREEN_WIDTH - 10, 8, SSD1306_WHITE);
       if (barW > 0) display.fillRect(5, 22, barW, 8, SSD1306_WHITE);
@@ -496,15 +515,26 @@ void showVolume() {
 }
 
 // Sort l'écran du mode veille et réinitialise le minuteur.
+// Toute nouvelle interaction annule aussi un changement d'écran programmé.
 void wakeUp() { 
   if (isSleeping) {
     display.ssd1306_command(SSD1306_DISPLAYON);
     isSleeping = false;
   }
-  isScreensaverActive = false; // screensaver
+  deferredScreen = nullptr;
   lastActionTime = millis();
 }
 
+/**
+ * @brief Programme l'affichage d'un écran après un délai, sans bloquer loop().
+ * @param screen La fonction qui dessine l'écran.
+ * @param delayMs Le délai en millisecondes.
+ */
+void scheduleScreen(void (*screen)(), unsigned long delayMs) {
+  deferredScreen = screen;
+  deferredScreenAt = millis() + delayMs;
+}
+
 /**
  * @brief Applique une nouvelle valeur de contraste (luminosité) à l'écran.
  * @param brightness La valeur de luminosité (0-255).
@@ -516,56 +546,14 @@ void setBrightness(uint8_t brightness) {
 }
 
 /**
- * @brief Dessine et anime l'icône de l'économiseur d'écran,
- * avec un effet de rotation.
+ * @brief Coupe ou rétablit le son de l'ordinateur (touche multimédia Muet).
+ * @param on 1 pour couper, 0 pour rétablir ; rien n'est envoyé si l'état est déjà le bon.
  */
-void drawScreensaver() {
-  // Met à jour la position de l'icône
-  iconX += iconDX;
-  iconY += iconDY;
-
-  // Gère les rebonds sur les bords
-  if (iconX <= 0 || iconX >= SCREEN_WIDTH - 16) {
-    iconDX = -iconDX; // Inverse la direction horizontale
-  }
-  if (iconY <= 0 || iconY >= SCREEN_HEIGHT - 16) {
-    iconDY = -iconDY; // Inverse la direction verticale
-  }
-
-  // Affiche l'icône
-  display.clearDisplay();
-  
-  // Affiche la frame actuelle de l'animation de rotation
-  display.drawBitmap(iconX, iconY, screensaverFrames[currentFrame], 16, 16, SSD1306_WHITE);
-  
-  display.display();
-  delay(10); // Ralentit un peu l'animation
-
-  // Passe à la frame suivante pour le prochain appel
-  currentFrame = (currentFrame + 1) % 4; // Boucle de 0 à 3
-}
-
-/**
- * @brief Dessine le menu de configuration sur l'écran OLED.
- */
-void drawMenu() {
-  display.clearDisplay();
-  display.setTextSize(1);
-  
-  for (uint8_t i = 0; i < NUM_MENU_ITEMS; i++) {
-    display.setCursor(10, (i * 12) + 1);
-    if (i == selectedMenuItem) {
-      // Affiche l'élément sélectionné en vidéo inverse (texte noir sur fond blanc)
-      display.setTextColor(SSD1306_BLACK, SSD1306_WHITE);
-      display.print(F("> "));
-      display.print(menuItems[i]);
-    } else {
-      display.setTextColor(SSD1306_WHITE);
-      display.print(F("  "));
-      display.print(menuItems[i]);
-    }
-  }
-  display.display();
+void setMute(uint8_t on) {
+  if (muted == (on != 0)) return;
+  muted = (on != 0);
+  Consumer.press(HID_USAGE_CONSUMER_MUTE);
+  Consumer.release();
 }
 
 /**
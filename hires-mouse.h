@@ -0,0 +1,172 @@
+#pragma once
+#include <USBHID.h>
+#include "encoder.h"
+
+// =============================================================================
+//     MODULE SOURIS USB : MOLETTE HAUTE RÉSOLUTION
+// =============================================================================
+// Remplace USBHIDMouse (même identifiant de rapport HID_REPORT_ID_MOUSE).
+// Le descripteur déclare, pour la molette verticale et pour le défilement
+// horizontal (AC Pan), la fonctionnalité "Resolution Multiplier" :
+// l'hôte qui sait faire du défilement fluide (Windows, Linux récents...)
+// active un multiplicateur x4 par un rapport "feature". Chaque unité de
+// molette vaut alors un quart de cran, soit une transition de l'encodeur.
+//
+// Si l'hôte n'active pas le multiplicateur, les quarts de cran sont cumulés
+// et seuls les crans entiers sont envoyés (comportement d'une souris normale).
+// -----------------------------------------------------------------------------
+
+#ifndef MOUSE_LEFT
+  #define MOUSE_LEFT    0x01
+  #define MOUSE_RIGHT   0x02
+  #define MOUSE_MIDDLE  0x04
+  #define MOUSE_BACKWARD 0x08
+  #define MOUSE_FORWARD 0x10
+#endif
+
+const uint8_t HIRES_WHEEL_MULTIPLIER = 4; // Unités de molette par cran quand le multiplicateur est actif
+
+// Descripteur : 5 boutons, X/Y relatifs, puis molette et AC Pan chacun dans
+// une collection logique avec son Resolution Multiplier (2 bits, 1 à 4).
+static const uint8_t HIRES_MOUSE_DESCRIPTOR[] = {
+  0x05, 0x01,             // Usage Page (Generic Desktop)
+  0x09, 0x02,             // Usage (Mouse)
+  0xA1, 0x01,             // Collection (Application)
+  0x85, HID_REPORT_ID_MOUSE, //   Report ID
+  0x09, 0x01,             //   Usage (Pointer)
+  0xA1, 0x00,             //   Collection (Physical)
+  0x05, 0x09,             //     Usage Page (Button)
+  0x19, 0x01, 0x29, 0x05, //     Usage Minimum (1), Usage Maximum (5)
+  0x15, 0x00, 0x25, 0x01, //     Logical Minimum (0), Logical Maximum (1)
+  0x95, 0x05, 0x75, 0x01, //     Report Count (5), Report Size (1)
+  0x81, 0x02,             //     Input (Data, Var, Abs)
+  0x95, 0x01, 0x75, 0x03, //     Report Count (1), Report Size (3)
+  0x81, 0x01,             //     Input (Const) : bourrage
+  0x05, 0x01,             //     Usage Page (Generic Desktop)
+  0x09, 0x30, 0x09, 0x31, //     Usage (X), Usage (Y)
+  0x15, 0x81, 0x25, 0x7F, //     Logical Minimum (-127), Logical Maximum (127)
+  0x75, 0x08, 0x95, 0x02, //     Report Size (8), Report Count (2)
+  0x81, 0x06,             //     Input (Data, Var, Rel)
+
+  0xA1, 0x02,             //     Collection (Logical) : molette verticale
+  0x09, 0x48,             //       Usage (Resolution Multiplier)
+  0x15, 0x00, 0x25, 0x01, //       Logical Minimum (0), Logical Maximum (1)
+  0x35, 0x01, 0x45, 0x04, //       Physical Minimum (1), Physical Maximum (4)
+  0x75, 0x02, 0x95, 0x01, //       Report Size (2), Report Count (1)
+  0xB1, 0x02,             //       Feature (Data, Var, Abs)
+  0x35, 0x00, 0x45, 0x00, //       Physical Minimum (0), Physical Maximum (0)
+  0x09, 0x38,             //       Usage (Wheel)
+  0x15, 0x81, 0x25, 0x7F, //       Logical Minimum (-127), Logical Maximum (127)
+  0x75, 0x08, 0x95, 0x01, //       Report Size (8), Report Count (1)
+  0x81, 0x06,             //       Input (Data, Var, Rel)
+  0xC0,                   //     End Collection
+
+  0xA1, 0x02,             //     Collection (Logical) : défilement horizontal
+  0x09, 0x48,             //       Usage (Resolution Multiplier)
+  0x15, 0x00, 0x25, 0x01, //       Logical Minimum (0), Logical Maximum (1)
+  0x35, 0x01, 0x45, 0x04, //       Physical Minimum (1), Physical Maximum (4)
+  0x75, 0x02, 0x95, 0x01, //       Report Size (2), Report Count (1)
+  0xB1, 0x02,             //       Feature (Data, Var, Abs)
+  0x35, 0x00, 0x45, 0x00, //       Physical Minimum (0), Physical Maximum (0)
+  0x05, 0x0C,             //       Usage Page (Consumer)
+  0x0A, 0x38, 0x02,       //       Usage (AC Pan)
+  0x15, 0x81, 0x25, 0x7F, //       Logical Minimum (-127), Logical Maximum (127)
+  0x75, 0x08, 0x95, 0x01, //       Report Size (8), Report Count (1)
+  0x81, 0x06,             //       Input (Data, Var, Rel)
+  0xC0,                   //     End Collection
+
+  0x75, 0x04, 0x95, 0x01, //     Report Size (4), Report Count (1)
+  0xB1, 0x01,             //     Feature (Const) : bourrage de l'octet
+  0xC0,                   //   End Collection
+  0xC0                    // End Collection
+};
+
+// Rapport d'entrée (même disposition que hid_mouse_report_t).
+struct __attribute__((packed)) HiResMouseReport {
+  uint8_t buttons;
+  int8_t x, y;
+  int8_t wheel;
+  int8_t pan;
+};
+
+class HiResMouse : public USBHIDDevice {
+public:
+  HiResMouse() {
+    static bool initialized = false;
+    if (!initialized) {
+      initialized = true;
+      hid.addDevice(this, sizeof(HIRES_MOUSE_DESCRIPTOR));
+    }
+  }
+
+  void begin() { hid.begin(); }
+
+  // --- Même interface que USBHIDMouse ---
+  void move(int8_t x, int8_t y, int8_t wheel = 0, int8_t pan = 0) {
+    HiResMouseReport report = { buttons, x, y, wheel, pan };
+    hid.SendReport(HID_REPORT_ID_MOUSE, &report, sizeof(report));
+  }
+  void click(uint8_t b = MOUSE_LEFT) { setButtons(b); move(0, 0); setButtons(0); move(0, 0); }
+  void press(uint8_t b = MOUSE_LEFT)   { setButtons(buttons | b); move(0, 0); }
+  void release(uint8_t b = MOUSE_LEFT) { setButtons(buttons & ~b); move(0, 0); }
+
+  /**
+   * @brief Fait défiler en quarts de cran (une transition de l'encodeur = 1).
+   * Multiplicateur actif : envoyé tel quel, en un seul rapport si possible.
+   * Sinon : cumulé, et seuls les crans entiers partent.
+   * @param wheelQuarters Défilement vertical, en quarts de cran.
+   * @param panQuarters Défilement horizontal, en quarts de cran.
+   */
+  void scrollQuarters(int16_t wheelQuarters, int16_t panQuarters) {
+    int16_t wheel = toUnits(wheelQuarters, wheelHiRes, wheelRemainder);
+    int16_t pan = toUnits(panQuarters, panHiRes, panRemainder);
+    while (wheel != 0 || pan != 0) {
+      int8_t w = clampUnit(wheel), p = clampUnit(pan);
+      move(0, 0, w, p);
+      wheel -= w;
+      pan -= p;
+    }
+  }
+
+  // Vrai si l'hôte a activé le multiplicateur de la molette verticale.
+  bool wheelHighResolution() const { return wheelHiRes; }
+  bool panHighResolution() const { return panHiRes; }
+
+  // --- Rappels de la pile USB ---
+  uint16_t _onGetDescriptor(uint8_t* buffer) override {
+    memcpy(buffer, HIRES_MOUSE_DESCRIPTOR, sizeof(HIRES_MOUSE_DESCRIPTOR));
+    return sizeof(HIRES_MOUSE_DESCRIPTOR);
+  }
+  uint16_t _onGetFeature(uint8_t report_id, uint8_t* buffer, uint16_t len) override {
+    if (report_id != HID_REPORT_ID_MOUSE || len < 1) return 0;
+    buffer[0] = (wheelHiRes ? 0x01 : 0) | (panHiRes ? 0x04 : 0);
+    return 1;
+  }
+  void _onSetFeature(uint8_t report_id, const uint8_t* buffer, uint16_t len) override {
+    if (report_id != HID_REPORT_ID_MOUSE || len < 1) return;
+    wheelHiRes = (buffer[0] & 0x03) != 0; // Valeur logique 1 = multiplicateur x4
+    panHiRes = (buffer[0] & 0x0C) != 0;
+    wheelRemainder = panRemainder = 0;
+  }
+
+private:
+  USBHID hid;
+  uint8_t buttons = 0;
+  volatile bool wheelHiRes = false, panHiRes = false;
+  int16_t wheelRemainder = 0, panRemainder = 0; // Quarts de cran pas encore envoyés
+
+  void setButtons(uint8_t b) { buttons = b; }
+
+  static int8_t clampUnit(int16_t v) { return (int8_t)max((int16_t)-127, min((int16_t)127, v)); }
+
+  // Quarts de cran -> unités du rapport (selon le multiplicateur négocié).
+  static int16_t toUnits(int16_t quarters, bool hiRes, int16_t& remainder) {
+    if (hiRes) return quarters * (HIRES_WHEEL_MULTIPLIER / STEPS_PER_DETENT);
+    remainder += quarters;
+    int16_t notches = remainder / STEPS_PER_DETENT; // Tronqué vers zéro
+    remainder -= notches * STEPS_PER_DETENT;
+    return notches;
+  }
+};
+
+/* ------------------------------ Fin du code -------------------------------- */
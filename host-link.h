@@ -0,0 +1,219 @@
+#pragma once
+#include <USBHID.h>
+
+// =============================================================================
+//     MODULE DU CANAL HID VENDEUR (ÉTAT POUSSÉ PAR L'ORDINATEUR)
+// =============================================================================
+// Sans retour de l'ordinateur, currentVol n'est qu'une estimation (+/- 2 %
+// par cran) et 'muted' bascule à l'aveugle : la barre dérive du vrai volume.
+// Ce module ajoute une interface HID "vendeur" (page 0xFF00) avec des
+// rapports OUT et IN de HOST_REPORT_SIZE octets. Un compagnon sur
+// l'ordinateur (tools/macropad_host.py) y pousse le vrai volume, l'état muet
+// et le nom de l'application au premier plan.
+//
+// Rapport : type, données (complété par des zéros).
+//   HOST_SET_VOLUME   volume (0-100), muet (0/1)        ordinateur -> macropad
+//   HOST_SET_APP      nom de l'application (texte)      ordinateur -> macropad
+//   HOST_PING         données quelconques               ordinateur -> macropad
+//   HOST_GET_STATE                                      ordinateur -> macropad
+//   HOST_PONG         les données du ping, renvoyées    macropad -> ordinateur
+//   HOST_STATE        couche, mode, volume, muet, profil, version
+//
+// Le nom d'application choisit un profil de la table APP_PROFILES (config.h),
+// comme les profils du menu d'icônes mais automatiquement. Une application
+// sans profil rend la couche et le mode choisis à la main.
+//
+// Les rapports OUT arrivent dans la tâche USB : _onOutput() ne fait que les
+// ranger dans une petite file sans verrou (un producteur, un consommateur),
+// et hostLinkPoll() les traite dans loop().
+// -----------------------------------------------------------------------------
+
+const uint8_t HOST_REPORT_SIZE = 32;
+const uint8_t HOST_LINK_VERSION = 1;
+const uint8_t HOST_QUEUE_SIZE = 8;          // Puissance de 2 obligatoire
+const uint8_t HOST_APP_NAME_LEN = HOST_REPORT_SIZE - 1;
+const uint8_t HOST_NO_PROFILE = 0xFF;
+const uint8_t PROFILE_KEEP_LAYER = 0xFF;    // Profil qui ne change pas de couche (ici et menu d'icônes)
+static_assert((HOST_QUEUE_SIZE & (HOST_QUEUE_SIZE - 1)) == 0, "HOST_QUEUE_SIZE doit etre une puissance de 2");
+
+enum HostMessage : uint8_t {
+  HOST_SET_VOLUME = 0x01,
+  HOST_SET_APP    = 0x02,
+  HOST_PING       = 0x03,
+  HOST_GET_STATE  = 0x04,
+  HOST_PONG       = 0x83,
+  HOST_STATE      = 0x84
+};
+
+// Un profil par application : 'match' est cherché dans le nom envoyé par
+// l'ordinateur, sans tenir compte des majuscules (ex: "code" -> "Code.exe").
+struct AppProfile {
+  const char* match;
+  uint8_t layer;               // PROFILE_KEEP_LAYER : couche inchangée
+  uint8_t encoderMode;         // EncoderMode
+};
+
+// Descripteur : une collection vendeur, HOST_REPORT_SIZE octets dans chaque sens.
+static const uint8_t HOST_LINK_DESCRIPTOR[] = {
+  0x06, 0x00, 0xFF,       // Usage Page (Vendor Defined 0xFF00)
+  0x09, 0x01,             // Usage (0x01)
+  0xA1, 0x01,             // Collection (Application)
+  0x85, HID_REPORT_ID_VENDOR, //   Report ID
+  0x15, 0x00,             //   Logical Minimum (0)
+  0x26, 0xFF, 0x00,       //   Logical Maximum (255)
+  0x75, 0x08,             //   Report Size (8)
+  0x95, HOST_REPORT_SIZE, //   Report Count
+  0x09, 0x02,             //   Usage (0x02)
+  0x81, 0x02,             //   Input (Data, Var, Abs) : macropad -> ordinateur
+  0x95, HOST_REPORT_SIZE, //   Report Count
+  0x09, 0x03,             //   Usage (0x03)
+  0x91, 0x02,             //   Output (Data, Var, Abs) : ordinateur -> macropad
+  0xC0                    // End Collection
+};
+
+class HostLinkHID : public USBHIDDevice {
+public:
+  HostLinkHID() {
+    static bool initialized = false;
+    if (!initialized) {
+      initialized = true;
+      hid.addDevice(this, sizeof(HOST_LINK_DESCRIPTOR));
+    }
+  }
+
+  void begin() { hid.begin(); }
+
+  // Envoie un rapport IN (complété par des zéros).
+  bool send(const uint8_t* data, uint8_t len) {
+    uint8_t report[HOST_REPORT_SIZE] = {};
+    memcpy(report, data, min(len, HOST_REPORT_SIZE));
+    return hid.SendReport(HID_REPORT_ID_VENDOR, report, sizeof(report));
+  }
+
+  // Retire le plus ancien rapport reçu. Retourne false si la file est vide.
+  bool pop(uint8_t* report) {
+    const uint8_t t = tail;
+    if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false;
+    memcpy(report, queue[t & (HOST_QUEUE_SIZE - 1)], HOST_REPORT_SIZE);
+    __atomic_store_n(&tail, (uint8_t)(t + 1), __ATOMIC_RELEASE); // Case rendue après la lecture
+    return true;
+  }
+
+  // --- Rappels de la pile USB ---
+  uint16_t _onGetDescriptor(uint8_t* buffer) override {
+    memcpy(buffer, HOST_LINK_DESCRIPTOR, sizeof(HOST_LINK_DESCRIPTOR));
+    return sizeof(HOST_LINK_DESCRIPTOR);
+  }
+  void _onOutput(uint8_t report_id, const uint8_t* buffer, uint16_t len) override {
+    if (report_id != HID_REPORT_ID_VENDOR || len == 0) return;
+    const uint8_t h = head;
+    if ((uint8_t)(h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) >= HOST_QUEUE_SIZE) { overflows++; return; }
+    uint8_t* slot = queue[h & (HOST_QUEUE_SIZE - 1)];
+    memset(slot, 0, HOST_REPORT_SIZE);
+    memcpy(slot, buffer, min(len, (uint16_t)HOST_REPORT_SIZE));
+    __atomic_store_n(&head, (uint8_t)(h + 1), __ATOMIC_RELEASE); // Publié après la copie
+  }
+
+  volatile uint32_t overflows = 0;    // Rapports perdus, file pleine
+
+private:
+  USBHID hid;
+  uint8_t queue[HOST_QUEUE_SIZE][HOST_REPORT_SIZE];
+  // File SPSC entre la tâche USB (l'autre cœur) et loop(), comme encoder.h.
+  volatile uint8_t head = 0;          // Écrit uniquement par la tâche USB
+  volatile uint8_t tail = 0;          // Écrit uniquement par loop()
+};
+
+// --- Déclarations des fonctions externes ---
+void refreshVolumeScreen();
+
+// --- Déclaration des variables GLOBALES utilisées par ce module ---
+extern uint8_t currentLayer;
+extern EncoderMode currentEncoderMode;
+extern int currentVol;
+extern bool muted;
+
+// --- Variables propres à ce module ---
+HostLinkHID HostLink;
+bool hostVolumeKnown = false;              // Le volume affiché vient de l'ordinateur
+uint8_t hostAppProfile = HOST_NO_PROFILE;  // Profil d'application actif
+uint8_t hostManualLayer = 0;               // Choix manuel, rendu quand aucun profil ne s'applique
+EncoderMode hostManualMode = MODE_VOLUME;
+char hostAppName[HOST_APP_NAME_LEN + 1] = "";
+uint32_t hostReports = 0;                  // Rapports traités
+
+// Vrai si 'needle' apparaît dans 'text', sans tenir compte des majuscules.
+bool hostNameContains(const char* text, const char* needle) {
+  for (; *text != '\0'; text++) {
+    const char* t = text;
+    const char* n = needle;
+    while (*n != '\0' && *t != '\0' && tolower((uint8_t)*t) == tolower((uint8_t)*n)) { t++; n++; }
+    if (*n == '\0') return true;
+  }
+  return false;
+}
+
+// Applique le profil de l'application au premier plan (ou rend le choix manuel).
+void hostSelectApp(const char* name, const AppProfile* profiles, uint8_t count) {
+  strncpy(hostAppName, name, HOST_APP_NAME_LEN);
+  hostAppName[HOST_APP_NAME_LEN] = '\0';
+  uint8_t found = HOST_NO_PROFILE;
+  for (uint8_t i = 0; i < count && found == HOST_NO_PROFILE; i++) {
+    if (hostNameContains(hostAppName, profiles[i].match)) found = i;
+  }
+  if (found == hostAppProfile) return;
+
+  if (hostAppProfile == HOST_NO_PROFILE) { // On quitte le choix manuel : on le garde
+    hostManualLayer = currentLayer;
+    hostManualMode = currentEncoderMode;
+  }
+  hostAppProfile = found;
+  if (found == HOST_NO_PROFILE) {
+    currentLayer = hostManualLayer;
+    currentEncoderMode = hostManualMode;
+  } else {
+    if (profiles[found].layer != PROFILE_KEEP_LAYER) currentLayer = profiles[found].layer;
+    currentEncoderMode = (EncoderMode)profiles[found].encoderMode;
+  }
+  refreshVolumeScreen();
+}
+
+/**
+ * @brief Traite les rapports reçus de l'ordinateur ; à appeler à chaque tour de loop().
+ * @param profiles La table des profils par application (APP_PROFILES, config.h).
+ */
+template <size_t N>
+void hostLinkPoll(const AppProfile (&profiles)[N]) {
+  uint8_t report[HOST_REPORT_SIZE];
+  while (HostLink.pop(report)) {
+    hostReports++;
+    switch (report[0]) {
+      case HOST_SET_VOLUME:
+        if (report[1] > 100) break;
+        hostVolumeKnown = true;
+        if (currentVol == report[1] && muted == (report[2] != 0)) break;
+        currentVol = report[1];
+        muted = (report[2] != 0);
+        refreshVolumeScreen();
+        break;
+      case HOST_SET_APP:
+        report[HOST_REPORT_SIZE - 1] = '\0';
+        hostSelectApp((const char*)report + 1, profiles, N);
+        break;
+      case HOST_PING: // Renvoyé tel quel : mesure de l'aller-retour
+        report[0] = HOST_PONG;
+        HostLink.send(report, HOST_REPORT_SIZE);
+        break;
+      case HOST_GET_STATE: {
+        const uint8_t state[] = { HOST_STATE, currentLayer, (uint8_t)currentEncoderMode, (uint8_t)currentVol,
+                                  (uint8_t)(muted ? 1 : 0), hostAppProfile, HOST_LINK_VERSION };
+        HostLink.send(state, sizeof(state));
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,158 @@
+#include "sketch.h"
+#include <chrono>
+
+// =============================================================================
+//     BANC D'ESSAI DE LA BOUCLE (BUILD LINUX)
+// =============================================================================
+// Joue une séance scriptée (menu d'icônes, mode normal, menu de
+// configuration) et mesure, pour chaque écran :
+//   - le coût d'un tour de loop() sur le PC (temps réel, pour comparer deux
+//     versions du firmware : ce n'est pas le temps de l'ESP32) ;
+//   - le temps bloqué par tour sur l'horloge virtuelle (delay(), rapports
+//     HID attendus, Flash) : moyenne et pire cas ;
+//   - le délai entre le premier front d'une entrée et le premier rapport HID
+//     qu'elle produit, et le premier octet d'image reçu par l'écran.
+// Le programme échoue si une entrée ne produit pas le rapport ou l'image
+// attendus.
+// -----------------------------------------------------------------------------
+
+struct Series {
+  uint32_t count = 0;
+  uint64_t total = 0, worst = 0;
+  void add(uint64_t v) { count++; total += v; worst = max(worst, v); }
+  uint64_t mean() const { return count ? total / count : 0; }
+};
+
+struct SlotStats {
+  Series hostNs;      // Coût d'un tour sur le PC
+  Series blockedUs;   // Temps bloqué par tour
+  Series reportUs;    // Entrée -> premier rapport HID
+  Series frameUs;     // Entrée -> image à l'écran
+};
+
+SlotStats slots[PROFILE_SLOT_COUNT];
+std::vector<uint64_t> frameTimes;   // Dates des images reçues par l'écran
+int failures = 0;
+
+ProfileSlot activeSlot() {
+  return currentState == STATE_ICON_MENU ? PROFILE_ICON_MENU : (isInMenu ? PROFILE_CONFIG_MENU : PROFILE_NORMAL);
+}
+
+// Un tour de loop(), mesuré.
+void benchLoop() {
+  SlotStats& s = slots[activeSlot()];
+  uint64_t blocked = hostBlockedUs;
+  uint32_t bytes = hostOled.dataBytes;
+  auto start = std::chrono::steady_clock::now();
+  loop();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  s.hostNs.add((uint64_t)ns);
+  s.blockedUs.add(hostBlockedUs - blocked);
+  if (hostOled.dataBytes != bytes) frameTimes.push_back(hostOled.lastDataUs);
+  hostAdvance(HOST_LOOP_US);
+}
+
+// Fait tourner la boucle jusqu'à la fin des traces, puis encore 'us'.
+void benchRun(uint64_t us) {
+  while (hostPinEventsPending()) benchLoop();
+  uint64_t until = hostNowUs() + us;
+  while (hostNowUs() < until) benchLoop();
+}
+
+const uint8_t EXPECT_REPORT = 1;  // L'entrée doit produire un rapport HID
+const uint8_t EXPECT_FRAME = 2;   // L'entrée doit changer l'image
+
+/**
+ * @brief Joue une entrée et mesure ses délais.
+ * @param name Le nom affiché en cas d'échec.
+ * @param schedule Programme la trace à partir de la date donnée et retourne
+ * la date du front qui déclenche l'action (le relâchement pour un appui long).
+ * @param expect EXPECT_REPORT et/ou EXPECT_FRAME.
+ * @param settleUs Temps laissé à la boucle après la trace.
+ */
+template <typename Trace>
+void benchInput(const char* name, Trace schedule, uint8_t expect, uint64_t settleUs = 300000) {
+  ProfileSlot slot = activeSlot();
+  size_t reports = hostHidReports.size(), frames = frameTimes.size();
+  uint64_t edge = schedule(hostNowUs() + 5000);
+  benchRun(settleUs);
+
+  while (reports < hostHidReports.size() && hostHidReports[reports].timeUs < edge) reports++;
+  while (frames < frameTimes.size() && frameTimes[frames] < edge) frames++;
+  if (reports < hostHidReports.size()) slots[slot].reportUs.add(hostHidReports[reports].timeUs - edge);
+  else if (expect & EXPECT_REPORT) printf("ECHEC : %s n'a produit aucun rapport HID\n", name), failures++;
+  if (frames < frameTimes.size()) slots[slot].frameUs.add(frameTimes[frames] - edge);
+  else if (expect & EXPECT_FRAME) printf("ECHEC : %s n'a rien affiche\n", name), failures++;
+}
+
+void detents(const char* name, int8_t dir, uint16_t count, uint32_t intervalUs, uint8_t expect) {
+  benchInput(name, [=](uint64_t t) { traceDetents(t, dir, count, intervalUs); return t; }, expect);
+}
+
+void key(const char* name, uint8_t pin, uint8_t expect, uint64_t settleUs = 300000) {
+  benchInput(name, [=](uint64_t t) { tracePress(t, pin); return t; }, expect, settleUs);
+}
+
+// Appui sur le bouton ; l'action part au relâchement, ou après 'actionUs' s'il est donné.
+void button(const char* name, uint64_t holdUs, uint64_t actionUs = 0) {
+  benchInput(name, [=](uint64_t t) { tracePress(t, ENC_SW, holdUs); return t + (actionUs ? actionUs : holdUs); }, EXPECT_FRAME);
+}
+
+// Appuis longs jusqu'au mode voulu de l'encodeur.
+void encoderMode(EncoderMode mode) {
+  while (currentEncoderMode != mode) button("appui long (mode suivant)", 700000);
+}
+
+void printSeries(const Series& s, const char* unit) {
+  if (s.count == 0) printf("  %-10s", "-");
+  else printf("  %4llu / %-6llu %s", (unsigned long long)s.mean(), (unsigned long long)s.worst, unit);
+}
+
+int main() {
+  hostBoot();
+  benchRun(100000);
+
+  // --- Menu d'icônes ---
+  detents("cran (menu d'icones)", +1, 1, 0, EXPECT_FRAME);
+  detents("cran (menu d'icones)", -1, 1, 0, EXPECT_FRAME);
+  key("K2 (menu d'icones)", KEY_PINS[K2], EXPECT_REPORT | EXPECT_FRAME, 2500000); // Retour au menu 2 s après
+  button("appui court (profil General)", 80000);
+  benchRun(1200000);
+
+  // --- Mode normal ---
+  key("K2 Win+R cmd", KEY_PINS[K2], EXPECT_REPORT | EXPECT_FRAME, 600000);
+  key("K8 Alt+Tab", KEY_PINS[K8], EXPECT_REPORT);
+  key("K1 Win+R notepad3.exe", KEY_PINS[K1], EXPECT_REPORT | EXPECT_FRAME, 600000);
+  encoderMode(MODE_VOLUME);
+  detents("cran lent (volume)", +1, 1, 0, EXPECT_REPORT | EXPECT_FRAME);
+  detents("rotation rapide (volume)", +1, 12, 10000, EXPECT_REPORT | EXPECT_FRAME);
+  encoderMode(MODE_SCROLL);
+  detents("cran lent (defilement)", -1, 1, 0, EXPECT_REPORT);
+  detents("rotation rapide (defilement)", -1, 12, 10000, EXPECT_REPORT);
+  encoderMode(MODE_UNDO_REDO);
+  detents("crans (annuler)", -1, 6, 40000, EXPECT_REPORT);
+
+  // --- Menu de configuration ---
+  button("appui tres long (menu)", 1700000, INPUT_VERY_LONG_PRESS_MS * 1000);
+  detents("cran (menu)", +1, 1, 0, EXPECT_FRAME);
+  detents("cran (menu)", +1, 1, 0, EXPECT_FRAME);
+  button("appui court (sous-menu)", 80000);
+  detents("cran (sous-menu)", +1, 1, 0, EXPECT_FRAME);
+
+  printf("Ecran          Tours   Cout PC (moy / max)   Bloque (moy / max)   Entree -> HID (moy / max)   Entree -> image (moy / max)\n");
+  for (uint8_t i = 0; i < PROFILE_SLOT_COUNT; i++) {
+    const SlotStats& s = slots[i];
+    printf("%-12s %7u", PROFILE_SLOT_NAMES[i], s.hostNs.count);
+    printSeries(s.hostNs, "ns");
+    printSeries(s.blockedUs, "us");
+    printSeries(s.reportUs, "us");
+    printSeries(s.frameUs, "us");
+    printf("\n");
+  }
+  printf("I2C : %llu us, %u octets (sur l'autre coeur : hors horloge de loop())\n",
+         (unsigned long long)hostI2cUs, hostI2cBytes);
+  printf("Rapports HID : %u\n", (unsigned)hostHidReports.size());
+  return failures ? 1 : 0;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,147 @@
+#include "sketch.h"
+#include <chrono>
+
+// =============================================================================
+//     BANC D'ESSAI DES MACROS EN BYTECODE (BUILD LINUX)
+// =============================================================================
+// Joue chaque macro sous ses deux formes : l'action C++ de keymap.h (Ctrl(),
+// RunCmd()...) et le programme en bytecode équivalent (Program(), macro-vm.h),
+// écrit instruction pour instruction d'après la fonction de key-shortcut.h.
+// Pour chaque forme, en moyenne sur RUNS appuis :
+//   - l'appel du gestionnaire de la touche (ce que fait fireMacro()) ;
+//   - le jeu de la macro par l'exécuteur, jusqu'à la piste vide (les
+//     attentes sont sautées sur l'horloge virtuelle, pas comptées) ;
+//   - la place prise : étapes en file, et octets du programme.
+// Les temps sont ceux du PC (pour comparer deux versions du firmware, pas
+// le temps de l'ESP32). Le programme échoue si les deux formes n'envoient
+// pas exactement les mêmes rapports HID.
+// -----------------------------------------------------------------------------
+
+const uint16_t RUNS = 1000;
+
+// --- Les programmes (OP_DOWN k, OP_WAIT8 ms... voir MacroOpcode) ---
+const uint8_t PROG_CTRL_C[] = {
+  OP_DOWN, KEY_LEFT_CTRL, OP_DOWN, 'c', OP_WAIT8, 40, OP_UP, 'c', OP_UP, KEY_LEFT_CTRL, OP_END
+};
+const uint8_t PROG_CTRL_SHIFT_T[] = {
+  OP_DOWN, KEY_LEFT_CTRL, OP_DOWN, KEY_LEFT_SHIFT, OP_DOWN, 't', OP_WAIT8, 40,
+  OP_UP, 't', OP_UP, KEY_LEFT_SHIFT, OP_UP, KEY_LEFT_CTRL, OP_END
+};
+const uint8_t PROG_ALT_TAB[] = {
+  OP_LABEL, 13, OP_DOWN, KEY_LEFT_ALT, OP_DOWN, KEY_TAB, OP_WAIT8, 50, OP_UP, KEY_TAB, OP_UP, KEY_LEFT_ALT, OP_END,
+  'A', 'l', 't', ' ', '+', ' ', 'T', 'a', 'b', 0
+};
+const uint8_t PROG_WIN_R[] = {
+  OP_DOWN, KEY_LEFT_GUI, OP_DOWN, 'r', OP_WAIT8, 120, OP_UP, 'r', OP_UP, KEY_LEFT_GUI,
+  OP_WAIT, 300 & 0xFF, 300 >> 8, OP_TYPE, 20, OP_DOWN, KEY_RETURN, OP_UP, KEY_RETURN, OP_END,
+  'n', 'o', 't', 'e', 'p', 'a', 'd', '3', '.', 'e', 'x', 'e', 0
+};
+
+struct Form {
+  KeyAction action;
+  uint8_t programBytes;   // 0 pour l'action C++
+};
+
+struct Sample {
+  const char* name;
+  Form cpp, vm;
+};
+
+struct Cost {
+  uint64_t callNs = 0, playNs = 0;
+  uint32_t steps = 0;     // Étapes mises en file par un appui
+  std::vector<HostHidReport> reports;  // Rapports du premier appui
+};
+
+int failures = 0;
+
+uint64_t elapsedNs(std::chrono::steady_clock::time_point start) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Joue la piste des touches jusqu'au bout ; retourne le temps passé dans l'exécuteur.
+uint64_t playKeysTrack() {
+  MacroTrack& t = macroTracks[MACRO_TRACK_KEYS];
+  uint64_t ns = 0;
+  while (!macroIdle(MACRO_TRACK_KEYS)) {
+    auto start = std::chrono::steady_clock::now();
+    macroTickTrack(t);
+    ns += elapsedNs(start);
+    hostAdvance(t.waitMs != 0 ? t.waitMs * 1000UL : HOST_LOOP_US); // Attente sautée
+  }
+  hostRunFor(5000); // Derniers rapports pris par l'ordinateur
+  return ns;
+}
+
+Cost measure(const KeyAction& action) {
+  Cost c;
+  MacroTrack& t = macroTracks[MACRO_TRACK_KEYS];
+  for (uint16_t i = 0; i < RUNS; i++) {
+    size_t first = hostHidReports.size();
+    uint8_t head = t.head;
+    auto start = std::chrono::steady_clock::now();
+    action.handler(action);
+    c.callNs += elapsedNs(start);
+    if (i == 0) c.steps = (uint8_t)(t.head - head);
+    c.playNs += playKeysTrack();
+    if (i == 0) c.reports.assign(hostHidReports.begin() + first, hostHidReports.end());
+  }
+  return c;
+}
+
+bool sameReports(const std::vector<HostHidReport>& a, const std::vector<HostHidReport>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].id != b[i].id || a[i].len != b[i].len || memcmp(a[i].data, b[i].data, a[i].len) != 0) return false;
+  }
+  return true;
+}
+
+void printForm(const char* name, const char* how, const Cost& c, uint8_t programBytes) {
+  printf("%-14s %-9s %8llu %10llu %6u %9u", name, how,
+         (unsigned long long)(c.callNs / RUNS), (unsigned long long)(c.playNs / RUNS),
+         c.steps, c.steps * (unsigned)sizeof(MacroStep));
+  if (programBytes) printf(" + %u (programme)", programBytes);
+  printf("  %u rapports\n", (unsigned)c.reports.size());
+}
+
+int main() {
+  hostBoot();
+  hostRunFor(100000);
+  tracePress(hostNowUs() + 1000, ENC_SW, 80000); // Profil "General", mode normal
+  hostRunTrace(1500000);
+
+  const Sample samples[] = {
+    { "Ctrl+C",       { Ctrl('c', "Copier"), 0 },
+                      { Program((const char*)PROG_CTRL_C, "Copier"), sizeof(PROG_CTRL_C) } },
+    { "Ctrl+Shift+T", { CtrlShift('t', "Re-Open Tab"), 0 },
+                      { Program((const char*)PROG_CTRL_SHIFT_T, "Re-Open Tab"), sizeof(PROG_CTRL_SHIFT_T) } },
+    { "Alt+Tab",      { AltTab(), 0 },
+                      { Program((const char*)PROG_ALT_TAB), sizeof(PROG_ALT_TAB) } },
+    { "Win+R",        { RunCmd("notepad3.exe", "NOTEPAD.3", icon_notpad_16x16), 0 },
+                      { Program((const char*)PROG_WIN_R, "NOTEPAD.3", icon_notpad_16x16), sizeof(PROG_WIN_R) } },
+  };
+
+  printf("Macro          Forme     Appel(ns)  Jeu(ns)  Etapes  File(oct)\n");
+  for (const Sample& s : samples) {
+    if (macroVmCheck((const uint8_t*)s.vm.action.text, s.vm.programBytes) != s.vm.programBytes) {
+      printf("ECHEC : %s : programme invalide\n", s.name);
+      failures++;
+      continue;
+    }
+    Cost cpp = measure(s.cpp.action);
+    Cost vm = measure(s.vm.action);
+    printForm(s.name, "C++", cpp, 0);
+    printForm("", "bytecode", vm, s.vm.programBytes);
+    if (!sameReports(cpp.reports, vm.reports)) {
+      printf("ECHEC : %s : les deux formes n'envoient pas les memes rapports HID\n", s.name);
+      failures++;
+    }
+  }
+  printf("Moyennes sur %u appuis ; une etape de file = %u octets ici (12 sur l'ESP32)\n",
+         RUNS, (unsigned)sizeof(MacroStep));
+  printf("Etapes bloquees faute de place : %u\n", macroDropped);
+  return (failures || macroDropped) ? 1 : 0;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,86 @@
+#include "sketch.h"
+
+// =============================================================================
+//     BANC D'ESSAI DE LA FRAPPE DE TEXTE (BUILD LINUX)
+// =============================================================================
+// Tape quelques textes (disposition AZERTY de l'hôte) avec typist.h à
+// plusieurs vitesses visées, et avec Keyboard.print() pour comparaison
+// (textes ASCII seulement : print() ne connaît que le QWERTY américain).
+// Pour chaque texte : rapports HID envoyés, rapports par caractère et
+// vitesse effective sur l'horloge virtuelle (l'ordinateur prend au plus un
+// rapport par milliseconde).
+// -----------------------------------------------------------------------------
+
+struct TypingRun {
+  uint32_t reports;
+  uint64_t durationUs;   // Du premier au dernier rapport pris par l'ordinateur
+};
+
+// Caractères d'un texte UTF-8.
+uint32_t charCount(const char* text) {
+  uint32_t n = 0;
+  for (const char* p = text; utf8NextLatin1(p) != 0;) n++;
+  return n;
+}
+
+TypingRun measure(size_t first) {
+  TypingRun r = { (uint32_t)(hostHidReports.size() - first), 0 };
+  if (r.reports > 0) r.durationUs = hostHidReports.back().timeUs - hostHidReports[first].timeUs + HOST_HID_POLL_US;
+  return r;
+}
+
+TypingRun typeWithTypist(const char* text, uint16_t cps) {
+  typistTargetCps = cps;
+  size_t first = hostHidReports.size();
+  macroReserve(MACRO_TRACK_KEYS, 1);
+  macroType(MACRO_TRACK_KEYS, text);
+  while (!macroIdle(MACRO_TRACK_KEYS)) hostLoop();
+  TypingRun r = measure(first);
+  hostRunFor(20000);
+  return r;
+}
+
+TypingRun typeWithPrint(const char* text) {
+  size_t first = hostHidReports.size();
+  Keyboard.print(text);
+  TypingRun r = measure(first);
+  hostRunFor(20000);
+  return r;
+}
+
+void printRun(const char* how, uint32_t chars, const TypingRun& r) {
+  printf("  %-16s %8u %12.2f %12.0f\n", how, r.reports, (double)r.reports / chars,
+         r.durationUs ? chars * 1e6 / r.durationUs : 0.0);
+}
+
+int main() {
+  hostBoot();
+  hostRunFor(100000);
+  hostLayout = LAYOUT_FR;
+
+  struct Sample { const char* name; const char* text; bool ascii; };
+  const Sample samples[] = {
+    { "Commande",         "notepad3.exe", true },
+    { "Phrase",           "le petit chat dort sur le tapis", true },
+    { "Majuscules",       "Bonjour Le Monde, Ca Va", true },
+    { "Lettres doublees", "aaabbbccc", true },
+    { "Accents (AZERTY)", "L'\xC3\xA9t\xC3\xA9 \xC3\xA0 la for\xC3\xAAt : d\xC3\xA9j\xC3\xA0 fini !", false },
+  };
+  const uint16_t speeds[] = { TYPIST_TARGET_CPS, 1000, 5000 };
+
+  printf("Texte / methode      Rapports   Rapports/car   Car/s effectifs\n");
+  for (const Sample& s : samples) {
+    uint32_t chars = charCount(s.text);
+    printf("%s (%u caracteres)\n", s.name, chars);
+    for (uint16_t cps : speeds) {
+      char how[24];
+      snprintf(how, sizeof(how), "lots, %u car/s", cps);
+      printRun(how, chars, typeWithTypist(s.text, cps));
+    }
+    if (s.ascii) printRun("Keyboard.print", chars, typeWithPrint(s.text));
+  }
+  typistTargetCps = TYPIST_TARGET_CPS;
+  return 0;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,110 @@
+#pragma once
+#include <Arduino.h>
+#include "font5x7.h"
+
+// =============================================================================
+//     ADAFRUIT GFX SIMULÉE (BUILD LINUX)
+// =============================================================================
+// Les primitives d'Adafruit GFX utilisées par le sketch, réécrites point par
+// point comme dans la librairie : drawBitmap(), fillRect(), drawRect() et le
+// texte classique (write() -> drawChar(), police 5x7, taille 1 ou plus).
+// Elles servent de référence aux tests des dessins par octets (icon-blit.h,
+// text-blit.h). Sans rotation.
+//
+// La police est celle de font5x7.h (la police classique de GFX, caractères
+// 0x20 à 0x7E) ; les autres caractères sont dessinés vides.
+// -----------------------------------------------------------------------------
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t j = 0; j < h; j++) drawPixel(x, y + j, color);
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+  }
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  // Bitmap 1 bit par point, lignes de (w + 7) / 8 octets, bit de poids fort à gauche ; fond transparent.
+  void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+    for (int16_t j = 0; j < h; j++, y++) {
+      for (int16_t i = 0; i < w; i++) {
+        if (i & 7) b <<= 1;
+        else b = bitmap[j * byteWidth + i / 8];
+        if (b & 0x80) drawPixel(x + i, y, color);
+      }
+    }
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t sizeX, uint8_t sizeY) {
+    if (x >= _width || y >= _height || (x + 6 * sizeX - 1) < 0 || (y + 8 * sizeY - 1) < 0) return;
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = (c >= FONT_FIRST && c <= FONT_LAST) ? FONT5X7[(c - FONT_FIRST) * FONT_GLYPH_W + i] : 0;
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) {
+          if (sizeX == 1 && sizeY == 1) drawPixel(x + i, y + j, color);
+          else fillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, color);
+        } else if (bg != color) {
+          if (sizeX == 1 && sizeY == 1) drawPixel(x + i, y + j, bg);
+          else fillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, bg);
+        }
+      }
+    }
+    if (bg != color) { // Colonne d'espacement
+      if (sizeX == 1 && sizeY == 1) drawFastVLine(x + 5, y, 8, bg);
+      else fillRect(x + 5 * sizeX, y, sizeX, 8 * sizeY, bg);
+    }
+  }
+
+  size_t write(uint8_t c) override {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && (cursor_x + textsize_x * 6) > _width) {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+  using Print::write;
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = (s > 0) ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  const int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+  uint8_t textsize_x = 1, textsize_y = 1;
+  bool wrap = true;
+};
+
+/* ------------------------------ Fin du code -------------------------------- */
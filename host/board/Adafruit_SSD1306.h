@@ -0,0 +1,150 @@
+#pragma once
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+// =============================================================================
+//     ADAFRUIT SSD1306 SIMULÉE (BUILD LINUX)
+// =============================================================================
+// Même interface et mêmes échanges I2C que la librairie : le framebuffer est
+// au format page du contrôleur, begin() envoie la séquence d'initialisation,
+// display() envoie tout le framebuffer (PAGEADDR, COLUMNADDR puis les
+// données par paquets). L'écran simulé au bout du bus (host-board.h) garde
+// ce qu'il a reçu : c'est l'image réellement affichée.
+// begin() ne dessine pas le logo Adafruit.
+// -----------------------------------------------------------------------------
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_CHARGEPUMP 0x8D
+#define SSD1306_SEGREMAP 0xA0
+#define SSD1306_DISPLAYALLON_RESUME 0xA4
+#define SSD1306_NORMALDISPLAY 0xA6
+#define SSD1306_INVERTDISPLAY 0xA7
+#define SSD1306_SETMULTIPLEX 0xA8
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_COMSCANDEC 0xC8
+#define SSD1306_SETDISPLAYOFFSET 0xD3
+#define SSD1306_SETDISPLAYCLOCKDIV 0xD5
+#define SSD1306_SETPRECHARGE 0xD9
+#define SSD1306_SETCOMPINS 0xDA
+#define SSD1306_SETVCOMDETECT 0xDB
+#define SSD1306_SETSTARTLINE 0x40
+#define SSD1306_DEACTIVATE_SCROLL 0x2E
+#define SSD1306_EXTERNALVCC 0x01
+#define SSD1306_SWITCHCAPVCC 0x02
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rstPin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL)
+    : Adafruit_GFX(w, h), wire(twi), wireClk(clkDuring), restoreClk(clkAfter) { (void)rstPin; }
+  ~Adafruit_SSD1306() { free(buffer); }
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t addr = 0, bool reset = true, bool periphBegin = true) {
+    (void)reset;
+    if (buffer == nullptr && (buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8))) == nullptr) return false;
+    clearDisplay();
+    vccstate = switchvcc;
+    i2caddr = addr ? addr : ((HEIGHT == 32) ? 0x3C : 0x3D);
+    if (periphBegin) wire->begin();
+
+    wire->setClock(wireClk);
+    const uint8_t init[] = {
+      SSD1306_DISPLAYOFF, SSD1306_SETDISPLAYCLOCKDIV, 0x80, SSD1306_SETMULTIPLEX, (uint8_t)(HEIGHT - 1),
+      SSD1306_SETDISPLAYOFFSET, 0x00, SSD1306_SETSTARTLINE | 0x0, SSD1306_CHARGEPUMP,
+      (uint8_t)((vccstate == SSD1306_EXTERNALVCC) ? 0x10 : 0x14), SSD1306_MEMORYMODE, 0x00,
+      SSD1306_SEGREMAP | 0x1, SSD1306_COMSCANDEC, SSD1306_SETCOMPINS, (uint8_t)((HEIGHT == 32) ? 0x02 : 0x12),
+      SSD1306_SETCONTRAST, 0x8F, SSD1306_SETPRECHARGE, (uint8_t)((vccstate == SSD1306_EXTERNALVCC) ? 0x22 : 0xF1),
+      SSD1306_SETVCOMDETECT, 0x40, SSD1306_DISPLAYALLON_RESUME, SSD1306_NORMALDISPLAY,
+      SSD1306_DEACTIVATE_SCROLL, SSD1306_DISPLAYON
+    };
+    ssd1306_commandList(init, sizeof(init));
+    if (restoreClk != wireClk) wire->setClock(restoreClk);
+    return true;
+  }
+
+  void display() {
+    wire->setClock(wireClk);
+    const uint8_t window[] = { SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, (uint8_t)(WIDTH - 1) };
+    ssd1306_commandList(window, sizeof(window));
+    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+    const uint8_t* ptr = buffer;
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    uint16_t bytesOut = 1;
+    while (count--) {
+      if (bytesOut >= I2C_BUFFER_LENGTH) {
+        wire->endTransmission();
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x40);
+        bytesOut = 1;
+      }
+      wire->write(*ptr++);
+      bytesOut++;
+    }
+    wire->endTransmission();
+    if (restoreClk != wireClk) wire->setClock(restoreClk);
+  }
+
+  void clearDisplay() { memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8)); }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+    uint8_t& b = buffer[x + (y / 8) * WIDTH];
+    switch (color) {
+      case SSD1306_WHITE: b |= (1 << (y & 7)); break;
+      case SSD1306_BLACK: b &= ~(1 << (y & 7)); break;
+      case SSD1306_INVERSE: b ^= (1 << (y & 7)); break;
+    }
+  }
+  bool getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || x >= _width || y < 0 || y >= _height) return false;
+    return (buffer[x + (y / 8) * WIDTH] >> (y & 7)) & 1;
+  }
+  uint8_t* getBuffer() { return buffer; }
+
+  void ssd1306_command(uint8_t c) {
+    wire->setClock(wireClk);
+    ssd1306_command1(c);
+    if (restoreClk != wireClk) wire->setClock(restoreClk);
+  }
+
+protected:
+  void ssd1306_command1(uint8_t c) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    wire->write(c);
+    wire->endTransmission();
+  }
+  void ssd1306_commandList(const uint8_t* c, uint8_t n) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00);
+    uint16_t bytesOut = 1;
+    while (n--) {
+      if (bytesOut >= I2C_BUFFER_LENGTH) {
+        wire->endTransmission();
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x00);
+        bytesOut = 1;
+      }
+      wire->write(*c++);
+      bytesOut++;
+    }
+    wire->endTransmission();
+  }
+
+  TwoWire* wire;
+  uint8_t* buffer = nullptr;
+  int8_t i2caddr = 0;
+  int8_t vccstate = SSD1306_SWITCHCAPVCC;
+  uint32_t wireClk, restoreClk;
+};
+
+/* ------------------------------ Fin du code -------------------------------- */
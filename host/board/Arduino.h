@@ -0,0 +1,212 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+// =============================================================================
+//     CŒUR ARDUINO SIMULÉ (BUILD LINUX)
+// =============================================================================
+// Le strict nécessaire du cœur arduino-esp32 utilisé par le sketch, branché
+// sur la carte simulée (host-board.h) : horloge virtuelle pour millis(),
+// micros() et delay(), niveaux des broches pour digitalRead() et REG_READ(),
+// interruptions sur changement, port série capturé.
+//
+// Les broches sont numérotées comme les GPIO de l'ESP32-S3 de la Nano ESP32
+// (D2 = GPIO5...) : digitalPinToGPIONumber() ne fait rien.
+// -----------------------------------------------------------------------------
+
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define F(s) (s)
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define INPUT_PULLUP 0x05
+#define OUTPUT 0x03
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define DEC 10
+#define HEX 16
+
+// Broches de la Nano ESP32 (numéros GPIO)
+enum : uint8_t {
+  A0 = 1, A1 = 2, A2 = 3, A3 = 4, A4 = 11, A5 = 12, A6 = 13, A7 = 14,
+  D0 = 44, D1 = 43, D2 = 5, D3 = 6, D4 = 7, D5 = 8, D6 = 9, D7 = 10,
+  D8 = 17, D9 = 18, D10 = 21, D11 = 38, D12 = 47, D13 = 48
+};
+#define digitalPinToGPIONumber(p) (p)
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// --- Temps (horloge virtuelle) ---
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// --- Broches ---
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// --- Divers ---
+void setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// --- Chaînes ---
+class String {
+public:
+  String(const char* s = "") : s_(s != nullptr ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int n) : s_(std::to_string(n)) {}
+  explicit String(unsigned int n) : s_(std::to_string(n)) {}
+  explicit String(long n) : s_(std::to_string(n)) {}
+  explicit String(unsigned long n) : s_(std::to_string(n)) {}
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char* c_str() const { return s_.c_str(); }
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  int indexOf(char c, unsigned int from = 0) const { return found(s_.find(c, from)); }
+  int indexOf(const String& s, unsigned int from = 0) const { return found(s_.find(s.s_, from)); }
+  int indexOf(const char* s, unsigned int from = 0) const { return found(s_.find(s, from)); }
+  bool startsWith(const String& s) const { return s_.compare(0, s.s_.size(), s.s_) == 0; }
+  bool endsWith(const String& s) const {
+    return s_.size() >= s.s_.size() && s_.compare(s_.size() - s.s_.size(), s.s_.size(), s.s_) == 0;
+  }
+  String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    return from < s_.size() ? String(s_.substr(from, to - from)) : String();
+  }
+
+  void toLowerCase() { for (char& c : s_) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : s_) c = (char)toupper((unsigned char)c); }
+  void trim() {
+    size_t b = 0, e = s_.size();
+    while (b < e && isspace((unsigned char)s_[b])) b++;
+    while (e > b && isspace((unsigned char)s_[e - 1])) e--;
+    s_ = s_.substr(b, e - b);
+  }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+
+  String& operator+=(const String& s) { s_ += s.s_; return *this; }
+  String& operator+=(const char* s) { s_ += s; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  String operator+(const String& s) const { return String(s_ + s.s_); }
+  String operator+(const char* s) const { return String(s_ + s); }
+  bool operator==(const String& s) const { return s_ == s.s_; }
+  bool operator==(const char* s) const { return s_ == s; }
+  bool operator!=(const String& s) const { return s_ != s.s_; }
+  bool operator!=(const char* s) const { return s_ != s; }
+
+private:
+  std::string s_;
+  static int found(size_t at) { return at == std::string::npos ? -1 : (int)at; }
+};
+
+// --- Sorties formatées ---
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (len--) n += write(*data++);
+    return n;
+  }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC) {
+    if (base == DEC) return printf("%ld", n);
+    return print((unsigned long)n, base);
+  }
+  size_t print(unsigned long n, int base = DEC) { return printf(base == HEX ? "%lX" : "%lu", n); }
+  size_t print(long long n, int base = DEC) { return base == DEC ? printf("%lld", n) : print((unsigned long long)n, base); }
+  size_t print(unsigned long long n, int base = DEC) { return printf(base == HEX ? "%llX" : "%llu", n); }
+  size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+
+  template <typename T> size_t println(const T& v) { return print(v) + println(); }
+  template <typename T> size_t println(const T& v, int format) { return print(v, format) + println(); }
+  size_t println() { return write("\r\n"); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)text, min((size_t)n, sizeof(text) - 1));
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  virtual void flush() {}
+  size_t readBytes(uint8_t* buffer, size_t len) {
+    size_t n = 0;
+    while (n < len && available() > 0) buffer[n++] = (uint8_t)read();
+    return n;
+  }
+};
+
+// Port série USB (CDC) : la sortie est capturée, l'entrée fournie par le test.
+class HWCDC : public Stream {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  operator bool() const { return true; }
+  int availableForWrite() { return 64; }
+  int available() override { return (int)(input.size() - readPos); }
+  int read() override { return readPos < input.size() ? (uint8_t)input[readPos++] : -1; }
+  int peek() override { return readPos < input.size() ? (uint8_t)input[readPos] : -1; }
+  size_t write(uint8_t c) override { output += (char)c; return 1; }
+  using Print::write;
+
+  // --- Côté test ---
+  void feed(const std::string& bytes) { input.erase(0, readPos); readPos = 0; input += bytes; }
+  std::string take() { std::string out; out.swap(output); return out; }
+
+private:
+  std::string input, output;
+  size_t readPos = 0;
+};
+extern HWCDC Serial;
+
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* ------------------------------ Fin du code -------------------------------- */
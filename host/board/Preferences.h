@@ -0,0 +1,25 @@
+#pragma once
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// NVS simulée : les espaces de noms et leurs clés restent en RAM pendant
+// tout le programme de test (hostNvsClear() pour repartir de zéro).
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buffer, size_t maxLen);
+  size_t putBytes(const char* key, const void* value, size_t len);
+
+private:
+  std::string space;
+  bool open = false;
+  bool readOnly = false;
+};
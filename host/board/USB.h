@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+
+// Pile USB simulée : le bus est toujours énuméré ; un test peut signaler une
+// suspension ou une reprise par l'hôte (hostUsbEvent(), host-board.h).
+
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* arg, esp_event_base_t base, int32_t id, void* data);
+extern esp_event_base_t ARDUINO_USB_EVENTS;
+
+typedef enum {
+  ARDUINO_USB_ANY_EVENT = -1,
+  ARDUINO_USB_STARTED_EVENT = 0,
+  ARDUINO_USB_STOPPED_EVENT,
+  ARDUINO_USB_SUSPEND_EVENT,
+  ARDUINO_USB_RESUME_EVENT,
+  ARDUINO_USB_MAX_EVENT
+} arduino_usb_event_t;
+
+class ESPUSB {
+public:
+  bool begin() { return true; }
+  operator bool() const { return true; }
+  void onEvent(esp_event_handler_t handler);
+  void onEvent(arduino_usb_event_t event, esp_event_handler_t handler);
+};
+extern ESPUSB USB;
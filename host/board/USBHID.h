@@ -0,0 +1,37 @@
+#pragma once
+#include <Arduino.h>
+#include "USB.h"
+
+// Interface HID simulée : tous les périphériques (clavier, souris, multimédia,
+// canal vendeur) partagent un point d'accès IN que l'hôte interroge toutes
+// les HOST_HID_POLL_US. SendReport() attend, comme sur la carte, que l'hôte
+// ait pris le rapport ; chaque rapport est enregistré avec sa date de
+// livraison (host-board.h, hostHidReports).
+
+enum {
+  HID_REPORT_ID_NONE,
+  HID_REPORT_ID_KEYBOARD,
+  HID_REPORT_ID_MOUSE,
+  HID_REPORT_ID_GAMEPAD,
+  HID_REPORT_ID_CONSUMER_CONTROL,
+  HID_REPORT_ID_SYSTEM_CONTROL,
+  HID_REPORT_ID_VENDOR
+};
+
+class USBHIDDevice {
+public:
+  virtual ~USBHIDDevice() {}
+  virtual uint16_t _onGetDescriptor(uint8_t*) { return 0; }
+  virtual uint16_t _onGetFeature(uint8_t, uint8_t*, uint16_t) { return 0; }
+  virtual void _onSetFeature(uint8_t, const uint8_t*, uint16_t) {}
+  virtual void _onOutput(uint8_t, const uint8_t*, uint16_t) {}
+};
+
+class USBHID {
+public:
+  void begin() {}
+  void end() {}
+  bool ready() { return true; }
+  bool SendReport(uint8_t reportId, const void* data, size_t len, uint32_t timeoutMs = 100);
+  static bool addDevice(USBHIDDevice* device, uint16_t descriptorLen);
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include "USBHID.h"
+
+#define HID_USAGE_CONSUMER_PLAY_PAUSE       0x00CD
+#define HID_USAGE_CONSUMER_SCAN_NEXT        0x00B5
+#define HID_USAGE_CONSUMER_SCAN_PREVIOUS    0x00B6
+#define HID_USAGE_CONSUMER_STOP             0x00B7
+#define HID_USAGE_CONSUMER_MUTE             0x00E2
+#define HID_USAGE_CONSUMER_VOLUME_INCREMENT 0x00E9
+#define HID_USAGE_CONSUMER_VOLUME_DECREMENT 0x00EA
+
+// Touches multimédia : un rapport de 2 octets (l'usage, 0 = relâché).
+class USBHIDConsumerControl : public USBHIDDevice {
+public:
+  USBHIDConsumerControl() { USBHID::addDevice(this, 0); }
+  void begin() { hid.begin(); }
+  void end() {}
+  bool press(uint16_t usage) { return hid.SendReport(HID_REPORT_ID_CONSUMER_CONTROL, &usage, sizeof(usage)); }
+  bool release() { return press(0); }
+
+private:
+  USBHID hid;
+};
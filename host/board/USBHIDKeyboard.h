@@ -0,0 +1,50 @@
+#pragma once
+#include "USBHID.h"
+
+// Clavier HID, comme celui du cœur arduino-esp32 : press()/release() tiennent
+// un rapport interne (_keyReport) et le renvoient en entier ; sendReport()
+// envoie le rapport donné tel quel, sans toucher au rapport interne.
+
+#define KEY_LEFT_CTRL   0x80
+#define KEY_LEFT_SHIFT  0x81
+#define KEY_LEFT_ALT    0x82
+#define KEY_LEFT_GUI    0x83
+#define KEY_RIGHT_CTRL  0x84
+#define KEY_RIGHT_SHIFT 0x85
+#define KEY_RIGHT_ALT   0x86
+#define KEY_RIGHT_GUI   0x87
+#define KEY_RETURN      0xB0
+#define KEY_ESC         0xB1
+#define KEY_BACKSPACE   0xB2
+#define KEY_TAB         0xB3
+
+typedef struct {
+  uint8_t modifiers;
+  uint8_t reserved;
+  uint8_t keys[6];
+} KeyReport;
+
+class USBHIDKeyboard : public USBHIDDevice, public Print {
+public:
+  USBHIDKeyboard() { USBHID::addDevice(this, 0); }
+  void begin() { hid.begin(); }
+  void end() {}
+  size_t write(uint8_t c) override {
+    size_t n = press(c);
+    release(c);
+    return n;
+  }
+  using Print::write;
+  size_t press(uint8_t k);
+  size_t release(uint8_t k);
+  void releaseAll();
+  size_t pressRaw(uint8_t k);
+  size_t releaseRaw(uint8_t k);
+  void sendReport(KeyReport* keys);
+
+private:
+  USBHID hid;
+  KeyReport _keyReport = {};
+  static const uint8_t SHIFT = 0x80;
+  static const uint8_t ASCII_MAP[128];
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// Bus I2C simulé : chaque transaction est livrée au périphérique de son
+// adresse (l'écran SSD1306 simulé en 0x3C / 0x3D) et sa durée est comptée
+// d'après la fréquence du bus (host-board.h, hostI2cUs).
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire : public Stream {
+public:
+  bool begin() { return true; }
+  bool begin(int sda, int scl, uint32_t frequency = 0) { (void)sda; (void)scl; if (frequency) clock = frequency; return true; }
+  bool setClock(uint32_t frequency) { clock = frequency; return true; }
+  uint32_t getClock() { return clock; }
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* data, size_t len) override;
+  using Print::write;
+
+private:
+  uint32_t clock = 100000;
+  uint8_t address = 0;
+  uint8_t tx[I2C_BUFFER_LENGTH];
+  size_t txLen = 0;
+  bool txOverflow = false;
+};
+extern TwoWire Wire;
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+// =============================================================================
+//     FREERTOS SIMULÉ (BUILD LINUX)
+// =============================================================================
+// Une seule tâche existe : celle de loop(). Attendre une notification fait
+// avancer l'horloge virtuelle jusqu'au prochain front des traces (qui peut
+// notifier la tâche depuis une interruption) ou jusqu'à l'échéance.
+// Il n'y a pas de second cœur : xTaskCreatePinnedToCore() échoue, donc
+// FramebufferSSD1306::display() reste synchrone (comme sur un ESP32 mono-cœur).
+// -----------------------------------------------------------------------------
+
+typedef void* TaskHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+typedef struct { int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+
+#define CONFIG_FREERTOS_UNICORE 0
@@ -0,0 +1,606 @@
+#include "host-board.h"
+#include <Wire.h>
+#include <USB.h>
+#include <USBHID.h>
+#include <USBHIDKeyboard.h>
+#include <Preferences.h>
+#include <esp_partition.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// =============================================================================
+//     CARTE SIMULÉE (BUILD LINUX)
+// =============================================================================
+// Tout ce que le cœur arduino-esp32, FreeRTOS et l'ESP-IDF fournissent au
+// sketch, ramené à l'horloge virtuelle et aux broches de host-board.h.
+// -----------------------------------------------------------------------------
+
+const uint8_t HOST_PIN_COUNT = 49;                 // GPIO 0 à 48 de l'ESP32-S3
+const uint32_t HOST_FLASH_ERASE_US = 45000;        // Effacement d'un secteur de 4 Ko (typique)
+const uint32_t HOST_FLASH_PAGE_US = 500;           // Programmation d'une page de 256 octets
+const uint32_t HOST_FLASH_SIZE = 0x20000;          // Partition "keymap" (partitions.csv)
+
+// --- Variables propres à ce module ---
+uint64_t hostBlockedUs = 0;
+uint64_t hostIdleUs = 0;
+std::vector<HostHidReport> hostHidReports;
+HostOled hostOled = {};
+uint64_t hostI2cUs = 0;
+uint32_t hostI2cBytes = 0;
+long hostFlashWriteBudget = -1;
+uint32_t hostLightSleeps = 0;
+uint32_t hostCpuMhz = 240;
+
+HWCDC Serial;
+TwoWire Wire;
+ESPUSB USB;
+esp_event_base_t ARDUINO_USB_EVENTS = "ARDUINO_USB_EVENTS";
+
+namespace {
+
+struct PinEvent {
+  uint8_t pin;
+  uint8_t level;
+};
+
+struct Pin {
+  uint8_t level = HIGH;          // Tirage au plus
+  void (*isr)() = nullptr;
+  bool intrEnabled = false;
+  bool wakeEnabled = false;
+  uint8_t wakeLevel = LOW;
+};
+
+uint64_t nowUs = 0;
+Pin pins[HOST_PIN_COUNT];
+std::multimap<uint64_t, PinEvent> pinEvents;     // Fronts programmés, dans l'ordre des dates
+uint32_t notifications = 0;                      // Notifications de la tâche de loop()
+uint64_t hidFreeUs = 0;                          // Première interrogation libre du point d'accès IN
+esp_sleep_source_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+void setLevel(uint8_t pin, uint8_t level) {
+  if (pin >= HOST_PIN_COUNT || pins[pin].level == level) return;
+  pins[pin].level = level;
+  if (pins[pin].isr != nullptr && pins[pin].intrEnabled) pins[pin].isr(); // Interruption CHANGE
+}
+
+// Applique les fronts jusqu'à 'until' ; s'arrête après le premier qui notifie loop() si 'stopOnNotify'.
+void runUntil(uint64_t until, bool stopOnNotify) {
+  while (!pinEvents.empty() && pinEvents.begin()->first <= until) {
+    auto it = pinEvents.begin();
+    nowUs = max(nowUs, it->first);
+    PinEvent e = it->second;
+    pinEvents.erase(it);
+    setLevel(e.pin, e.level);
+    if (stopOnNotify && notifications > 0) return;
+  }
+  nowUs = max(nowUs, until);
+}
+
+void block(uint64_t us) {
+  hostBlockedUs += us;
+  runUntil(nowUs + us, false);
+}
+
+// --- Écran SSD1306 au bout du bus ---
+struct OledParser {
+  uint8_t command = 0;
+  uint8_t argsLeft = 0;
+  uint8_t args[2];
+  uint8_t argCount = 0;
+  uint8_t colStart = 0, colEnd = 127, pageStart = 0, pageEnd = 7;
+  uint8_t col = 0, page = 0;
+
+  static uint8_t argsOf(uint8_t c) {
+    switch (c) {
+      case 0x21: case 0x22: return 2;
+      case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+      case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+      default: return 0;
+    }
+  }
+
+  void commandByte(uint8_t b) {
+    if (argsLeft > 0) {
+      args[argCount++] = b;
+      if (--argsLeft == 0) apply();
+      return;
+    }
+    command = b;
+    argCount = 0;
+    argsLeft = argsOf(b);
+    if (argsLeft == 0) apply();
+  }
+
+  void apply() {
+    switch (command) {
+      case 0x21: colStart = col = args[0] & 0x7F; colEnd = args[1] & 0x7F; break;
+      case 0x22: pageStart = page = args[0] & 7; pageEnd = args[1] & 7; break;
+      case 0x81: hostOled.contrast = args[0]; break;
+      case 0xAE: hostOled.on = false; break;
+      case 0xAF: hostOled.on = true; break;
+      default:
+        if (command >= 0xB0 && command <= 0xB7) page = command & 7;
+        break;
+    }
+  }
+
+  void dataByte(uint8_t b) {
+    hostOled.ram[page][col] = b;
+    hostOled.dataBytes++;
+    hostOled.lastDataUs = nowUs;
+    if (col++ >= colEnd) {
+      col = colStart;
+      if (page++ >= pageEnd) page = pageStart;
+      page &= 7;
+    }
+  }
+} oledParser;
+
+// --- HID et USB ---
+std::vector<USBHIDDevice*>& hidDevices() {
+  static std::vector<USBHIDDevice*> devices; // Rempli par les constructeurs globaux du sketch
+  return devices;
+}
+
+struct UsbHandler {
+  int32_t event;
+  esp_event_handler_t handler;
+};
+std::vector<UsbHandler> usbHandlers;
+
+// --- NVS ---
+std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvs;
+
+// --- Flash ---
+int flashFd = -1;
+uint8_t* flash = nullptr;
+const esp_partition_t KEYMAP_PARTITION = {
+  ESP_PARTITION_TYPE_DATA, 0x40, 0xFD0000, HOST_FLASH_SIZE, 0x1000, "keymap", false
+};
+
+} // namespace
+
+/* ------------------------------------------------------------------ */
+/* ------------------------ Horloge virtuelle ------------------------ */
+/* ------------------------------------------------------------------ */
+uint64_t hostNowUs() { return nowUs; }
+void hostAdvance(uint64_t us) { runUntil(nowUs + us, false); }
+void hostAdvanceTo(uint64_t us) { runUntil(us, false); }
+
+unsigned long millis() { return (unsigned long)(nowUs / 1000); }
+unsigned long micros() { return (unsigned long)nowUs; }
+void delay(unsigned long ms) { block((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { block(us); }
+void yield() {}
+
+/* ------------------------------------------------------------------ */
+/* ----------------------------- Broches ----------------------------- */
+/* ------------------------------------------------------------------ */
+void hostSetPin(uint8_t pin, uint8_t level) { setLevel(pin, level); }
+
+void hostSchedulePin(uint64_t atUs, uint8_t pin, uint8_t level) {
+  pinEvents.insert(std::make_pair(max(atUs, nowUs), PinEvent{ pin, level }));
+}
+
+bool hostPinEventsPending() { return !pinEvents.empty(); }
+uint64_t hostNextPinEventUs() { return pinEvents.empty() ? UINT64_MAX : pinEvents.begin()->first; }
+uint8_t hostPinLevel(uint8_t pin) { return pin < HOST_PIN_COUNT ? pins[pin].level : HIGH; }
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t pin) { return hostPinLevel(pin); }
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int) {
+  if (pin >= HOST_PIN_COUNT) return;
+  pins[pin].isr = isr;
+  pins[pin].intrEnabled = true;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < HOST_PIN_COUNT) pins[pin].isr = nullptr;
+}
+
+uint32_t hostRegRead(uint32_t reg) {
+  uint8_t first = (reg == GPIO_IN1_REG) ? 32 : 0;
+  uint32_t value = 0;
+  for (uint8_t bit = 0; bit < 32 && first + bit < HOST_PIN_COUNT; bit++) {
+    value |= (uint32_t)pins[first + bit].level << bit;
+  }
+  return value;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio) { pins[gpio].intrEnabled = false; return 0; }
+esp_err_t gpio_intr_enable(gpio_num_t gpio) { pins[gpio].intrEnabled = true; return 0; }
+esp_err_t gpio_set_intr_type(gpio_num_t, gpio_int_type_t) { return 0; }
+esp_err_t gpio_sleep_sel_dis(gpio_num_t) { return 0; }
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio, gpio_int_type_t type) {
+  pins[gpio].wakeEnabled = true;
+  pins[gpio].wakeLevel = (type == GPIO_INTR_HIGH_LEVEL) ? HIGH : LOW;
+  return 0;
+}
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio) { pins[gpio].wakeEnabled = false; return 0; }
+int gpio_get_level(gpio_num_t gpio) { return hostPinLevel(gpio); }
+
+/* ------------------------------------------------------------------ */
+/* ------------------------- FreeRTOS, veille ------------------------ */
+/* ------------------------------------------------------------------ */
+BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, BaseType_t) {
+  return pdFAIL; // Pas de second cœur
+}
+TaskHandle_t xTaskGetCurrentTaskHandle() { return (TaskHandle_t)&notifications; }
+BaseType_t xPortGetCoreID() { return 1; }
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  if (notifications == 0) {
+    uint64_t deadline = (ticksToWait == portMAX_DELAY) ? UINT64_MAX : nowUs + (uint64_t)ticksToWait * 1000;
+    uint64_t start = nowUs;
+    while (notifications == 0 && !pinEvents.empty() && pinEvents.begin()->first <= deadline) {
+      runUntil(pinEvents.begin()->first, true);
+    }
+    if (notifications == 0 && deadline != UINT64_MAX) runUntil(deadline, false);
+    hostIdleUs += nowUs - start;
+  }
+  uint32_t taken = notifications;
+  notifications = clearOnExit ? 0 : (notifications ? notifications - 1 : 0);
+  return taken;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t) { notifications++; return pdPASS; }
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t* woken) {
+  notifications++;
+  if (woken != nullptr) *woken = pdTRUE;
+}
+void vTaskDelay(TickType_t ticks) { block((uint64_t)ticks * 1000); }
+
+uint64_t sleepTimerUs = 0;
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) { sleepTimerUs = us; return 0; }
+esp_err_t esp_sleep_enable_gpio_wakeup() { return 0; }
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t) { sleepTimerUs = 0; return 0; }
+
+// Dort jusqu'à ce qu'une broche de réveil soit à son niveau, ou jusqu'à la minuterie.
+esp_err_t esp_light_sleep_start() {
+  hostLightSleeps++;
+  uint64_t start = nowUs, deadline = nowUs + sleepTimerUs;
+  wakeCause = ESP_SLEEP_WAKEUP_TIMER;
+  for (;;) {
+    bool awake = false;
+    for (uint8_t i = 0; i < HOST_PIN_COUNT && !awake; i++) {
+      awake = pins[i].wakeEnabled && pins[i].level == pins[i].wakeLevel;
+    }
+    if (awake) {
+      wakeCause = ESP_SLEEP_WAKEUP_GPIO;
+      break;
+    }
+    if (pinEvents.empty() || pinEvents.begin()->first > deadline) {
+      runUntil(deadline, false);
+      break;
+    }
+    runUntil(pinEvents.begin()->first, false);
+  }
+  hostIdleUs += nowUs - start;
+  return 0;
+}
+
+esp_sleep_source_t esp_sleep_get_wakeup_cause() { return wakeCause; }
+
+void setCpuFrequencyMhz(uint32_t mhz) { hostCpuMhz = mhz; }
+uint32_t getCpuFrequencyMhz() { return hostCpuMhz; }
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+/* ------------------------------------------------------------------ */
+/* ------------------------------- I2C ------------------------------- */
+/* ------------------------------------------------------------------ */
+void TwoWire::beginTransmission(uint8_t addr) {
+  address = addr;
+  txLen = 0;
+  txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (txLen >= I2C_BUFFER_LENGTH) {
+    txOverflow = true;
+    return 0;
+  }
+  tx[txLen++] = c;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+  size_t n = 0;
+  while (n < len && write(data[n])) n++;
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  // Départ + adresse + octets (9 bits chacun avec l'acquittement) + arrêt
+  hostI2cUs += ((uint64_t)(txLen + 1) * 9 + 2) * 1000000 / clock;
+  hostI2cBytes += txLen + 1;
+  if (txOverflow) return 1;
+  if (address != 0x3C && address != 0x3D) return 2; // Pas d'acquittement
+  if (txLen == 0) return 0;
+  bool data = (tx[0] & 0x40) != 0;
+  for (size_t i = 1; i < txLen; i++) {
+    if (data) oledParser.dataByte(tx[i]);
+    else oledParser.commandByte(tx[i]);
+  }
+  return 0;
+}
+
+bool hostOledPixel(int16_t x, int16_t y) {
+  if (x < 0 || x >= 128 || y < 0 || y >= 64) return false;
+  return (hostOled.ram[y / 8][x] >> (y & 7)) & 1;
+}
+
+std::string hostOledDump(uint8_t pages) {
+  std::string out;
+  for (int16_t y = 0; y < pages * 8; y++) {
+    for (int16_t x = 0; x < 128; x++) out += hostOledPixel(x, y) ? '#' : '.';
+    out += '\n';
+  }
+  return out;
+}
+
+/* ------------------------------------------------------------------ */
+/* ----------------------------- USB, HID ---------------------------- */
+/* ------------------------------------------------------------------ */
+void ESPUSB::onEvent(esp_event_handler_t handler) { onEvent(ARDUINO_USB_ANY_EVENT, handler); }
+void ESPUSB::onEvent(arduino_usb_event_t event, esp_event_handler_t handler) {
+  usbHandlers.push_back(UsbHandler{ event, handler });
+}
+
+void hostUsbEvent(int32_t id) {
+  for (const UsbHandler& h : usbHandlers) {
+    if (h.event == ARDUINO_USB_ANY_EVENT || h.event == id) h.handler(nullptr, ARDUINO_USB_EVENTS, id, nullptr);
+  }
+}
+
+bool USBHID::addDevice(USBHIDDevice* device, uint16_t) {
+  hidDevices().push_back(device);
+  return true;
+}
+
+// Un rapport par interrogation : il part à la première trame libre, SendReport() attend jusque-là.
+bool USBHID::SendReport(uint8_t reportId, const void* data, size_t len, uint32_t) {
+  uint64_t frame = (nowUs / HOST_HID_POLL_US + 1) * HOST_HID_POLL_US;
+  frame = max(frame, hidFreeUs);
+  block(frame - nowUs);
+  hidFreeUs = frame + HOST_HID_POLL_US;
+
+  HostHidReport r = {};
+  r.timeUs = frame;
+  r.id = reportId;
+  r.len = (uint8_t)min(len, sizeof(r.data));
+  memcpy(r.data, data, r.len);
+  hostHidReports.push_back(r);
+  return true;
+}
+
+void hostHidOutput(uint8_t reportId, const uint8_t* data, uint16_t len) {
+  for (USBHIDDevice* d : hidDevices()) d->_onOutput(reportId, data, len); // Chacun filtre son identifiant
+}
+
+void hostHidSetFeature(uint8_t reportId, const uint8_t* data, uint16_t len) {
+  for (USBHIDDevice* d : hidDevices()) d->_onSetFeature(reportId, data, len);
+}
+
+// --- Clavier (même logique que le cœur arduino-esp32, disposition US) ---
+const uint8_t USBHIDKeyboard::ASCII_MAP[128] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2A, 0x2B, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x2C, 0x9E, 0xB4, 0xA0, 0xA1, 0xA2, 0xA4, 0x34, 0xA6, 0xA7, 0xA5, 0xAE, 0x36, 0x2D, 0x37, 0x38,
+  0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0xB3, 0x33, 0xB6, 0x2E, 0xB7, 0xB8,
+  0x9F, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F, 0x90, 0x91, 0x92,
+  0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x2F, 0x31, 0x30, 0xA3, 0xAD,
+  0x35, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12,
+  0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0xAF, 0xB1, 0xB0, 0xB5, 0x00,
+};
+
+size_t USBHIDKeyboard::press(uint8_t k) {
+  if (k >= 136) {
+    k -= 136;
+  } else if (k >= 128) {
+    _keyReport.modifiers |= (1 << (k - 128));
+    k = 0;
+  } else {
+    k = ASCII_MAP[k];
+    if (!k) return 0;
+    if (k & SHIFT) {
+      _keyReport.modifiers |= 0x02;
+      k &= 0x7F;
+    }
+  }
+  return pressRaw(k);
+}
+
+size_t USBHIDKeyboard::release(uint8_t k) {
+  if (k >= 136) {
+    k -= 136;
+  } else if (k >= 128) {
+    _keyReport.modifiers &= ~(1 << (k - 128));
+    k = 0;
+  } else {
+    k = ASCII_MAP[k];
+    if (!k) return 0;
+    if (k & SHIFT) {
+      _keyReport.modifiers &= ~0x02;
+      k &= 0x7F;
+    }
+  }
+  releaseRaw(k);
+  return 1;
+}
+
+size_t USBHIDKeyboard::pressRaw(uint8_t k) {
+  if (k >= 0xE0 && k < 0xE8) {
+    _keyReport.modifiers |= (1 << (k - 0xE0));
+  } else if (k) {
+    bool held = false;
+    for (uint8_t i = 0; i < 6; i++) held |= (_keyReport.keys[i] == k);
+    for (uint8_t i = 0; i < 6 && !held; i++) {
+      if (_keyReport.keys[i] == 0) {
+        _keyReport.keys[i] = k;
+        held = true;
+      }
+    }
+    if (!held) return 0; // Rapport plein
+  }
+  sendReport(&_keyReport);
+  return 1;
+}
+
+size_t USBHIDKeyboard::releaseRaw(uint8_t k) {
+  if (k >= 0xE0 && k < 0xE8) {
+    _keyReport.modifiers &= ~(1 << (k - 0xE0));
+  } else if (k) {
+    for (uint8_t i = 0; i < 6; i++) {
+      if (_keyReport.keys[i] == k) _keyReport.keys[i] = 0;
+    }
+  }
+  sendReport(&_keyReport);
+  return 1;
+}
+
+void USBHIDKeyboard::releaseAll() {
+  memset(&_keyReport, 0, sizeof(_keyReport));
+  sendReport(&_keyReport);
+}
+
+void USBHIDKeyboard::sendReport(KeyReport* keys) {
+  hid.SendReport(HID_REPORT_ID_KEYBOARD, keys, sizeof(KeyReport));
+}
+
+/* ------------------------------------------------------------------ */
+/* ------------------------------- NVS ------------------------------- */
+/* ------------------------------------------------------------------ */
+void hostNvsClear() { nvs.clear(); }
+
+bool Preferences::begin(const char* name, bool ro, const char*) {
+  space = name;
+  readOnly = ro;
+  open = true;
+  return true;
+}
+
+void Preferences::end() { open = false; }
+
+bool Preferences::clear() {
+  if (!open || readOnly) return false;
+  nvs[space].clear();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!open || readOnly) return false;
+  return nvs[space].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  return open && nvs[space].count(key) > 0;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  return isKey(key) ? nvs[space][key].size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+  size_t len = getBytesLength(key);
+  if (len == 0 || len > maxLen) return 0;
+  memcpy(buffer, nvs[space][key].data(), len);
+  return len;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!open || readOnly || value == nullptr) return 0;
+  const uint8_t* bytes = (const uint8_t*)value;
+  nvs[space][key].assign(bytes, bytes + len);
+  return len;
+}
+
+/* ------------------------------------------------------------------ */
+/* ------------------------------ Flash ------------------------------ */
+/* ------------------------------------------------------------------ */
+bool hostFlashOpen(const char* path) {
+  hostFlashClose();
+  std::string name = (path != nullptr) ? path : "/tmp/macropad-keymap-XXXXXX";
+  if (path != nullptr) {
+    flashFd = open(name.c_str(), O_RDWR | O_CREAT, 0644);
+  } else {
+    flashFd = mkstemp(&name[0]);
+    if (flashFd >= 0) unlink(name.c_str());
+  }
+  if (flashFd < 0) return false;
+  struct stat st;
+  bool fresh = fstat(flashFd, &st) != 0 || st.st_size != (off_t)HOST_FLASH_SIZE;
+  if (fresh && ftruncate(flashFd, HOST_FLASH_SIZE) != 0) return false;
+  void* p = mmap(nullptr, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, flashFd, 0);
+  if (p == MAP_FAILED) return false;
+  flash = (uint8_t*)p;
+  if (fresh) memset(flash, 0xFF, HOST_FLASH_SIZE); // Flash neuve : effacée
+  return true;
+}
+
+void hostFlashClose() {
+  if (flash != nullptr) munmap(flash, HOST_FLASH_SIZE);
+  if (flashFd >= 0) close(flashFd);
+  flash = nullptr;
+  flashFd = -1;
+}
+
+uint8_t* hostFlashData() {
+  if (flash == nullptr) hostFlashOpen(nullptr);
+  return flash;
+}
+
+uint32_t hostFlashSize() { return HOST_FLASH_SIZE; }
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+  if (type != KEYMAP_PARTITION.type || subtype != KEYMAP_PARTITION.subtype) return nullptr;
+  if (label != nullptr && strcmp(label, KEYMAP_PARTITION.label) != 0) return nullptr;
+  return hostFlashData() != nullptr ? &KEYMAP_PARTITION : nullptr;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t, const void** out, esp_partition_mmap_handle_t* handle) {
+  if (partition != &KEYMAP_PARTITION || offset + size > HOST_FLASH_SIZE) return ESP_ERR_INVALID_ARG;
+  *out = hostFlashData() + offset;
+  *handle = 1;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+  if (partition != &KEYMAP_PARTITION || offset + size > HOST_FLASH_SIZE) return ESP_ERR_INVALID_ARG;
+  if ((offset | size) & (partition->erase_size - 1)) return ESP_ERR_INVALID_SIZE;
+  memset(hostFlashData() + offset, 0xFF, size);
+  block((uint64_t)(size / partition->erase_size) * HOST_FLASH_ERASE_US);
+  return ESP_OK;
+}
+
+// Écriture NOR : les bits ne passent que de 1 à 0. Une coupure (hostFlashWriteBudget) arrête l'écriture en route.
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+  if (partition != &KEYMAP_PARTITION || offset + size > HOST_FLASH_SIZE) return ESP_ERR_INVALID_ARG;
+  size_t n = size;
+  if (hostFlashWriteBudget >= 0) {
+    n = min(n, (size_t)hostFlashWriteBudget);
+    hostFlashWriteBudget -= (long)n;
+  }
+  uint8_t* dst = hostFlashData() + offset;
+  for (size_t i = 0; i < n; i++) dst[i] &= ((const uint8_t*)src)[i];
+  block((uint64_t)((n + 255) / 256) * HOST_FLASH_PAGE_US);
+  return (n == size) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+  if (partition != &KEYMAP_PARTITION || offset + size > HOST_FLASH_SIZE) return ESP_ERR_INVALID_ARG;
+  memcpy(dst, hostFlashData() + offset, size);
+  return ESP_OK;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,93 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+#include <string>
+
+// =============================================================================
+//     CARTE SIMULÉE : CE QUE LES TESTS PILOTENT ET OBSERVENT
+// =============================================================================
+// Remplace l'Arduino Nano ESP32 pour faire tourner le sketch sur PC.
+//
+// Horloge virtuelle : millis() et micros() ne bougent que lorsque le temps
+// avance. Il avance quand le sketch attend (delay(), envoi d'un rapport HID,
+// attente d'un front, light sleep, effacement de la Flash) et entre deux
+// tours de loop() (hostLoop(), sketch.h). Le temps de calcul du sketch n'y
+// figure pas : il est mesuré à part, en temps réel, par les bancs d'essai.
+//
+// Broches : actives à l'état bas, tirées au plus au départ. Les traces des
+// tests programment des fronts datés (hostSchedulePin) ; chaque front arrive
+// quand l'horloge passe sa date, et appelle l'interruption de la broche.
+//
+// HID : l'ordinateur interroge le point d'accès IN toutes les
+// HOST_HID_POLL_US ; un rapport part à la première interrogation libre et
+// SendReport() attend qu'il soit parti (comme le cœur arduino-esp32).
+//
+// I2C : un SSD1306 simulé reçoit commandes et données et tient sa propre RAM
+// d'image. La durée des transactions est comptée dans hostI2cUs mais ne
+// fait pas avancer l'horloge : sur la carte, l'envoi à l'écran se fait sur
+// l'autre cœur (oled-buffer.h).
+//
+// Flash : la partition "keymap" est un fichier projeté en mémoire (mmap),
+// avec les règles de la Flash NOR (l'effacement met à 0xFF, l'écriture ne
+// peut que faire passer des bits de 1 à 0).
+// -----------------------------------------------------------------------------
+
+// --- Horloge virtuelle ---
+uint64_t hostNowUs();
+void hostAdvance(uint64_t us);                // Fait avancer l'horloge ; les fronts programmés arrivent en route
+void hostAdvanceTo(uint64_t us);
+extern uint64_t hostBlockedUs;                // Cumul du temps bloqué : delay(), SendReport(), Flash
+extern uint64_t hostIdleUs;                   // Cumul du temps cédé : attente d'un front, light sleep
+
+// --- Broches ---
+void hostSetPin(uint8_t pin, uint8_t level);  // Change le niveau maintenant
+void hostSchedulePin(uint64_t atUs, uint8_t pin, uint8_t level);
+bool hostPinEventsPending();
+uint64_t hostNextPinEventUs();                // UINT64_MAX s'il n'y en a plus
+uint8_t hostPinLevel(uint8_t pin);
+
+// --- USB / HID ---
+const uint32_t HOST_HID_POLL_US = 1000;       // bInterval = 1 ms (full speed)
+
+struct HostHidReport {
+  uint64_t timeUs;      // Date où l'ordinateur a pris le rapport
+  uint8_t id;           // HID_REPORT_ID_...
+  uint8_t len;
+  uint8_t data[64];
+};
+extern std::vector<HostHidReport> hostHidReports;
+
+void hostHidOutput(uint8_t reportId, const uint8_t* data, uint16_t len);   // Rapport OUT de l'ordinateur
+void hostHidSetFeature(uint8_t reportId, const uint8_t* data, uint16_t len);
+void hostUsbEvent(int32_t id);                // ARDUINO_USB_SUSPEND_EVENT...
+
+// --- Écran SSD1306 sur l'I2C ---
+struct HostOled {
+  uint8_t ram[8][128];  // RAM d'image du contrôleur, [page][colonne]
+  bool on;
+  uint8_t contrast;
+  uint32_t dataBytes;   // Octets d'image reçus
+  uint64_t lastDataUs;  // Date du dernier octet d'image reçu
+};
+extern HostOled hostOled;
+extern uint64_t hostI2cUs;                    // Durée cumulée des transactions I2C
+extern uint32_t hostI2cBytes;
+
+bool hostOledPixel(int16_t x, int16_t y);
+std::string hostOledDump(uint8_t pages = 4);  // Une ligne de texte par ligne de points ('#' = allumé)
+
+// --- Flash (partition "keymap") ---
+bool hostFlashOpen(const char* path);         // Sans appel, un fichier temporaire effacé est utilisé
+void hostFlashClose();
+uint8_t* hostFlashData();                     // Contenu brut de la partition
+uint32_t hostFlashSize();
+extern long hostFlashWriteBudget;             // Octets encore écrits avant une coupure (-1 = pas de coupure)
+
+// --- NVS (Preferences) ---
+void hostNvsClear();
+
+// --- Énergie ---
+extern uint32_t hostLightSleeps;              // Passages en light sleep
+extern uint32_t hostCpuMhz;
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,5 @@
+#pragma once
+
+// Registres d'entrée des GPIO : niveaux des GPIO 0 à 31, puis 32 à 48.
+#define GPIO_IN_REG  0x6000403C
+#define GPIO_IN1_REG 0x60004040
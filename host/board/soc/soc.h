@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+
+// Lecture d'un registre du périphérique GPIO simulé (host-board.cpp).
+uint32_t hostRegRead(uint32_t reg);
+#define REG_READ(reg) hostRegRead(reg)
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdio.h>
+
+// =============================================================================
+//     VÉRIFICATIONS DES TESTS DU BUILD LINUX
+// =============================================================================
+// CHECK(cond) note l'échec avec sa ligne et continue ; CHECK_EQ affiche en
+// plus les deux valeurs. main() retourne checkResult() : 0 si tout est bon.
+// -----------------------------------------------------------------------------
+
+int checkFailures = 0;
+
+#define CHECK(cond)                                                          \
+  do {                                                                       \
+    if (!(cond)) {                                                           \
+      printf("%s:%d : ECHEC : %s\n", __FILE__, __LINE__, #cond);             \
+      checkFailures++;                                                       \
+    }                                                                        \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                       \
+  do {                                                                       \
+    long long _a = (long long)(a), _b = (long long)(b);                      \
+    if (_a != _b) {                                                          \
+      printf("%s:%d : ECHEC : %s == %s (%lld != %lld)\n", __FILE__, __LINE__, \
+             #a, #b, _a, _b);                                                \
+      checkFailures++;                                                       \
+    }                                                                        \
+  } while (0)
+
+int checkResult() {
+  if (checkFailures) printf("%d verification(s) en echec\n", checkFailures);
+  else printf("OK\n");
+  return checkFailures ? 1 : 0;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
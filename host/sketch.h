@@ -0,0 +1,92 @@
+#pragma once
+#include <Arduino.h>
+#include "host-board.h"
+
+// =============================================================================
+//     LE SKETCH SUR LA CARTE SIMULÉE (BUILD LINUX)
+// =============================================================================
+// Chaque test ou banc d'essai est un seul fichier qui inclut ce fichier : le
+// sketch entier y est compilé tel quel (l'IDE Arduino ajoute lui aussi
+// Arduino.h avant le .ino), contre la carte simulée de board/.
+//
+// hostLoop() fait un tour de loop() puis avance l'horloge de HOST_LOOP_US,
+// le coût typique d'un tour à 240 MHz. Les traces programment les fronts
+// des touches, du bouton et de l'encodeur à des dates données, rebonds
+// compris ; elles sont jouées pendant que la boucle tourne.
+// -----------------------------------------------------------------------------
+
+#include "../firmware_macropad.esp-32.0.3.ino"
+
+const uint32_t HOST_LOOP_US = 20;        // Durée comptée pour un tour de loop()
+const uint32_t HOST_BOUNCE_US = 150;     // Écart entre deux rebonds d'un contact
+
+// Démarre le sketch : setup(), écran de démarrage compris.
+void hostBoot() {
+  setup();
+}
+
+// Un tour de loop().
+void hostLoop() {
+  loop();
+  hostAdvance(HOST_LOOP_US);
+}
+
+// Fait tourner la boucle pendant 'us' microsecondes d'horloge virtuelle.
+void hostRunFor(uint64_t us) {
+  uint64_t until = hostNowUs() + us;
+  while (hostNowUs() < until) hostLoop();
+}
+
+// Fait tourner la boucle jusqu'à ce que toutes les traces soient jouées, plus 'tailUs'.
+void hostRunTrace(uint64_t tailUs = 50000) {
+  while (hostPinEventsPending()) hostLoop();
+  hostRunFor(tailUs);
+}
+
+// --- Traces ---
+
+// Un contact qui change de niveau en rebondissant 'bounces' fois. Retourne la date du dernier front.
+uint64_t traceContact(uint64_t atUs, uint8_t pin, uint8_t level, uint8_t bounces = 2) {
+  for (uint8_t i = 0; i < bounces; i++) {
+    hostSchedulePin(atUs, pin, level);
+    hostSchedulePin(atUs + HOST_BOUNCE_US / 2, pin, !level);
+    atUs += HOST_BOUNCE_US;
+  }
+  hostSchedulePin(atUs, pin, level);
+  return atUs;
+}
+
+// Appui sur une touche (ou le bouton) tenu 'holdUs', rebonds compris. Retourne la date de relâchement.
+uint64_t tracePress(uint64_t atUs, uint8_t pin, uint64_t holdUs = 60000, uint8_t bounces = 2) {
+  traceContact(atUs, pin, LOW, bounces);
+  return traceContact(atUs + holdUs, pin, HIGH, bounces);
+}
+
+// 'count' crans de l'encodeur dans le sens 'dir' (+1 / -1), un toutes les 'intervalUs'.
+// Les quatre transitions d'un cran sont réparties sur le premier quart de l'intervalle.
+uint64_t traceDetents(uint64_t atUs, int8_t dir, uint16_t count, uint32_t intervalUs) {
+  // Au repos A = B = 1. Un cran +1 : A descend, puis B, puis A remonte, puis B.
+  const uint8_t first = (dir > 0) ? ENC_A : ENC_B;
+  const uint8_t second = (dir > 0) ? ENC_B : ENC_A;
+  const uint32_t phaseUs = max(intervalUs / 16, (uint32_t)50);
+  for (uint16_t i = 0; i < count; i++, atUs += intervalUs) {
+    hostSchedulePin(atUs, first, LOW);
+    hostSchedulePin(atUs + phaseUs, second, LOW);
+    hostSchedulePin(atUs + 2 * phaseUs, first, HIGH);
+    hostSchedulePin(atUs + 3 * phaseUs, second, HIGH);
+  }
+  return atUs;
+}
+
+// Premier rapport HID de type 'id' livré à partir de 'fromUs' (nullptr s'il n'y en a pas).
+const HostHidReport* hostFirstReport(uint8_t id, uint64_t fromUs, size_t* index = nullptr) {
+  for (size_t i = 0; i < hostHidReports.size(); i++) {
+    if (hostHidReports[i].id == id && hostHidReports[i].timeUs >= fromUs) {
+      if (index != nullptr) *index = i;
+      return &hostHidReports[i];
+    }
+  }
+  return nullptr;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
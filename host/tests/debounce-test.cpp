@@ -0,0 +1,122 @@
+#include <Arduino.h>
+#include "debounce.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DE L'ANTI-REBOND (TRACES DE REBOND SYNTHÉTIQUES)
+// =============================================================================
+// Deux lignes suivies en parallèle : EAGER_BIT en mode immédiat, DEFERRED_BIT
+// en mode différé. Une trace donne, échantillon par échantillon, le niveau
+// du contact ('1' = fermé) ; on relève à chaque échantillon les masques
+// d'appui, de relâchement et de rebond.
+// -----------------------------------------------------------------------------
+
+const uint32_t EAGER_BIT = 1UL << 0;
+const uint32_t DEFERRED_BIT = 1UL << 5;
+
+struct TraceResult {
+  std::string pressed, released, chatter;  // Un caractère par échantillon ('x' = front)
+  uint32_t state;
+};
+
+/**
+ * @brief Joue la même trace sur une ligne et relève ses événements.
+ * @param bit La ligne jouée ; l'autre reste au repos.
+ * @param trace Niveaux successifs du contact.
+ */
+TraceResult play(uint32_t bit, const char* trace) {
+  VerticalDebouncer d;
+  d.reset(EAGER_BIT | DEFERRED_BIT, EAGER_BIT, 0);
+  TraceResult r;
+  for (const char* c = trace; *c; c++) {
+    uint32_t chatter = d.update(*c == '1' ? bit : 0);
+    CHECK_EQ(chatter & ~bit, 0);
+    CHECK_EQ((d.pressed | d.released) & ~bit, 0);
+    r.pressed += (d.pressed & bit) ? 'x' : '.';
+    r.released += (d.released & bit) ? 'x' : '.';
+    r.chatter += (chatter & bit) ? 'x' : '.';
+    d.pressed = d.released = 0;
+  }
+  r.state = d.state;
+  return r;
+}
+
+#define CHECK_TRACE(actual, expected)                                        \
+  do {                                                                       \
+    if ((actual) != std::string(expected)) {                                 \
+      printf("%s:%d : ECHEC : %s = \"%s\", attendu \"%s\"\n", __FILE__,      \
+             __LINE__, #actual, (actual).c_str(), expected);                 \
+      checkFailures++;                                                       \
+    }                                                                        \
+  } while (0)
+
+int main() {
+  // Appui qui rebondit deux fois, tenu, puis relâchement qui rebondit une fois.
+  const char* bouncy = "01011111111110100000000";
+
+  // Immédiat : l'appui part au premier front, les rebonds tombent pendant le
+  // verrou de 3 échantillons ; de même pour le relâchement.
+  TraceResult e = play(EAGER_BIT, bouncy);
+  CHECK_TRACE(e.pressed,  ".x.....................");
+  CHECK_TRACE(e.chatter,  "..xx..........xx.......");
+  CHECK_TRACE(e.released, ".............x.........");
+  CHECK_EQ(e.state, 0);
+
+  // Différé : le changement n'est validé qu'après 4 échantillons identiques ;
+  // un rebond qui rejoint l'état stable relance le compteur.
+  TraceResult d = play(DEFERRED_BIT, bouncy);
+  CHECK_TRACE(d.pressed,  "......x................");
+  CHECK_TRACE(d.chatter,  "..x...........x........");
+  CHECK_TRACE(d.released, "..................x....");
+  CHECK_EQ(d.state, 0);
+
+  // Une coupure d'un échantillon pendant l'appui : relâchement puis nouvel
+  // appui (une fois le verrou écoulé) en immédiat, rien en différé.
+  const char* dropout = "0111111011111111";
+  e = play(EAGER_BIT, dropout);
+  CHECK_TRACE(e.pressed,  ".x.........x....");  // Après le verrou du relâchement
+  CHECK_TRACE(e.released, ".......x........");
+  d = play(DEFERRED_BIT, dropout);
+  CHECK_TRACE(d.pressed,  "....x...........");
+  CHECK_TRACE(d.released, "................");
+  CHECK_TRACE(d.chatter,  "........x.......");
+  CHECK_EQ(d.state, DEFERRED_BIT);
+
+  // Un parasite isolé d'un échantillon : signalé (appui puis relâchement) en
+  // immédiat, ignoré en différé.
+  const char* glitch = "0010000000";
+  e = play(EAGER_BIT, glitch);
+  CHECK_TRACE(e.pressed,  "..x.......");
+  CHECK_TRACE(e.released, "......x...");
+  d = play(DEFERRED_BIT, glitch);
+  CHECK_TRACE(d.pressed,  "..........");
+  CHECK_TRACE(d.released, "..........");
+  CHECK_TRACE(d.chatter,  "...x......");
+
+  // Les deux lignes ensemble, sur des traces différentes : les masques restent
+  // séparés et l'état stable suit chaque ligne.
+  VerticalDebouncer both;
+  both.reset(EAGER_BIT | DEFERRED_BIT, EAGER_BIT, 0);
+  const char* eagerTrace    = "1111111100000000";
+  const char* deferredTrace = "0011111111111000";
+  uint32_t pressed = 0, released = 0;
+  for (uint8_t i = 0; eagerTrace[i]; i++) {
+    uint32_t sample = (eagerTrace[i] == '1' ? EAGER_BIT : 0) | (deferredTrace[i] == '1' ? DEFERRED_BIT : 0);
+    both.update(sample | (1UL << 9));  // Une ligne non suivie est ignorée
+    if (i == 5) CHECK_EQ(both.state, EAGER_BIT | DEFERRED_BIT);
+    if (i == 11) CHECK_EQ(both.state, DEFERRED_BIT);
+    pressed |= both.pressed;
+    released |= both.released;
+  }
+  CHECK_EQ(pressed, EAGER_BIT | DEFERRED_BIT);
+  CHECK_EQ(released, EAGER_BIT);
+  CHECK_EQ(both.state, DEFERRED_BIT);
+  CHECK(both.settling());   // Le relâchement différé attend encore
+  both.update(0);
+  CHECK_EQ(both.state, 0);
+  CHECK(!both.settling());
+
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
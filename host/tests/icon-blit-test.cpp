@@ -0,0 +1,75 @@
+#include "sketch.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DU DESSIN RAPIDE DES ICÔNES (icon-blit.h)
+// =============================================================================
+// blitIcon16() doit donner exactement l'image de drawBitmap() point par
+// point : pour chaque icône de icondata.h, chaque couleur et chaque position
+// (bords et coins compris, y multiple de 8 ou non), sur un fond quelconque.
+// -----------------------------------------------------------------------------
+
+// Remplit l'image d'un motif pseudo-aléatoire reproductible.
+void fillNoise(Adafruit_SSD1306& oled, uint32_t seed, size_t size) {
+  uint8_t* buffer = oled.getBuffer();
+  for (size_t i = 0; i < size; i++) {
+    seed = seed * 1103515245u + 12345u;
+    buffer[i] = seed >> 16;
+  }
+}
+
+// Compare blitIcon16() et drawBitmap() sur un écran de 'height' lignes ; retourne le nombre d'écarts.
+uint32_t compareOnScreen(int16_t height) {
+  const int16_t width = 128;
+  const size_t size = width * ((height + 7) / 8);
+  const uint16_t colors[] = { SSD1306_WHITE, SSD1306_BLACK, SSD1306_INVERSE };
+  Adafruit_SSD1306 ref(width, height), fast(width, height);
+  ref.begin(SSD1306_SWITCHCAPVCC, 0, true, false);
+  fast.begin(SSD1306_SWITCHCAPVCC, 0, true, false);
+
+  uint32_t mismatches = 0, cases = 0;
+  for (uint8_t i = 0; i < NUM_ICON_PAGES; i++) {
+    for (uint16_t color : colors) {
+      for (int16_t y = -17; y <= height + 1; y++) {
+        for (int16_t x = -17; x <= width + 1; x += (x > 0 && x < width - 16) ? 7 : 1) {
+          uint32_t seed = cases++;
+          fillNoise(ref, seed, size);
+          fillNoise(fast, seed, size);
+          ref.drawBitmap(x, y, ICON_PAGES[i].bitmap, 16, 16, color);
+          blitIcon16(fast.getBuffer(), width, height, x, y, ICON_PAGES[i].pages, color);
+          if (memcmp(ref.getBuffer(), fast.getBuffer(), size) != 0) {
+            if (mismatches++ < 5) printf("Ecart : icone %u, couleur %u, x = %d, y = %d, hauteur %d\n", i, color, x, y, height);
+          }
+        }
+      }
+    }
+  }
+  return mismatches;
+}
+
+int main() {
+  // La transposition à l'exécution (icônes utilisateur) donne les mêmes octets que celle de la compilation.
+  for (uint8_t i = 0; i < NUM_ICON_PAGES; i++) {
+    PageIcon16 converted;
+    pageIconConvert(ICON_PAGES[i].bitmap, converted);
+    CHECK(memcmp(converted.bytes, ICON_PAGES[i].pages.bytes, sizeof(converted.bytes)) == 0);
+    CHECK(pageIcon(ICON_PAGES[i].bitmap) == &ICON_PAGES[i].pages);
+  }
+
+  CHECK_EQ(compareOnScreen(32), 0);
+  CHECK_EQ(compareOnScreen(64), 0);
+
+  // Hors de l'écran ou sans framebuffer : rien n'est écrit.
+  uint8_t buffer[128 * 4];
+  memset(buffer, 0x5A, sizeof(buffer));
+  blitIcon16(buffer, 128, 32, -16, 0, ICON_PAGES[0].pages, SSD1306_INVERSE);
+  blitIcon16(buffer, 128, 32, 128, 0, ICON_PAGES[0].pages, SSD1306_INVERSE);
+  blitIcon16(buffer, 128, 32, 0, -16, ICON_PAGES[0].pages, SSD1306_INVERSE);
+  blitIcon16(buffer, 128, 32, 0, 32, ICON_PAGES[0].pages, SSD1306_INVERSE);
+  blitIcon16(nullptr, 128, 32, 0, 0, ICON_PAGES[0].pages, SSD1306_INVERSE);
+  for (size_t i = 0; i < sizeof(buffer); i++) CHECK_EQ(buffer[i], 0x5A);
+
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,146 @@
+#include "sketch.h"
+#include "check.h"
+#include <unistd.h>
+
+// =============================================================================
+//     TEST DES TABLES DE TOUCHES EN FLASH (keymap-store.h)
+// =============================================================================
+// La partition "keymap" est un fichier projeté en mémoire, avec les règles
+// de la Flash NOR. Un redémarrage = fermer et rouvrir le fichier, puis
+// relancer keymapStoreBegin(). On vérifie la bascule à chaud entre les deux
+// emplacements, une écriture coupée (enregistrements ou en-tête) et un
+// emplacement dont le CRC ne correspond plus.
+// -----------------------------------------------------------------------------
+
+const char* flashPath = nullptr;
+
+// Redémarrage : la Flash est relue depuis le fichier.
+void reboot() {
+  hostFlashClose();
+  CHECK(hostFlashOpen(flashPath));
+  keymapFlash = nullptr;
+  keymapRecords = nullptr;
+  keymapActiveSlot = keymapPendingSlot = keymapWriteSlot = -1;
+  keymapGeneration = 0;
+  keymapStoreBegin();
+}
+
+// Un enregistrement de type message, avec le libellé donné.
+KeyRecord messageRecord(const char* label) {
+  KeyRecord r;
+  keyRecordFromAction(KEYMAP[0][K2], r);
+  memset(r.label, 0, KEY_LABEL_LEN);
+  strncpy(r.label, label, KEY_LABEL_LEN - 1);
+  return r;
+}
+
+// Libellé de la touche tel que le firmware l'exécuterait.
+std::string labelOf(uint8_t layer, uint8_t key) {
+  KeyAction scratch;
+  const KeyAction& a = keymapLookup(layer, key, scratch);
+  return a.label != nullptr ? a.label : "";
+}
+
+int main() {
+  char path[] = "/tmp/macropad-keymap-test-XXXXXX";
+  int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  close(fd);
+  unlink(path);  // hostFlashOpen() le recrée effacé
+  flashPath = path;
+  CHECK(hostFlashOpen(flashPath));
+  hostBoot();
+
+  // Flash effacée : KEYMAP seule.
+  CHECK_EQ(keymapActiveSlot, -1);
+  CHECK(keymapRecords == nullptr);
+  const std::string firmwareK2 = labelOf(0, K2);
+
+  // Première table : écrite dans l'emplacement 0, active au tour suivant seulement.
+  CHECK(keymapWriteOne(0, K2, messageRecord("Essai A")));
+  CHECK_EQ(keymapPendingSlot, 0);
+  CHECK(labelOf(0, K2) == firmwareK2);
+  keymapStoreTick();
+  CHECK_EQ(keymapActiveSlot, 0);
+  CHECK_EQ(keymapGeneration, 1);
+  CHECK(labelOf(0, K2) == "Essai A");
+  CHECK(keymapRecord(0, K1) == nullptr);
+  reboot();
+  CHECK_EQ(keymapActiveSlot, 0);
+  CHECK(labelOf(0, K2) == "Essai A");
+
+  // Deuxième table dans l'emplacement 1, qui l'emporte par sa génération.
+  CHECK(keymapWriteOne(0, K3, messageRecord("Essai B")));
+  keymapStoreTick();
+  CHECK_EQ(keymapActiveSlot, 1);
+  CHECK_EQ(keymapGeneration, 2);
+  CHECK(labelOf(0, K2) == "Essai A");  // Recopiée depuis l'ancienne table
+  CHECK(labelOf(0, K3) == "Essai B");
+  reboot();
+  CHECK_EQ(keymapActiveSlot, 1);
+
+  // Écriture coupée au milieu des enregistrements : refusée, l'ancienne
+  // table reste active, avant comme après un redémarrage.
+  hostFlashWriteBudget = KEYMAP_RECORDS_SIZE / 2;
+  CHECK(!keymapWriteOne(0, K4, messageRecord("Coupee")));
+  hostFlashWriteBudget = -1;
+  CHECK_EQ(keymapPendingSlot, -1);
+  keymapStoreTick();
+  CHECK_EQ(keymapActiveSlot, 1);
+  CHECK(labelOf(0, K4) != "Coupee");
+  reboot();
+  CHECK_EQ(keymapActiveSlot, 1);
+  CHECK_EQ(keymapGeneration, 2);
+  CHECK(labelOf(0, K3) == "Essai B");
+  CHECK(labelOf(0, K4) != "Coupee");
+
+  // Coupure pendant l'écriture de l'en-tête (magic écrit, CRC non) : l'emplacement 0 est ignoré.
+  hostFlashWriteBudget = KEYMAP_RECORDS_SIZE + 8;
+  CHECK(!keymapWriteOne(0, K4, messageRecord("Coupee")));
+  hostFlashWriteBudget = -1;
+  const KeymapSlotHeader* torn = keymapSlotHeader(0);
+  CHECK_EQ(torn->magic, KEYMAP_MAGIC);
+  reboot();
+  CHECK(!keymapSlotValid(0));
+  CHECK_EQ(keymapActiveSlot, 1);
+  CHECK(labelOf(0, K4) != "Coupee");
+
+  // CRC annoncé faux : la table est refusée avant l'écriture de l'en-tête.
+  CHECK(keymapWriteBegin());
+  KeyRecord empty = {};
+  for (uint16_t i = 0; i < KEYMAP_RECORD_COUNT; i++) {
+    CHECK(keymapWriteRecords(i * sizeof(KeyRecord), &empty, sizeof(empty)));
+  }
+  CHECK(!keymapWriteEnd(keymapWriteCrc ^ 1));
+  CHECK_EQ(keymapPendingSlot, -1);
+  CHECK_EQ(keymapSlotHeader(0)->magic, 0xFFFFFFFF);
+
+  // Un bit de l'emplacement actif passe à 0 (Flash abîmée) : au redémarrage
+  // le CRC ne correspond plus et l'autre emplacement, s'il est valide, prend le relais.
+  CHECK(keymapWriteOne(0, K5, messageRecord("Essai C")));   // Génération 3, emplacement 0
+  keymapStoreTick();
+  CHECK_EQ(keymapActiveSlot, 0);
+  reboot();
+  CHECK_EQ(keymapActiveSlot, 0);
+  uint8_t* slot0 = hostFlashData() + sizeof(KeymapSlotHeader);
+  slot0[K5 * sizeof(KeyRecord) + 4] &= 0xFE;
+  reboot();
+  CHECK(!keymapSlotValid(0));
+  CHECK_EQ(keymapActiveSlot, 1);
+  CHECK_EQ(keymapGeneration, 2);
+  CHECK(labelOf(0, K3) == "Essai B");
+  CHECK(labelOf(0, K5) != "Essai C");
+
+  // Les deux emplacements abîmés : retour à KEYMAP seule.
+  uint8_t* slot1 = hostFlashData() + KEYMAP_SLOT_SIZE + sizeof(KeymapSlotHeader);
+  slot1[K3 * sizeof(KeyRecord) + 4] &= 0xFE;
+  reboot();
+  CHECK_EQ(keymapActiveSlot, -1);
+  CHECK(labelOf(0, K2) == firmwareK2);
+
+  hostFlashClose();
+  unlink(path);
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,116 @@
+#include "sketch.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DE LA GESTION DE L'ÉNERGIE (power.h)
+// =============================================================================
+// D'abord la décision seule (powerNextState), puis le sketch entier sur
+// l'horloge virtuelle : actif -> économiseur -> écran éteint -> somnolence,
+// light sleep seulement pendant que l'hôte suspend le bus USB, et réveil par
+// une touche dont la macro part quand même.
+// -----------------------------------------------------------------------------
+
+void testDecision() {
+  const PowerTimings t = { 15000, 30000, 50 };
+  PowerInputs in = { 0, 100000, false, false };
+  CHECK_EQ(powerNextState(in, t), POWER_ACTIVE);
+  in.idleMs = 15000;
+  CHECK_EQ(powerNextState(in, t), POWER_ACTIVE);
+  in.idleMs = 15001;
+  CHECK_EQ(powerNextState(in, t), POWER_SCREENSAVER);
+  in.usbSuspended = true;   // Pas de light sleep écran allumé
+  CHECK_EQ(powerNextState(in, t), POWER_SCREENSAVER);
+  in.usbSuspended = false;
+  in.idleMs = 30001;
+  CHECK_EQ(powerNextState(in, t), POWER_DOZE);
+  in.usbSuspended = true;
+  CHECK_EQ(powerNextState(in, t), POWER_LIGHT_SLEEP);
+
+  // Travail en cours ou front récent : écran éteint, mais pleine vitesse.
+  in.busy = true;
+  CHECK_EQ(powerNextState(in, t), POWER_DISPLAY_OFF);
+  in.busy = false;
+  in.sinceEdgeMs = 49;
+  CHECK_EQ(powerNextState(in, t), POWER_DISPLAY_OFF);
+  in.sinceEdgeMs = 50;
+  CHECK_EQ(powerNextState(in, t), POWER_LIGHT_SLEEP);
+
+  // Une action ramène en POWER_ACTIVE depuis n'importe quel état.
+  in.idleMs = 0;
+  CHECK_EQ(powerNextState(in, t), POWER_ACTIVE);
+}
+
+void testSketch() {
+  hostBoot();
+  hostRunFor((SCREENSAVER_DELAY - 500) * 1000ULL);
+  CHECK_EQ(powerState, POWER_ACTIVE);
+  CHECK(hostOled.on);
+  CHECK_EQ(hostCpuMhz, 240);
+
+  hostRunFor(1000000);
+  CHECK_EQ(powerState, POWER_SCREENSAVER);
+  CHECK(hostOled.on);
+
+  hostRunFor((SLEEP_DELAY - SCREENSAVER_DELAY) * 1000ULL);
+  CHECK_EQ(powerState, POWER_DOZE);
+  CHECK(!hostOled.on);
+  CHECK_EQ(hostCpuMhz, POWER_DOZE_MHZ);
+  CHECK_EQ(powerStats.entries[POWER_SCREENSAVER], 1);
+  CHECK_EQ(powerStats.entries[POWER_DOZE], 1);
+
+  // Bus USB actif : la somnolence dure, jamais de light sleep.
+  hostRunFor(5000000);
+  CHECK_EQ(powerState, POWER_DOZE);
+  CHECK_EQ(hostLightSleeps, 0);
+
+  // Un front sans action (demi-cran de l'encodeur) : pleine vitesse, écran
+  // toujours éteint, le temps de wakeHoldMs, puis retour en somnolence.
+  uint32_t wakes = powerWakes, displayOff = powerStats.entries[POWER_DISPLAY_OFF];
+  hostSchedulePin(hostNowUs() + 1000, ENC_A, LOW);
+  hostSchedulePin(hostNowUs() + 2000, ENC_A, HIGH);
+  hostRunFor(10000);
+  CHECK_EQ(powerState, POWER_DISPLAY_OFF);
+  CHECK_EQ(hostCpuMhz, 240);
+  CHECK(!hostOled.on);
+  CHECK_EQ(powerWakes, wakes + 1);
+  CHECK_EQ(powerStats.entries[POWER_DISPLAY_OFF], displayOff + 1);
+  hostRunFor(POWER_TIMINGS.wakeHoldMs * 1000ULL + 50000);
+  CHECK_EQ(powerState, POWER_DOZE);
+  CHECK(!hostOled.on);
+
+  // L'hôte suspend le bus : light sleep, processeur rendu à sa fréquence.
+  hostUsbEvent(ARDUINO_USB_SUSPEND_EVENT);
+  hostRunFor(1000000);
+  CHECK_EQ(powerState, POWER_LIGHT_SLEEP);
+  CHECK(hostLightSleeps > 0);
+  CHECK_EQ(hostCpuMhz, 240);
+  CHECK(!hostOled.on);
+
+  // Reprise du bus : retour en somnolence, plus de light sleep.
+  hostUsbEvent(ARDUINO_USB_RESUME_EVENT);
+  hostRunFor(200000);
+  CHECK_EQ(powerState, POWER_DOZE);
+  uint32_t sleeps = hostLightSleeps;
+  hostRunFor(1000000);
+  CHECK_EQ(hostLightSleeps, sleeps);
+
+  // Une touche pendant le light sleep : réveil, écran rallumé, et la macro part.
+  hostUsbEvent(ARDUINO_USB_SUSPEND_EVENT);
+  hostRunFor(500000);
+  CHECK_EQ(powerState, POWER_LIGHT_SLEEP);
+  hostUsbEvent(ARDUINO_USB_RESUME_EVENT); // L'appui réveille aussi l'ordinateur
+  uint64_t edge = hostNowUs();
+  tracePress(edge, KEY_PINS[K2]);
+  hostRunTrace(100000);
+  CHECK_EQ(powerState, POWER_ACTIVE);
+  CHECK(hostOled.on);
+  CHECK(hostFirstReport(HID_REPORT_ID_KEYBOARD, edge) != nullptr);
+}
+
+int main() {
+  testDecision();
+  testSketch();
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,95 @@
+#include "sketch.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DU DESSIN RAPIDE DU TEXTE (text-blit.h)
+// =============================================================================
+// blitText() doit donner exactement l'image de setCursor() + print() en
+// taille 1, pour chaque façon de combiner le texte avec l'écran, à chaque
+// position (lignes hors des pages, bords, retour à la ligne), sur un fond
+// quelconque. Les textes pré-rendus (textStrip) doivent donner les mêmes
+// colonnes que la police.
+// -----------------------------------------------------------------------------
+
+// Couleurs de print() équivalentes à chaque encre.
+struct InkColors {
+  TextInk ink;
+  uint16_t color, bg;
+};
+const InkColors INKS[] = {
+  { TEXT_WHITE,   SSD1306_WHITE,   SSD1306_WHITE },
+  { TEXT_BLACK,   SSD1306_BLACK,   SSD1306_BLACK },
+  { TEXT_XOR,     SSD1306_INVERSE, SSD1306_INVERSE },
+  { TEXT_OPAQUE,  SSD1306_WHITE,   SSD1306_BLACK },
+  { TEXT_REVERSE, SSD1306_BLACK,   SSD1306_WHITE },
+};
+
+void fillNoise(Adafruit_SSD1306& oled, uint32_t seed, size_t size) {
+  uint8_t* buffer = oled.getBuffer();
+  for (size_t i = 0; i < size; i++) {
+    seed = seed * 1103515245u + 12345u;
+    buffer[i] = seed >> 16;
+  }
+}
+
+// Compare blitText() et print() sur un écran de 'height' lignes ; retourne le nombre d'écarts.
+uint32_t compareOnScreen(int16_t height, const char* text, bool wrap) {
+  const int16_t width = 128;
+  const size_t size = width * ((height + 7) / 8);
+  Adafruit_SSD1306 ref(width, height), fast(width, height);
+  ref.begin(SSD1306_SWITCHCAPVCC, 0, true, false);
+  fast.begin(SSD1306_SWITCHCAPVCC, 0, true, false);
+  ref.setTextSize(1);
+  ref.setTextWrap(wrap);
+
+  uint32_t mismatches = 0, cases = 0;
+  for (const InkColors& ink : INKS) {
+    ref.setTextColor(ink.color, ink.bg);
+    for (int16_t y = -9; y <= height + 1; y++) {
+      for (int16_t x = -textWidth(text) - 1; x <= width + 1; x += (x > 0 && x < width - 12) ? 5 : 1) {
+        uint32_t seed = cases++;
+        fillNoise(ref, seed, size);
+        fillNoise(fast, seed, size);
+        ref.setCursor(x, y);
+        ref.print(text);
+        int16_t end = blitText(fast.getBuffer(), width, height, x, y, text, ink.ink, wrap);
+        if (memcmp(ref.getBuffer(), fast.getBuffer(), size) != 0 || (strchr(text, '\n') == nullptr && end != ref.getCursorX())) {
+          if (mismatches++ < 5) printf("Ecart : \"%s\", encre %u, x = %d, y = %d, hauteur %d\n", text, ink.ink, x, y, height);
+        }
+      }
+    }
+  }
+  return mismatches;
+}
+
+int main() {
+  // Tous les caractères de la police, un par un (le retour à la ligne est coupé).
+  char one[2] = { 0, 0 };
+  uint32_t glyphMismatches = 0;
+  for (uint8_t c = FONT_FIRST; c <= FONT_LAST; c++) {
+    one[0] = (char)c;
+    glyphMismatches += compareOnScreen(32, one, false);
+  }
+  CHECK_EQ(glyphMismatches, 0);
+
+  // Des textes du firmware, avec et sans retour à la ligne automatique.
+  CHECK_EQ(compareOnScreen(32, "Mode: Volume", false), 0);
+  CHECK_EQ(compareOnScreen(32, "Luminosite < 80 >", true), 0);
+  CHECK_EQ(compareOnScreen(64, "Couche 1\nK3 Win+Shift+S", true), 0);
+  CHECK_EQ(compareOnScreen(32, "Un texte bien trop long pour une seule ligne", true), 0);
+
+  // Texte pré-rendu : mêmes colonnes que la police, cellule de 6 points.
+  constexpr auto strip = textStrip("Mode: Volume");
+  static_assert(sizeof(strip.cols) == 12 * TEXT_CELL_W, "12 caracteres de 6 colonnes");
+  uint8_t expected[128] = {};
+  uint8_t actual[128] = {};
+  blitText(expected, 128, 8, 0, 0, "Mode: Volume", TEXT_WHITE, false);
+  blitColumns(actual, 128, 8, 0, 0, strip.cols, sizeof(strip.cols), TEXT_WHITE);
+  CHECK(memcmp(expected, actual, sizeof(expected)) == 0);
+  CHECK_EQ(glyphColumn('A', 5), 0);
+  CHECK_EQ(glyphColumn('\x01', 0), glyphColumn('?', 0));
+
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,104 @@
+#include "sketch.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DE LA FRAPPE DE TEXTE PAR-DESSUS LES AUTRES PISTES (typist.h)
+// =============================================================================
+// Pendant que la piste de l'encodeur tient Ctrl (et une touche), un texte est
+// tapé sur la piste des touches : chaque rapport doit garder ce qui est tenu,
+// le texte ne doit relâcher que ses propres touches, et l'état de Keyboard
+// doit rester juste pour la suite.
+// -----------------------------------------------------------------------------
+
+const uint8_t HID_CTRL = 0x01;
+const uint8_t USAGE_ESC = KEY_ESC - 0x88;
+
+// Vrai si le rapport clavier contient la touche 'usage'.
+bool hasKey(const HostHidReport& r, uint8_t usage) {
+  for (uint8_t i = 2; i < 8; i++) {
+    if (r.data[i] == usage) return true;
+  }
+  return false;
+}
+
+// Touches du rapport clavier autres que 'except'.
+uint8_t otherKeys(const HostHidReport& r, uint8_t except) {
+  uint8_t n = 0;
+  for (uint8_t i = 2; i < 8; i++) n += (r.data[i] != 0 && r.data[i] != except);
+  return n;
+}
+
+int main() {
+  hostBoot();
+  hostRunFor(100000);
+
+  // Piste de l'encodeur : Ctrl + Echap tenus 400 ms. Piste des touches : un texte.
+  const char* text = "bonjour le monde";
+  size_t first = hostHidReports.size();
+  CHECK(macroReserve(MACRO_TRACK_ENCODER, 5));
+  macroPush(MACRO_TRACK_ENCODER, STEP_MODS, HID_CTRL);
+  macroPress(MACRO_TRACK_ENCODER, KEY_ESC);
+  macroWait(MACRO_TRACK_ENCODER, 400);
+  macroRelease(MACRO_TRACK_ENCODER, KEY_ESC);
+  macroPush(MACRO_TRACK_ENCODER, STEP_MODS, 0);
+  hostLoop();   // Ctrl puis Echap partent avant le texte
+  CHECK(macroReserve(MACRO_TRACK_KEYS, 1));
+  macroType(MACRO_TRACK_KEYS, text);
+  uint32_t reportsBefore = typistReports;
+
+  while (!macroIdle(MACRO_TRACK_KEYS)) hostLoop();
+  CHECK(!macroIdle(MACRO_TRACK_ENCODER));   // Le texte est fini avant Ctrl
+  size_t typed = hostHidReports.size();
+  CHECK(typistReports - reportsBefore >= 2);
+
+  // Tant que Ctrl + Echap sont tenus, chaque rapport les garde ; le dernier
+  // rapport du texte ne relâche que ses propres touches.
+  uint32_t keyboardReports = 0;
+  for (size_t i = first; i < typed; i++) {
+    const HostHidReport& r = hostHidReports[i];
+    if (r.id != HID_REPORT_ID_KEYBOARD) continue;
+    if (keyboardReports++ == 0) continue;   // Ctrl seul, avant Echap
+    CHECK(r.data[0] & HID_CTRL);
+    CHECK(hasKey(r, USAGE_ESC));
+  }
+  const HostHidReport& last = hostHidReports[typed - 1];
+  CHECK_EQ(last.id, HID_REPORT_ID_KEYBOARD);
+  CHECK_EQ(last.data[0], HID_CTRL);
+  CHECK(hasKey(last, USAGE_ESC));
+  CHECK_EQ(otherKeys(last, USAGE_ESC), 0);
+
+  // L'encodeur relâche ensuite Echap puis Ctrl : l'état de Keyboard est resté juste.
+  while (!macroIdle(MACRO_TRACK_ENCODER)) hostLoop();
+  const HostHidReport& end = hostHidReports.back();
+  CHECK_EQ(end.data[0], 0);
+  CHECK_EQ(otherKeys(end, 0), 0);
+  CHECK_EQ(macroHeldKeys.modifiers, 0);
+  CHECK_EQ(keyReportCount(macroHeldKeys), 0);
+
+  // Seul, un texte finit sur un rapport vide, et un lot ne dépasse pas 6 touches.
+  first = hostHidReports.size();
+  CHECK(macroReserve(MACRO_TRACK_KEYS, 1));
+  macroType(MACRO_TRACK_KEYS, "abcdefghij");
+  while (!macroIdle(MACRO_TRACK_KEYS)) hostLoop();
+  CHECK_EQ(hostHidReports.size() - first, 4);   // 6 + 4 caractères : 2 appuis, 2 relâchements
+  CHECK_EQ(otherKeys(hostHidReports[first], 0), 6);
+  CHECK_EQ(hostHidReports.back().data[0], 0);
+  CHECK_EQ(otherKeys(hostHidReports.back(), 0), 0);
+
+  // Avec deux touches tenues, les lots se limitent aux 4 places restantes.
+  CHECK(macroReserve(MACRO_TRACK_ENCODER, 2));
+  macroPress(MACRO_TRACK_ENCODER, KEY_ESC);
+  macroPress(MACRO_TRACK_ENCODER, KEY_TAB);
+  hostRunFor(10000);
+  first = hostHidReports.size();
+  CHECK(macroReserve(MACRO_TRACK_KEYS, 1));
+  macroType(MACRO_TRACK_KEYS, "abcdefgh");
+  while (!macroIdle(MACRO_TRACK_KEYS)) hostLoop();
+  CHECK_EQ(hostHidReports.size() - first, 4);
+  CHECK_EQ(otherKeys(hostHidReports[first], 0), 6);
+  CHECK_EQ(otherKeys(hostHidReports.back(), 0), 2);
+
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
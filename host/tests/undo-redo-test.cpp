@@ -0,0 +1,74 @@
+#include "sketch.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DU MODE ANNULER / RÉTABLIR DE L'ENCODEUR
+// =============================================================================
+// Chaque pas doit donner un Ctrl+Z (ou Ctrl+Y), même quand les crans
+// arrivent bien plus vite que les raccourcis ne partent : les crans d'un
+// même sens s'ajoutent à l'étape en file, aucun n'est perdu.
+// -----------------------------------------------------------------------------
+
+const uint8_t USAGE_Z = 0x1D, USAGE_Y = 0x1C;   // Usages HID (QWERTY américain, comme Keyboard.press())
+
+// Appuis Ctrl + 'usage' reçus par l'ordinateur depuis le rapport 'first'.
+uint32_t ctrlTaps(size_t first, uint8_t usage) {
+  uint32_t n = 0;
+  bool down = false;
+  for (size_t i = first; i < hostHidReports.size(); i++) {
+    const HostHidReport& r = hostHidReports[i];
+    if (r.id != HID_REPORT_ID_KEYBOARD) continue;
+    bool now = (r.data[0] & 0x01) && memchr(r.data + 2, usage, 6) != nullptr;
+    if (now && !down) n++;
+    down = now;
+  }
+  return n;
+}
+
+int main() {
+  hostBoot();
+  hostRunFor(100000);
+  tracePress(hostNowUs() + 1000, ENC_SW, 80000);   // Profil "General", mode normal
+  hostRunTrace(1500000);
+  CHECK_EQ(currentState, STATE_NORMAL);
+  selectEncoderMode(MODE_UNDO_REDO);
+  hostRunFor(100000);
+
+  // Crans lents : un Ctrl+Z chacun.
+  size_t first = hostHidReports.size();
+  for (uint8_t i = 0; i < 4; i++) {
+    traceDetents(hostNowUs() + 1000, -1, 1, 0);
+    hostRunTrace(300000);
+  }
+  CHECK_EQ(ctrlTaps(first, USAGE_Z), 4);
+
+  // 40 crans rapides : l'ancienne file (5 étapes par raccourci) en perdait.
+  first = hostHidReports.size();
+  uint8_t leastFree = MACRO_QUEUE_SIZE;
+  traceDetents(hostNowUs() + 1000, -1, 40, 5000);
+  while (hostPinEventsPending()) {
+    hostLoop();
+    leastFree = min(leastFree, macroFree(MACRO_TRACK_ENCODER));
+  }
+  hostRunFor(1000000);
+  CHECK(ctrlTaps(first, USAGE_Z) >= 40);
+  CHECK(leastFree >= MACRO_QUEUE_SIZE - 2);
+  CHECK(macroIdle(MACRO_TRACK_ENCODER));
+  CHECK_EQ(macroDropped, 0);
+
+  // Changement de sens : les Ctrl+Y partent après les Ctrl+Z en file, dans l'ordre.
+  first = hostHidReports.size();
+  traceDetents(hostNowUs() + 1000, -1, 2, 300000);
+  traceDetents(hostNowUs() + 700000, +1, 3, 300000);
+  hostRunTrace(500000);
+  CHECK_EQ(ctrlTaps(first, USAGE_Z), 2);
+  CHECK_EQ(ctrlTaps(first, USAGE_Y), 3);
+
+  // Ctrl n'est pas resté tenu.
+  CHECK_EQ(hostHidReports.back().data[0], 0);
+  CHECK_EQ(macroHeldKeys.modifiers, 0);
+
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
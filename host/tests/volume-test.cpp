@@ -0,0 +1,73 @@
+#include "sketch.h"
+#include "check.h"
+
+// =============================================================================
+//     TEST DU VOLUME À L'ENCODEUR (ROTATION LENTE ET RAPIDE)
+// =============================================================================
+// Un cran lent = exactement un pas de volume. Une rotation rapide donne
+// plus de pas (accélération), joués par l'exécuteur un par tour : loop() ne
+// bloque jamais plus d'un appui + relâchement, la file de l'encodeur ne se
+// remplit pas, et aucun pas n'est perdu.
+// -----------------------------------------------------------------------------
+
+uint64_t worstBlockedUs = 0;
+uint8_t leastFree = MACRO_QUEUE_SIZE;
+
+void measuredLoop() {
+  uint64_t blocked = hostBlockedUs;
+  hostLoop();
+  worstBlockedUs = max(worstBlockedUs, hostBlockedUs - blocked);
+  leastFree = min(leastFree, macroFree(MACRO_TRACK_ENCODER));
+}
+
+void run(uint64_t us) {
+  while (hostPinEventsPending()) measuredLoop();
+  uint64_t until = hostNowUs() + us;
+  while (hostNowUs() < until) measuredLoop();
+}
+
+// Appuis "volume +" reçus par l'ordinateur depuis le rapport 'first'.
+uint32_t volumeUps(size_t first) {
+  uint32_t n = 0;
+  for (size_t i = first; i < hostHidReports.size(); i++) {
+    const HostHidReport& r = hostHidReports[i];
+    n += (r.id == HID_REPORT_ID_CONSUMER_CONTROL && (r.data[0] | (r.data[1] << 8)) == HID_USAGE_CONSUMER_VOLUME_INCREMENT);
+  }
+  return n;
+}
+
+int main() {
+  hostBoot();
+  hostRunFor(100000);
+  tracePress(hostNowUs() + 1000, ENC_SW, 80000);   // Profil "General" : mode volume
+  hostRunTrace(1500000);
+  CHECK_EQ(currentState, STATE_NORMAL);
+  CHECK_EQ(currentEncoderMode, MODE_VOLUME);
+
+  // Crans lents : un pas chacun.
+  size_t first = hostHidReports.size();
+  for (uint8_t i = 0; i < 3; i++) {
+    traceDetents(hostNowUs() + 1000, +1, 1, 0);
+    run(300000);
+  }
+  CHECK_EQ(volumeUps(first), 3);
+
+  // Rotation rapide : 12 crans en 120 ms.
+  currentVol = 0;
+  first = hostHidReports.size();
+  worstBlockedUs = 0;
+  traceDetents(hostNowUs() + 1000, +1, 12, 10000);
+  run(500000);
+  uint32_t ups = volumeUps(first);
+  CHECK(ups > 12);                               // L'accélération a joué
+  CHECK(ups <= (uint32_t)VOLUME_MAX_STEPS);
+  CHECK_EQ(ups * 2, (uint32_t)currentVol);       // Tous les pas affichés sont partis
+  CHECK(worstBlockedUs <= 3 * HOST_HID_POLL_US); // Un appui + relâchement par tour au plus
+  CHECK(leastFree >= MACRO_QUEUE_SIZE - 2);      // Les crans rapides s'ajoutent à l'étape en file
+  CHECK(macroIdle(MACRO_TRACK_ENCODER));
+  CHECK_EQ(macroDropped, 0);
+
+  return checkResult();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
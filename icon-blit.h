@@ -0,0 +1,124 @@
+#pragma once
+#include <Adafruit_SSD1306.h>
+#include "index-seq.h"
+
+// =============================================================================
+//     MODULE DE DESSIN RAPIDE DES ICÔNES 16x16
+// =============================================================================
+// drawBitmap() lit l'icône ligne par ligne et appelle drawPixel() pour chacun
+// des 256 points (avec à chaque fois les tests de bord et de rotation).
+// Or la mémoire de l'écran SSD1306 est rangée en "pages" : un octet = une
+// colonne de 8 points verticaux.
+//
+// Les icônes de icondata.h sont donc transposées une fois pour toutes, à la
+// compilation, dans ce format (PageIcon16 : 2 pages de 16 colonnes). Les
+// dessiner revient à combiner 32 octets avec ceux de l'écran :
+//  - SSD1306_WHITE : OU, SSD1306_BLACK : ET avec l'inverse, SSD1306_INVERSE : OU exclusif,
+//  - si y est un multiple de 8, les octets tombent tels quels sur deux pages,
+//  - sinon chaque colonne (16 bits) est décalée et répartie sur trois pages.
+// Une icône en RAM (icône utilisateur, keymap-store.h) est transposée au vol.
+//
+// L'écran est supposé sans rotation (setRotation() n'est pas utilisé).
+// Le résultat est comparé point par point à drawBitmap() sur PC
+// (host/tests/icon-blit-test.cpp).
+// -----------------------------------------------------------------------------
+
+// Une icône 16x16 au format de l'écran : octets [0..15] = lignes 0 à 7
+// (bit 0 en haut), octets [16..31] = lignes 8 à 15.
+struct PageIcon16 {
+  uint8_t bytes[32];
+};
+
+// --- Déclarations des fonctions externes ---
+const PageIcon16* pageIcon(const unsigned char* bitmap); // icondata.h
+
+// --- Transposition à la compilation ---
+// Octet de la colonne 'col' de la page 'page', pour une icône au format drawBitmap.
+constexpr uint8_t pageIconByte(const unsigned char* bitmap, uint8_t page, uint8_t col, uint8_t bit = 0) {
+  return bit >= 8 ? 0
+       : (uint8_t)((((bitmap[(page * 8 + bit) * 2 + col / 8] >> (7 - col % 8)) & 1) << bit)
+                   | pageIconByte(bitmap, page, col, bit + 1));
+}
+
+template <size_t... I>
+constexpr PageIcon16 pageIconFrom(const unsigned char* bitmap, IndexSeq<I...>) {
+  return PageIcon16{ { pageIconByte(bitmap, I / 16, I % 16)... } };
+}
+
+// Transpose une icône au format drawBitmap (2 octets par ligne) : utilisable dans un constexpr.
+constexpr PageIcon16 pageIcon16(const unsigned char* bitmap) {
+  return pageIconFrom(bitmap, MakeIndexSeq<32>::type());
+}
+
+// Même transposition, à l'exécution (icônes reçues de l'ordinateur).
+void pageIconConvert(const unsigned char* bitmap, PageIcon16& icon) {
+  memset(icon.bytes, 0, sizeof(icon.bytes));
+  for (uint8_t row = 0; row < 16; row++) {
+    uint16_t line = (bitmap[row * 2] << 8) | bitmap[row * 2 + 1]; // Bit 15 = colonne 0
+    uint8_t bit = 1 << (row & 7);
+    uint8_t* page = icon.bytes + (row >> 3) * 16;
+    for (uint8_t col = 0; col < 16; col++) {
+      if (line & (0x8000 >> col)) page[col] |= bit;
+    }
+  }
+}
+
+// Combine un octet de points avec un octet de l'écran.
+inline void blitByte(uint8_t& dst, uint8_t bits, uint16_t color) {
+  switch (color) {
+    case SSD1306_WHITE:   dst |= bits; break;
+    case SSD1306_BLACK:   dst &= ~bits; break;
+    case SSD1306_INVERSE: dst ^= bits; break;
+  }
+}
+
+// Combine les colonnes [c0, c1[ de 'bits' avec une page de l'écran, à partir de la colonne x.
+inline void blitSpan(uint8_t* row, int16_t x, const uint8_t* bits, int16_t c0, int16_t c1, uint16_t color) {
+  switch (color) {
+    case SSD1306_WHITE:   for (int16_t c = c0; c < c1; c++) row[x + c] |= bits[c]; break;
+    case SSD1306_BLACK:   for (int16_t c = c0; c < c1; c++) row[x + c] &= ~bits[c]; break;
+    case SSD1306_INVERSE: for (int16_t c = c0; c < c1; c++) row[x + c] ^= bits[c]; break;
+  }
+}
+
+/**
+ * @brief Dessine une icône 16x16 dans un framebuffer SSD1306 (format page).
+ * @param buffer Le framebuffer (getBuffer()), 'width' octets par page.
+ * @param width La largeur de l'écran.
+ * @param height La hauteur de l'écran.
+ * @param x La colonne du coin haut gauche (peut sortir de l'écran).
+ * @param y La ligne du coin haut gauche (peut sortir de l'écran).
+ * @param icon L'icône transposée.
+ * @param color SSD1306_WHITE, SSD1306_BLACK ou SSD1306_INVERSE.
+ */
+void blitIcon16(uint8_t* buffer, int16_t width, int16_t height, int16_t x, int16_t y,
+                const PageIcon16& icon, uint16_t color) {
+  if (buffer == nullptr || x <= -16 || x >= width || y <= -16 || y >= height) return;
+  const int16_t c0 = (x < 0) ? -x : 0;                     // Colonnes visibles de l'icône
+  const int16_t c1 = (x + 16 > width) ? width - x : 16;
+  const int16_t pages = (height + 7) / 8;
+  const int16_t top = (y >= 0) ? y / 8 : -((7 - y) / 8);  // Page de la ligne y (arrondi vers le bas)
+  const uint8_t shift = y - top * 8;
+
+  if (shift == 0) { // Cas rapide : une page de l'icône = une page de l'écran
+    for (int16_t p = 0; p < 2; p++) {
+      if (top + p < 0 || top + p >= pages) continue;
+      blitSpan(buffer + (top + p) * width, x, icon.bytes + p * 16, c0, c1, color);
+    }
+    return;
+  }
+
+  // Cas décalé : chaque colonne de 16 points couvre trois pages
+  uint32_t columns[16];
+  for (int16_t c = c0; c < c1; c++) {
+    columns[c] = (uint32_t)(icon.bytes[c] | (icon.bytes[16 + c] << 8)) << shift;
+  }
+  uint8_t bits[16];
+  for (int16_t p = 0; p < 3; p++) {
+    if (top + p < 0 || top + p >= pages) continue;
+    for (int16_t c = c0; c < c1; c++) bits[c] = columns[c] >> (8 * p);
+    blitSpan(buffer + (top + p) * width, x, bits, c0, c1, color);
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -45,48 +45,39 @@ const unsigned char icon_undo_redo_16x16[]        PROGMEM = { 0x00, 0x00, 0x1f,
 // Icône Notpad 16x16 pixels
 const unsigned char icon_notpad_16x16[]           PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x1f, 0xc8, 0x10, 0x14, 0x1f, 0x38, 0x10, 0x70, 0x1c, 0xe0, 0x19, 0xc0, 0x1a, 0x90, 0x1b, 0x30, 0x18, 0x70, 0x1f, 0xf0, 0x1f, 0xf0, 0x1f, 0xf0, 0x00, 0x00, 0x00, 0x00, };
 
-// Ecran de démarrage 128x32 pixels
-const unsigned char bootscreen_128x32[] PROGMEM = {
-  0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x00, 0xf8, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 
-  0xff, 0xfb, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x00, 0xf8, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 
-  0xff, 0xfb, 0x01, 0x99, 0x33, 0x00, 0xcc, 0x00, 0xc0, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x1b, 0x01, 0x99, 0x33, 0x00, 0xcc, 0x00, 0xc0, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x1b, 0x07, 0xff, 0xff, 0xc0, 0xfc, 0x00, 0xc1, 0xe7, 0x87, 0x8c, 0x7c, 0xf8, 0xe3, 0xc0, 
-  0x00, 0x1b, 0x07, 0xff, 0xff, 0xc0, 0xfc, 0x00, 0xf9, 0xef, 0xcf, 0xcc, 0xfc, 0xfd, 0xe7, 0xe0, 
-  0x00, 0x1b, 0xfe, 0x00, 0x00, 0xf0, 0x00, 0x00, 0xf9, 0x8c, 0xcc, 0xcc, 0xcc, 0xcd, 0x86, 0x60, 
-  0x00, 0x1b, 0xfe, 0x6d, 0x80, 0xf0, 0xfc, 0x00, 0xc1, 0x8f, 0xcf, 0xcc, 0xcc, 0xcd, 0x87, 0xe0, 
-  0x00, 0x18, 0x06, 0x6d, 0x80, 0xc0, 0xfc, 0x00, 0xc1, 0x8f, 0xcf, 0xcc, 0xcc, 0xcd, 0x87, 0xe0, 
-  0x00, 0x18, 0x06, 0x00, 0x0c, 0xc0, 0xcc, 0x00, 0xc1, 0x8c, 0x0c, 0x0c, 0xcc, 0xcd, 0x86, 0x00, 
-  0x00, 0x1f, 0xfe, 0x00, 0x0c, 0xf0, 0xcc, 0x00, 0xc1, 0x8c, 0xcc, 0xcc, 0xdc, 0xcd, 0x86, 0x60, 
-  0x00, 0x1f, 0xfe, 0x00, 0x00, 0xf0, 0xfc, 0x00, 0xc1, 0x8f, 0xcf, 0xcc, 0xfc, 0xcd, 0xe7, 0xe0, 
-  0x00, 0x00, 0x06, 0x00, 0x0c, 0xc0, 0xfc, 0x00, 0xc1, 0x87, 0x87, 0x8c, 0x6c, 0xcc, 0xe3, 0xc0, 
-  0x00, 0x00, 0x06, 0x00, 0x0c, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x7f, 0xfe, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x7f, 0xfe, 0x00, 0x0c, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x60, 0x06, 0x00, 0x0c, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x60, 0x06, 0x00, 0x0c, 0xc0, 0x00, 0x00, 0x00, 0x30, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 
-  0xff, 0xef, 0xfe, 0x00, 0x0c, 0xf0, 0x18, 0x00, 0x00, 0x30, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 
-  0xff, 0xef, 0xfe, 0x00, 0x0c, 0xc0, 0x18, 0x00, 0x00, 0x30, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x0c, 0x06, 0x78, 0x0c, 0xc0, 0x18, 0x00, 0x00, 0x78, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x0d, 0xfe, 0x78, 0x00, 0xf0, 0x18, 0x00, 0x00, 0x78, 0x7c, 0xf8, 0xf1, 0xf1, 0xe0, 0x00, 
-  0x00, 0x0d, 0xfe, 0x00, 0x00, 0xf0, 0x18, 0x00, 0x00, 0x78, 0xfd, 0xf9, 0xf9, 0xfb, 0xe0, 0x00, 
-  0x00, 0x0d, 0x87, 0xff, 0xff, 0xc0, 0x18, 0x00, 0x00, 0x48, 0xcd, 0x99, 0x99, 0x9b, 0x00, 0x00, 
-  0x00, 0x0d, 0x87, 0xff, 0xff, 0xc0, 0x18, 0x00, 0x00, 0xcc, 0xcd, 0x99, 0x99, 0x9b, 0x80, 0x00, 
-  0x00, 0x0d, 0x81, 0x99, 0x33, 0x00, 0x18, 0x00, 0x00, 0xcc, 0xcd, 0x99, 0x99, 0x99, 0xc0, 0x00, 
-  0xff, 0xfd, 0x81, 0x99, 0x33, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xcd, 0x99, 0x99, 0x98, 0xe0, 0x00, 
-  0xff, 0xfd, 0x81, 0x99, 0x33, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xcd, 0x99, 0x99, 0x98, 0x60, 0x00, 
-  0x00, 0x01, 0x80, 0x00, 0x03, 0xff, 0x6c, 0x00, 0x01, 0x86, 0xfd, 0xf9, 0xf9, 0x9b, 0xe0, 0x00, 
-  0x00, 0x01, 0x80, 0x00, 0x03, 0xff, 0x6c, 0x00, 0x01, 0x86, 0x7c, 0xf8, 0xf1, 0x9b, 0xc0, 0x00, 
-  0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+// L'écran de démarrage et les images de l'économiseur d'écran sont compressés
+// dans assets.h (généré par tools/assets.py, voir asset-draw.h).
+
+// Ajoutez vos autres icônes ici...
+
+// --- Versions transposées pour drawIcon16() (icon-blit.h) ---
+// Calculées à la compilation. Une icône 16x16 absente de cette liste reste
+// utilisable : elle est simplement transposée à chaque dessin.
+struct IconPages {
+  const unsigned char* bitmap;
+  PageIcon16 pages;
 };
+#define ICON_PAGES_OF(icon) { icon, pageIcon16(icon) }
 
-// Icône ScreenSaver 16x16 pixels
-const unsigned char icon_screensaver_0_16x16[]      PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xc0, 0x04, 0x20, 0x09, 0x90, 0x13, 0x88, 0x16, 0x08, 0x14, 0x08, 0x10, 0x48, 0x08, 0x90, 0x04, 0x20, 0x03, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, };
-const unsigned char icon_screensaver_90_16x16[]     PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xc0, 0x04, 0x20, 0x09, 0x90, 0x10, 0xc8, 0x10, 0x68, 0x14, 0x68, 0x12, 0x08, 0x08, 0x10, 0x04, 0x20, 0x03, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, };
-const unsigned char icon_screensaver_180_16x16[]    PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xc0, 0x04, 0x20, 0x09, 0x10, 0x12, 0x08, 0x10, 0x28, 0x10, 0x68, 0x11, 0xc8, 0x09, 0x90, 0x04, 0x20, 0x03, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, };
-const unsigned char icon_screensaver_270_16x16[]    PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xc0, 0x04, 0x20, 0x08, 0x10, 0x10, 0x48, 0x16, 0x28, 0x16, 0x08, 0x13, 0x08, 0x09, 0x90, 0x04, 0x20, 0x03, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, };
+constexpr IconPages ICON_PAGES[] = {
+  ICON_PAGES_OF(icon_menu_pc_16x16), ICON_PAGES_OF(icon_menu_souris_16x16),
+  ICON_PAGES_OF(icon_menu_clavier_16x16), ICON_PAGES_OF(icon_menu_audio_16x16),
+  ICON_PAGES_OF(icon_menu_wifi_16x16), ICON_PAGES_OF(icon_menu_bluetooth_16x16),
+  ICON_PAGES_OF(icon_menu_macros_16x16), ICON_PAGES_OF(icon_menu_parametres_16x16),
+  ICON_PAGES_OF(icon_layer_0_16x16), ICON_PAGES_OF(icon_layer_1_16x16),
+  ICON_PAGES_OF(icon_layer_2_16x16), ICON_PAGES_OF(icon_layer_3_16x16),
+  ICON_PAGES_OF(icon_mute_16x16), ICON_PAGES_OF(icon_sound_16x16),
+  ICON_PAGES_OF(icon_scroll_16x16), ICON_PAGES_OF(icon_undo_redo_16x16),
+  ICON_PAGES_OF(icon_notpad_16x16),
+};
+const uint8_t NUM_ICON_PAGES = sizeof(ICON_PAGES) / sizeof(ICON_PAGES[0]);
 
-// Ajoutez vos autres icônes ici...
+// Version transposée d'une icône de la liste (nullptr si absente).
+const PageIcon16* pageIcon(const unsigned char* bitmap) {
+  for (uint8_t i = 0; i < NUM_ICON_PAGES; i++) {
+    if (ICON_PAGES[i].bitmap == bitmap) return &ICON_PAGES[i].pages;
+  }
+  return nullptr;
+}
 
 /* ------------------------------ Fin du code -------------------------------- */
\ No newline at end of file
@@ -3,46 +3,69 @@
 // =============================================================================
 //     MODULE DU MENU D'ICÔNES
 // =============================================================================
+// Les icônes et ce qu'elles font sont une table de MenuNode (menu.h) : une
+// action (profil, page de réglages Windows) ou un sous-menu (configuration).
+// L'écran sans la sélection est gardé dans iconMenuCache : tourner
+// l'encodeur ne fait que recopier ce cache et inverser la nouvelle case.
+// -----------------------------------------------------------------------------
 
 // --- Déclarations des fonctions externes ---
 void showMessage(const char* msg);
-void openViaRun(const char* cmd);
+void openViaRun(const char* cmd, MacroTrackId track);
+void scheduleScreen(void (*screen)(), unsigned long delayMs);
 void wakeUp();
-void drawMenu();
 void returnToIconMenu();
 void fireMacro(uint8_t id);
 void showVolume();
 
 // --- Déclaration des variables GLOBALES utilisées par ce module ---
-extern Adafruit_SSD1306 display;
+extern FramebufferSSD1306 display;
 extern ProgramState currentState;
+extern void (*deferredScreen)();
 extern uint8_t currentLayer;
 extern EncoderMode currentEncoderMode;
 extern bool isInMenu;
-extern int8_t transTable[16];
-extern uint8_t lastAB;
-extern int8_t accum;
-extern unsigned long lastClickMs;
-extern bool lastKeyState[];
-extern const uint8_t NUM_KEYS;
-extern const uint8_t KEY_PINS[];
-extern const unsigned long CLICK_DEBOUNCE_MS;
-extern const uint8_t STEPS_PER_DETENT;
 
 
 // --- Variables propres à ce module ---
 int8_t selectedIconIndex = 0;
-const unsigned char* iconMenu[] = {
-  icon_menu_pc_16x16, icon_menu_souris_16x16, icon_menu_clavier_16x16, icon_menu_audio_16x16,
-  icon_menu_wifi_16x16, icon_menu_bluetooth_16x16, icon_menu_macros_16x16, icon_menu_parametres_16x16
+int8_t activeProfile = 0;      // Dernier profil choisi (sauvegardé, voir settings.h)
+uint8_t iconMenuCache[SCREEN_WIDTH * SCREEN_HEIGHT / 8]; // Le menu sans la sélection
+uint8_t iconMenuCacheLayer = 0xFF;                        // Couche affichée dans le cache (0xFF = vide)
+
+// Un profil : la couche et le mode de l'encodeur qu'il active.
+struct IconProfile {
+  const char* message;
+  uint8_t layer;               // PROFILE_KEEP_LAYER (host-link.h) : couche inchangée
+  EncoderMode encoderMode;
+};
+const IconProfile ICON_PROFILES[] = {
+  { "Profil: General",    0,                  MODE_VOLUME },
+  { "Profil: Navigation", PROFILE_KEEP_LAYER, MODE_SCROLL },
+  { "Profil: Edition",    1,                  MODE_UNDO_REDO },
+  { "Profil: Media",      2,                  MODE_VOLUME },
+  { "Profil: Macros",     0,                  MODE_VOLUME },
+};
+
+// Une page des réglages de Windows, ouverte par Win+R.
+struct IconSettingsPage {
+  const char* command;
+  const char* title;
+  const unsigned char* icon;
+  int16_t titleX;
+};
+const IconSettingsPage ICON_SETTINGS_PAGES[] = {
+  { "ms-settings:network-wifi", "PARAMETRES WIFI",      icon_menu_wifi_16x16,      18 },
+  { "ms-settings:bluetooth",    "PARAMETRES BLUETOOTH", icon_menu_bluetooth_16x16, 5 },
 };
-const uint8_t NUM_ICONS = sizeof(iconMenu) / sizeof(iconMenu[0]);
 
 const unsigned char* layerIcons[] = {
   icon_layer_0_16x16,
   icon_layer_1_16x16,
-  icon_layer_2_16x16
+  icon_layer_2_16x16,
+  icon_layer_3_16x16
 };
+const uint8_t NUM_LAYER_ICONS = sizeof(layerIcons) / sizeof(layerIcons[0]);
 
 
 // --- Fonction d'aide pour l'affichage personnalisé ---
@@ -55,102 +78,122 @@ const unsigned char* layerIcons[] = {
  */
 void displayCustomScreen(const char* label, const unsigned char* icon, int cursorX, int cursorY) {
   display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(cursorX, cursorY);
-  display.print(F(label));
+  display.drawText(cursorX, cursorY, label);
   // On dessine l'icône, toujours centrée horizontalement
-  display.drawBitmap((SCREEN_WIDTH - 16) / 2, 14, icon, 16, 16, SSD1306_WHITE);
+  display.drawIcon16((SCREEN_WIDTH - 16) / 2, 14, icon, SSD1306_WHITE);
   display.display();
 }
 
 
+// --- Actions des icônes ---
+// Active un profil de ICON_PROFILES, puis revient à l'écran de l'encodeur.
+void applyProfile(uint8_t profile) {
+  const IconProfile& p = ICON_PROFILES[profile];
+  showMessage(p.message);
+  if (p.layer != PROFILE_KEEP_LAYER) currentLayer = p.layer;
+  currentEncoderMode = p.encoderMode;
+  activeProfile = selectedIconIndex;
+
+  currentState = STATE_NORMAL;
+  wakeUp();
+  drawIconMenu();
+  scheduleScreen(showVolume, 1000);
+}
+
+// Ouvre une page de ICON_SETTINGS_PAGES, puis revient au menu d'icônes.
+void openSettingsPage(uint8_t page) {
+  const IconSettingsPage& p = ICON_SETTINGS_PAGES[page];
+  openViaRun(p.command, MACRO_TRACK_MENU);
+  displayCustomScreen(p.title, p.icon, p.titleX, 2);
+  scheduleScreen(returnToIconMenu, 2000);
+}
+
+// Les icônes, de gauche à droite.
+constexpr MenuNode ICON_MENU[] PROGMEM = {
+  MenuAction("General",    applyProfile, 0, icon_menu_pc_16x16),
+  MenuAction("Navigation", applyProfile, 1, icon_menu_souris_16x16),
+  MenuAction("Edition",    applyProfile, 2, icon_menu_clavier_16x16),
+  MenuAction("Media",      applyProfile, 3, icon_menu_audio_16x16),
+  MenuAction("Wifi",       openSettingsPage, 0, icon_menu_wifi_16x16),
+  MenuAction("Bluetooth",  openSettingsPage, 1, icon_menu_bluetooth_16x16),
+  MenuAction("Macros",     applyProfile, 4, icon_menu_macros_16x16),
+  MenuSubmenu("Parametres", CONFIG_ITEMS, icon_menu_parametres_16x16),
+};
+const uint8_t NUM_ICONS = sizeof(ICON_MENU) / sizeof(ICON_MENU[0]);
+static_assert(NUM_ICONS * 16 <= SCREEN_WIDTH, "Trop d'icones pour la largeur de l'ecran");
+
+
 // --- Fonctions du menu d'icônes ---
+// Affiche le cache et inverse la case sélectionnée ; le cache est
+// reconstruit si la couche a changé depuis.
+void paintIconMenu() {
+  if (iconMenuCacheLayer != currentLayer) { drawIconMenu(); return; }
+  memcpy(display.getBuffer(), iconMenuCache, sizeof(iconMenuCache));
+  display.fillRect(selectedIconIndex * 16, 16, 16, 16, SSD1306_INVERSE);
+  display.display();
+}
+
+// Dessine tout le menu une fois, le range dans le cache, puis l'affiche.
 void drawIconMenu() {
   display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
 
-  display.setCursor(0, 4);
-  display.print(F("Layer:"));
-  display.drawBitmap(32, 0, layerIcons[currentLayer], 16, 16, SSD1306_WHITE);
+  display.drawText(0, 4, "Layer:");
+  if (currentLayer < NUM_LAYER_ICONS) {
+    display.drawIcon16(32, 0, layerIcons[currentLayer], SSD1306_WHITE);
+  } else {
+    char number[4]; // Pas d'icône pour cette couche : on affiche son numéro
+    snprintf(number, sizeof(number), "%u", currentLayer);
+    display.drawText(36, 4, number);
+  }
 
-  display.setCursor(88, 4);
-  display.print(F("MENU"));
+  display.drawText(88, 4, "MENU");
 
   for (uint8_t i = 0; i < NUM_ICONS; i++) {
-    display.drawBitmap(i * 16, 16, iconMenu[i], 16, 16, SSD1306_WHITE);
+    display.drawIcon16(i * 16, 16, ICON_MENU[i].icon, SSD1306_WHITE);
   }
-  display.fillRect(selectedIconIndex * 16, 16, 16, 16, SSD1306_INVERSE);
-  display.display();
+  memcpy(iconMenuCache, display.getBuffer(), sizeof(iconMenuCache));
+  iconMenuCacheLayer = currentLayer;
+  paintIconMenu();
 }
 
-void handleIconMenu() {
-  // ... (La lecture des touches et la gestion de la rotation de l'encodeur ne changent pas) ...
-  for (uint8_t i = 0; i < NUM_KEYS; i++) {
-    bool pressed = (digitalRead(KEY_PINS[i]) == LOW);
-    if (pressed && !lastKeyState[i]) {
+/**
+ * @brief Menu d'icônes : l'encodeur choisit un profil, le bouton l'active,
+ * une touche lance sa macro puis revient au menu.
+ */
+void iconMenuEvent(const InputEvent& e) {
+  // Pendant l'affichage d'une action (retour au menu programmé), les
+  // entrées sont ignorées, comme le faisait l'ancien delay(2000).
+  if (deferredScreen != nullptr) return;
+
+  switch (e.type) {
+    case EV_KEY_DOWN:
       wakeUp();
-      fireMacro(i);
-      delay(2000);
-      returnToIconMenu();
+      profileInput(e.timeUs, LATENCY_KEY);
+      fireMacro(e.value);
+      profileInputDone();
+      scheduleScreen(returnToIconMenu, 2000);
       return;
-    }
-    lastKeyState[i] = pressed;
-  }
-  
-  uint8_t nowAB = (digitalRead(ENC_A) << 1) | digitalRead(ENC_B);
-  if (nowAB != lastAB) {
-    int8_t dir = transTable[(lastAB << 2) | nowAB];
-    if (dir != 0) {
+    case EV_DETENT:
       wakeUp();
-      accum += dir;
-      if (accum >= STEPS_PER_DETENT) {
-        selectedIconIndex = (selectedIconIndex + 1) % NUM_ICONS;
-        accum = 0;
-        drawIconMenu();
-      } else if (accum <= -STEPS_PER_DETENT) {
-        selectedIconIndex = (selectedIconIndex - 1 + NUM_ICONS) % NUM_ICONS;
-        accum = 0;
-        drawIconMenu();
-      }
-    }
-    lastAB = nowAB;
+      selectedIconIndex = ((selectedIconIndex + e.value) % NUM_ICONS + NUM_ICONS) % NUM_ICONS;
+      paintIconMenu();
+      return;
+    case EV_BUTTON_SHORT:
+    case EV_BUTTON_LONG:
+    case EV_BUTTON_VERY_LONG:
+      break; // Activation de l'icône choisie, ci-dessous
+    default:
+      return;
   }
 
-
-  if (digitalRead(ENC_SW) == LOW && (millis() - lastClickMs > CLICK_DEBOUNCE_MS)) {
-    lastClickMs = millis();
-    while(digitalRead(ENC_SW) == LOW) { delay(10); }
-
-    switch (selectedIconIndex) {
-      case 0: showMessage("Profil: General"); currentLayer = 0; currentEncoderMode = MODE_VOLUME; break;
-      case 1: showMessage("Profil: Navigation"); currentEncoderMode = MODE_SCROLL; break;
-      case 2: showMessage("Profil: Edition"); currentLayer = 1; currentEncoderMode = MODE_UNDO_REDO; break;
-      case 3: showMessage("Profil: Media"); currentLayer = 2; currentEncoderMode = MODE_VOLUME; break;
-
-      case 4: // Icône WiFi
-        openViaRun("ms-settings:network-wifi");
-        displayCustomScreen("PARAMETRES WIFI", icon_menu_wifi_16x16, 18, 2);
-        delay(2000);
-        returnToIconMenu();
-        return;
-
-      case 5: // Icône Bluetooth
-        openViaRun("ms-settings:bluetooth");
-        displayCustomScreen("PARAMETRES BLUETOOTH", icon_menu_bluetooth_16x16, 5, 2);
-        delay(2000);
-        returnToIconMenu();
-        return;
-      
-      case 6: showMessage("Profil: Macros"); currentLayer = 0; currentEncoderMode = MODE_VOLUME; break;
-      case 7: isInMenu = true; currentState = STATE_NORMAL; wakeUp(); drawMenu(); return;
-    }
-
+  const MenuNode& item = ICON_MENU[selectedIconIndex];
+  if (item.type == MENU_SUBMENU) { // Paramètres : le menu de configuration
     currentState = STATE_NORMAL;
     wakeUp();
-    drawIconMenu();
-    delay(1000);
-    showVolume();
+    menuOpen(item);
+    return;
   }
-}
\ No newline at end of file
+  menuRun(item);
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
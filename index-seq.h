@@ -0,0 +1,18 @@
+#pragma once
+#include <stddef.h>
+
+// =============================================================================
+//     SUITES D'INDICES À LA COMPILATION
+// =============================================================================
+// Les tables calculées à la compilation (icônes, textes pré-rendus, menus,
+// index des accords) se remplissent case par case :
+//   f(IndexSeq<I...>) { return T{ { g(I)... } }; }   // I = 0, 1, ..., N - 1
+// std::index_sequence n'existe qu'à partir de C++14, et le core ESP32
+// compile en gnu++11 : MakeIndexSeq<N>::type en tient lieu.
+// -----------------------------------------------------------------------------
+
+template <size_t... I> struct IndexSeq {};
+template <size_t N, size_t... I> struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeIndexSeq<0, I...> { typedef IndexSeq<I...> type; };
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,150 @@
+#pragma once
+#include "debounce.h"
+#include "encoder.h"
+
+// =============================================================================
+//     MODULE DES ÉVÉNEMENTS D'ENTRÉE
+// =============================================================================
+// Une seule couche lit les entrées, une fois par tour de loop(), quel que
+// soit l'écran actif : touches et bouton de l'encodeur passent par
+// l'anti-rebond (debounce.h), les crans par la file de l'interruption
+// (encoder.h). Elle en tire des événements typés, rangés dans une file de
+// taille fixe ; chaque écran n'est plus qu'un gestionnaire qui les consomme
+// (voir dispatchInput() dans le fichier principal). Plus aucun écran ne lit
+// une broche lui-même ni n'attend dans sa propre boucle.
+//
+// Le bouton de l'encodeur :
+//   appui < INPUT_LONG_PRESS_MS, relâché           -> EV_BUTTON_SHORT
+//   appui >= INPUT_LONG_PRESS_MS, relâché          -> EV_BUTTON_LONG
+//   toujours tenu après INPUT_VERY_LONG_PRESS_MS   -> EV_BUTTON_VERY_LONG
+//                                                     (rien au relâchement)
+// -----------------------------------------------------------------------------
+
+enum InputEventType : uint8_t {
+  EV_KEY_DOWN,          // value = touche (0 à NUM_KEYS-1)
+  EV_KEY_UP,            // value = touche
+  EV_DETENT,            // value = +1 ou -1 : un cran complet
+  EV_ROTATE,            // value = quarts de cran parcourus depuis le balayage précédent
+  EV_BUTTON_SHORT,
+  EV_BUTTON_LONG,
+  EV_BUTTON_VERY_LONG
+};
+
+struct InputEvent {
+  uint32_t timeUs;      // Date de détection (micros()), pour le profilage
+  int16_t value;
+  InputEventType type;
+};
+
+const uint8_t INPUT_QUEUE_SIZE = 32; // Puissance de 2 obligatoire
+static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0, "INPUT_QUEUE_SIZE doit etre une puissance de 2");
+
+const unsigned long INPUT_LONG_PRESS_MS = 500;       // Appui long (changement de mode)
+const unsigned long INPUT_VERY_LONG_PRESS_MS = 1500; // Appui très long (menu de configuration)
+
+// --- Variables propres à ce module ---
+InputEvent inputQueue[INPUT_QUEUE_SIZE];
+uint8_t inputHead = 0, inputTail = 0;
+uint32_t inputOverflows = 0;          // Événements perdus, file pleine
+uint8_t inputButtonLine = 0;          // Ligne du bouton dans l'anti-rebond (après les touches)
+bool inputButtonHeld = false;
+bool inputVeryLongSent = false;
+unsigned long inputButtonDownMs = 0;
+int32_t inputLastRawPosition = 0;     // Position de l'encodeur au balayage précédent
+
+void inputPush(InputEventType type, int16_t value, uint32_t timeUs) {
+  if ((uint8_t)(inputHead - inputTail) >= INPUT_QUEUE_SIZE) {
+    inputOverflows++;
+    return;
+  }
+  InputEvent& e = inputQueue[inputHead & (INPUT_QUEUE_SIZE - 1)];
+  e.type = type;
+  e.value = value;
+  e.timeUs = timeUs;
+  inputHead++;
+}
+
+/**
+ * @brief Retire le plus ancien événement de la file.
+ * @param event Reçoit l'événement.
+ * @return false si la file est vide.
+ */
+bool inputPop(InputEvent& event) {
+  if (inputHead == inputTail) return false;
+  event = inputQueue[inputTail & (INPUT_QUEUE_SIZE - 1)];
+  inputTail++;
+  return true;
+}
+
+// Vrai si aucun événement n'attend et qu'aucune entrée n'est en cours de
+// validation : la boucle peut céder le processeur.
+bool inputIdle() {
+  return inputHead == inputTail && !keySettling();
+}
+
+/**
+ * @brief Configure les touches et le bouton de l'encodeur (un seul anti-rebond).
+ * @param keyPins Les broches des touches.
+ * @param keyModes Le mode d'anti-rebond de chaque touche.
+ * @param keyCount Le nombre de touches.
+ * @param buttonPin La broche du bouton de l'encodeur (filtré en mode différé).
+ */
+void inputBegin(const uint8_t* keyPins, const DebounceMode* keyModes, uint8_t keyCount, uint8_t buttonPin) {
+  uint8_t pins[MAX_SCAN_KEYS];
+  DebounceMode modes[MAX_SCAN_KEYS];
+  keyCount = min(keyCount, (uint8_t)(MAX_SCAN_KEYS - 1));
+  memcpy(pins, keyPins, keyCount);
+  memcpy(modes, keyModes, keyCount * sizeof(DebounceMode));
+  pins[keyCount] = buttonPin;
+  modes[keyCount] = DEBOUNCE_DEFERRED;
+  inputButtonLine = keyCount;
+  keyScanBegin(pins, modes, keyCount + 1);
+  inputLastRawPosition = encoderRawPosition;
+}
+
+/**
+ * @brief Lit les entrées et range les événements ; à appeler à chaque tour de loop().
+ */
+void inputScan() {
+  keyScan(); // Un échantillon au plus toutes les DEBOUNCE_SAMPLE_US
+  const uint32_t buttonBit = 1UL << inputButtonLine;
+  uint32_t presses = keyTakePresses();
+  uint32_t releases = keyTakeReleases();
+
+  // Touches
+  for (uint32_t keys = presses & ~buttonBit; keys; keys &= keys - 1) {
+    inputPush(EV_KEY_DOWN, __builtin_ctz(keys), lastKeySampleUs);
+  }
+  for (uint32_t keys = releases & ~buttonBit; keys; keys &= keys - 1) {
+    inputPush(EV_KEY_UP, __builtin_ctz(keys), lastKeySampleUs);
+  }
+
+  // Bouton de l'encodeur : durée de l'appui
+  unsigned long now = millis();
+  if (presses & buttonBit) {
+    inputButtonHeld = true;
+    inputVeryLongSent = false;
+    inputButtonDownMs = now;
+  }
+  if (inputButtonHeld && !inputVeryLongSent && now - inputButtonDownMs >= INPUT_VERY_LONG_PRESS_MS) {
+    inputPush(EV_BUTTON_VERY_LONG, 0, micros());
+    inputVeryLongSent = true;
+  }
+  if ((releases & buttonBit) && inputButtonHeld) {
+    inputButtonHeld = false;
+    if (!inputVeryLongSent) {
+      inputPush(now - inputButtonDownMs >= INPUT_LONG_PRESS_MS ? EV_BUTTON_LONG : EV_BUTTON_SHORT, 0, lastKeySampleUs);
+    }
+  }
+
+  // Encodeur : les crans complets, puis le déplacement fin (quarts de cran)
+  EncoderStep step;
+  while (encoderPop(step)) inputPush(EV_DETENT, step.delta, step.timeUs);
+  int32_t rawPosition = encoderRawPosition;
+  if (rawPosition != inputLastRawPosition) {
+    inputPush(EV_ROTATE, (int16_t)(rawPosition - inputLastRawPosition), micros());
+    inputLastRawPosition = rawPosition;
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,211 @@
+#pragma once
+#include <USBHIDKeyboard.h>
+
+// =============================================================================
+//     MODULE DES DISPOSITIONS CLAVIER (FR, US, DE...)
+// =============================================================================
+// Le macropad envoie des codes de touches HID, pas des caractères : pour
+// taper "é" ou ":" il faut savoir quelle touche les produit sur le clavier
+// de l'ordinateur hôte. Chaque disposition est une table de 256 entrées
+// (caractère Latin-1 -> touche) : une seule lecture par caractère, aucune
+// chaîne construite, aucune allocation.
+//
+// Format d'une entrée (16 bits) :
+//   bits 0-7   : usage HID de la touche (0 = caractère impossible)
+//   bit 8      : Shift
+//   bit 9      : AltGr
+//   bits 12-14 : touche morte à taper avant (index dans KB_DEAD_xxx, 0 = aucune)
+//
+// Les textes des macros sont écrits en UTF-8 dans le code source ; les
+// caractères accentués (U+0080 à U+00FF) sont décodés à la volée.
+// Les tables ci-dessous sont générées par tools/kb_layouts.py : modifier la
+// description des touches dans ce script, puis le relancer.
+// -----------------------------------------------------------------------------
+
+extern USBHIDKeyboard Keyboard;
+
+enum KeyboardLayoutId : uint8_t {
+  LAYOUT_US,       // QWERTY américain
+  LAYOUT_US_INTL,  // QWERTY américain international (touches mortes ' " ` ~ ^)
+  LAYOUT_UK,       // QWERTY britannique
+  LAYOUT_FR,       // AZERTY français
+  LAYOUT_DE,       // QWERTZ allemand
+  LAYOUT_COUNT
+};
+
+// Disposition du clavier de l'ordinateur hôte (modifiable à l'exécution).
+KeyboardLayoutId hostLayout = LAYOUT_FR;
+
+const uint16_t KB_SHIFT = 0x0100;
+const uint16_t KB_ALTGR = 0x0200;
+const uint8_t HID_MOD_LSHIFT = 0x02;
+const uint8_t HID_MOD_RALT = 0x40;   // AltGr
+
+// US : touches mortes aucune
+constexpr uint16_t KB_MAP_US[256] PROGMEM = {
+  /* 0x00 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x002A, 0x002B, 0x0028, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x10 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x20 */ 0x002C, 0x011E, 0x0134, 0x0120, 0x0121, 0x0122, 0x0124, 0x0034, 0x0126, 0x0127, 0x0125, 0x012E, 0x0036, 0x002D, 0x0037, 0x0038,
+  /* 0x30 */ 0x0027, 0x001E, 0x001F, 0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0133, 0x0033, 0x0136, 0x002E, 0x0137, 0x0138,
+  /* 0x40 */ 0x011F, 0x0104, 0x0105, 0x0106, 0x0107, 0x0108, 0x0109, 0x010A, 0x010B, 0x010C, 0x010D, 0x010E, 0x010F, 0x0110, 0x0111, 0x0112,
+  /* 0x50 */ 0x0113, 0x0114, 0x0115, 0x0116, 0x0117, 0x0118, 0x0119, 0x011A, 0x011B, 0x011C, 0x011D, 0x002F, 0x0031, 0x0030, 0x0123, 0x012D,
+  /* 0x60 */ 0x0035, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, 0x0010, 0x0011, 0x0012,
+  /* 0x70 */ 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001A, 0x001B, 0x001C, 0x001D, 0x012F, 0x0131, 0x0130, 0x0135, 0x0000,
+  /* 0x80 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x90 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xA0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xB0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xC0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xD0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xE0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xF0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+constexpr uint16_t KB_DEAD_US[8] PROGMEM = { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 };
+
+// US_INTL : touches mortes 1 = '^', 2 = ''', 3 = '"', 4 = '`', 5 = '~'
+constexpr uint16_t KB_MAP_US_INTL[256] PROGMEM = {
+  /* 0x00 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x002A, 0x002B, 0x0028, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x10 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x20 */ 0x002C, 0x011E, 0x302C, 0x0120, 0x0121, 0x0122, 0x0124, 0x202C, 0x0126, 0x0127, 0x0125, 0x012E, 0x0036, 0x002D, 0x0037, 0x0038,
+  /* 0x30 */ 0x0027, 0x001E, 0x001F, 0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0133, 0x0033, 0x0136, 0x002E, 0x0137, 0x0138,
+  /* 0x40 */ 0x011F, 0x0104, 0x0105, 0x0106, 0x0107, 0x0108, 0x0109, 0x010A, 0x010B, 0x010C, 0x010D, 0x010E, 0x010F, 0x0110, 0x0111, 0x0112,
+  /* 0x50 */ 0x0113, 0x0114, 0x0115, 0x0116, 0x0117, 0x0118, 0x0119, 0x011A, 0x011B, 0x011C, 0x011D, 0x002F, 0x0031, 0x0030, 0x102C, 0x012D,
+  /* 0x60 */ 0x402C, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, 0x0010, 0x0011, 0x0012,
+  /* 0x70 */ 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001A, 0x001B, 0x001C, 0x001D, 0x012F, 0x0131, 0x0130, 0x502C, 0x0000,
+  /* 0x80 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x90 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xA0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xB0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xC0 */ 0x4104, 0x2104, 0x1104, 0x5104, 0x3104, 0x0000, 0x0000, 0x2106, 0x4108, 0x2108, 0x1108, 0x3108, 0x410C, 0x210C, 0x110C, 0x310C,
+  /* 0xD0 */ 0x0000, 0x5111, 0x4112, 0x2112, 0x1112, 0x5112, 0x3112, 0x0000, 0x0000, 0x4118, 0x2118, 0x1118, 0x3118, 0x211C, 0x0000, 0x0000,
+  /* 0xE0 */ 0x4004, 0x2004, 0x1004, 0x5004, 0x3004, 0x0000, 0x0000, 0x2006, 0x4008, 0x2008, 0x1008, 0x3008, 0x400C, 0x200C, 0x100C, 0x300C,
+  /* 0xF0 */ 0x0000, 0x5011, 0x4012, 0x2012, 0x1012, 0x5012, 0x3012, 0x0000, 0x0000, 0x4018, 0x2018, 0x1018, 0x3018, 0x201C, 0x0000, 0x301C,
+};
+constexpr uint16_t KB_DEAD_US_INTL[8] PROGMEM = { 0x0000, 0x0123, 0x0034, 0x0134, 0x0035, 0x0135, 0x0000, 0x0000 };
+
+// UK : touches mortes aucune
+constexpr uint16_t KB_MAP_UK[256] PROGMEM = {
+  /* 0x00 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x002A, 0x002B, 0x0028, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x10 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x20 */ 0x002C, 0x011E, 0x011F, 0x0032, 0x0121, 0x0122, 0x0124, 0x0034, 0x0126, 0x0127, 0x0125, 0x012E, 0x0036, 0x002D, 0x0037, 0x0038,
+  /* 0x30 */ 0x0027, 0x001E, 0x001F, 0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0133, 0x0033, 0x0136, 0x002E, 0x0137, 0x0138,
+  /* 0x40 */ 0x0134, 0x0104, 0x0105, 0x0106, 0x0107, 0x0108, 0x0109, 0x010A, 0x010B, 0x010C, 0x010D, 0x010E, 0x010F, 0x0110, 0x0111, 0x0112,
+  /* 0x50 */ 0x0113, 0x0114, 0x0115, 0x0116, 0x0117, 0x0118, 0x0119, 0x011A, 0x011B, 0x011C, 0x011D, 0x002F, 0x0064, 0x0030, 0x0123, 0x012D,
+  /* 0x60 */ 0x0035, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, 0x0010, 0x0011, 0x0012,
+  /* 0x70 */ 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001A, 0x001B, 0x001C, 0x001D, 0x012F, 0x0164, 0x0130, 0x0132, 0x0000,
+  /* 0x80 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x90 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xA0 */ 0x0000, 0x0000, 0x0000, 0x0120, 0x0000, 0x0000, 0x0235, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0135, 0x0000, 0x0000, 0x0000,
+  /* 0xB0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xC0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xD0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xE0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xF0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+constexpr uint16_t KB_DEAD_UK[8] PROGMEM = { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 };
+
+// FR : touches mortes 1 = '~', 2 = '`', 3 = '^', 4 = '¨'
+constexpr uint16_t KB_MAP_FR[256] PROGMEM = {
+  /* 0x00 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x002A, 0x002B, 0x0028, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x10 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x20 */ 0x002C, 0x0038, 0x0020, 0x0220, 0x0030, 0x0134, 0x001E, 0x0021, 0x0022, 0x002D, 0x0032, 0x012E, 0x0010, 0x0023, 0x0136, 0x0137,
+  /* 0x30 */ 0x0127, 0x011E, 0x011F, 0x0120, 0x0121, 0x0122, 0x0123, 0x0124, 0x0125, 0x0126, 0x0037, 0x0036, 0x0064, 0x002E, 0x0164, 0x0110,
+  /* 0x40 */ 0x0227, 0x0114, 0x0105, 0x0106, 0x0107, 0x0108, 0x0109, 0x010A, 0x010B, 0x010C, 0x010D, 0x010E, 0x010F, 0x0133, 0x0111, 0x0112,
+  /* 0x50 */ 0x0113, 0x0104, 0x0115, 0x0116, 0x0117, 0x0118, 0x0119, 0x011D, 0x011B, 0x011C, 0x011A, 0x0222, 0x0225, 0x022D, 0x0226, 0x0025,
+  /* 0x60 */ 0x202C, 0x0014, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, 0x0033, 0x0011, 0x0012,
+  /* 0x70 */ 0x0013, 0x0004, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001D, 0x001B, 0x001C, 0x001A, 0x0221, 0x0223, 0x022E, 0x102C, 0x0000,
+  /* 0x80 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x90 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xA0 */ 0x0000, 0x0000, 0x0000, 0x0130, 0x0230, 0x0000, 0x0000, 0x0138, 0x402C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xB0 */ 0x012D, 0x0000, 0x0035, 0x0000, 0x0000, 0x0132, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xC0 */ 0x2114, 0x0000, 0x3114, 0x1114, 0x4114, 0x0000, 0x0000, 0x0000, 0x2108, 0x0000, 0x3108, 0x4108, 0x210C, 0x0000, 0x310C, 0x410C,
+  /* 0xD0 */ 0x0000, 0x1111, 0x2112, 0x0000, 0x3112, 0x1112, 0x4112, 0x0000, 0x0000, 0x2118, 0x0000, 0x3118, 0x4118, 0x0000, 0x0000, 0x0000,
+  /* 0xE0 */ 0x0027, 0x0000, 0x3014, 0x1014, 0x4014, 0x0000, 0x0000, 0x0026, 0x0024, 0x001F, 0x3008, 0x4008, 0x200C, 0x0000, 0x300C, 0x400C,
+  /* 0xF0 */ 0x0000, 0x1011, 0x2012, 0x0000, 0x3012, 0x1012, 0x4012, 0x0000, 0x0000, 0x0034, 0x0000, 0x3018, 0x4018, 0x0000, 0x0000, 0x401C,
+};
+constexpr uint16_t KB_DEAD_FR[8] PROGMEM = { 0x0000, 0x021F, 0x0224, 0x002F, 0x012F, 0x0000, 0x0000, 0x0000 };
+
+// DE : touches mortes 1 = '´', 2 = '`', 3 = '^'
+constexpr uint16_t KB_MAP_DE[256] PROGMEM = {
+  /* 0x00 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x002A, 0x002B, 0x0028, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x10 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x20 */ 0x002C, 0x011E, 0x011F, 0x0032, 0x0121, 0x0122, 0x0123, 0x0132, 0x0125, 0x0126, 0x0130, 0x0030, 0x0036, 0x0038, 0x0037, 0x0124,
+  /* 0x30 */ 0x0027, 0x001E, 0x001F, 0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0137, 0x0136, 0x0064, 0x0127, 0x0164, 0x012D,
+  /* 0x40 */ 0x0214, 0x0104, 0x0105, 0x0106, 0x0107, 0x0108, 0x0109, 0x010A, 0x010B, 0x010C, 0x010D, 0x010E, 0x010F, 0x0110, 0x0111, 0x0112,
+  /* 0x50 */ 0x0113, 0x0114, 0x0115, 0x0116, 0x0117, 0x0118, 0x0119, 0x011A, 0x011B, 0x011D, 0x011C, 0x0225, 0x022D, 0x0226, 0x302C, 0x0138,
+  /* 0x60 */ 0x202C, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, 0x0010, 0x0011, 0x0012,
+  /* 0x70 */ 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001A, 0x001B, 0x001D, 0x001C, 0x0224, 0x0264, 0x0227, 0x0230, 0x0000,
+  /* 0x80 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0x90 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xA0 */ 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0120, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xB0 */ 0x0135, 0x0000, 0x021F, 0x0220, 0x102C, 0x0210, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  /* 0xC0 */ 0x2104, 0x1104, 0x3104, 0x0000, 0x0134, 0x0000, 0x0000, 0x0000, 0x2108, 0x1108, 0x3108, 0x0000, 0x210C, 0x110C, 0x310C, 0x0000,
+  /* 0xD0 */ 0x0000, 0x0000, 0x2112, 0x1112, 0x3112, 0x0000, 0x0133, 0x0000, 0x0000, 0x2118, 0x1118, 0x3118, 0x012F, 0x111D, 0x0000, 0x002D,
+  /* 0xE0 */ 0x2004, 0x1004, 0x3004, 0x0000, 0x0034, 0x0000, 0x0000, 0x0000, 0x2008, 0x1008, 0x3008, 0x0000, 0x200C, 0x100C, 0x300C, 0x0000,
+  /* 0xF0 */ 0x0000, 0x0000, 0x2012, 0x1012, 0x3012, 0x0000, 0x0033, 0x0000, 0x0000, 0x2018, 0x1018, 0x3018, 0x002F, 0x101D, 0x0000, 0x0000,
+};
+constexpr uint16_t KB_DEAD_DE[8] PROGMEM = { 0x0000, 0x002E, 0x012E, 0x0035, 0x0000, 0x0000, 0x0000, 0x0000 };
+
+struct KeyboardLayout {
+  const char* name;
+  const uint16_t* map;    // 256 entrées
+  const uint16_t* dead;   // 8 entrées, index 0 inutilisé
+};
+
+const KeyboardLayout KEYBOARD_LAYOUTS[LAYOUT_COUNT] = {
+  { "us",      KB_MAP_US,      KB_DEAD_US },
+  { "us-intl", KB_MAP_US_INTL, KB_DEAD_US_INTL },
+  { "uk",      KB_MAP_UK,      KB_DEAD_UK },
+  { "fr",      KB_MAP_FR,      KB_DEAD_FR },
+  { "de",      KB_MAP_DE,      KB_DEAD_DE },
+};
+
+// Une frappe : modificateurs + une touche, prête pour un rapport HID.
+struct KeyStroke {
+  uint8_t modifiers;
+  uint8_t usage;
+};
+
+inline KeyStroke layoutEntryToStroke(uint16_t entry) {
+  KeyStroke s;
+  s.usage = entry & 0xFF;
+  s.modifiers = ((entry & KB_SHIFT) ? HID_MOD_LSHIFT : 0) | ((entry & KB_ALTGR) ? HID_MOD_RALT : 0);
+  return s;
+}
+
+/**
+ * @brief Lit le prochain caractère d'un texte UTF-8.
+ * @param p Position dans le texte, avancée après le caractère.
+ * @return Le code Latin-1 (0-255), ou -1 pour un caractère hors Latin-1.
+ *         Retourne 0 en fin de texte (p n'avance plus).
+ */
+int16_t utf8NextLatin1(const char*& p) {
+  uint8_t c = (uint8_t)*p;
+  if (c == 0) return 0;
+  p++;
+  if (c < 0x80) return c;
+  if ((c & 0xE0) == 0xC0 && c <= 0xC3 && ((uint8_t)*p & 0xC0) == 0x80) {
+    return ((c & 0x1F) << 6) | ((uint8_t)*p++ & 0x3F);
+  }
+  while (((uint8_t)*p & 0xC0) == 0x80) p++; // Saute la suite d'une séquence plus longue
+  return -1;
+}
+
+/**
+ * @brief Traduit un caractère en frappes sur la disposition donnée.
+ * @param layout La disposition de l'hôte.
+ * @param ch Le caractère Latin-1.
+ * @param out Reçoit 0, 1 ou 2 frappes (touche morte puis touche de base).
+ * @return Le nombre de frappes (0 si le caractère est impossible à taper).
+ */
+uint8_t layoutCharToStrokes(const KeyboardLayout& layout, uint8_t ch, KeyStroke out[2]) {
+  uint16_t entry = layout.map[ch];
+  if ((entry & 0xFF) == 0) return 0;
+  uint8_t n = 0;
+  uint8_t dead = (entry >> 12) & 0x07;
+  if (dead != 0) out[n++] = layoutEntryToStroke(layout.dead[dead]);
+  out[n++] = layoutEntryToStroke(entry);
+  return n;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
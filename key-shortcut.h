@@ -1,11 +1,14 @@
 #pragma once
 #include <USBHIDKeyboard.h>
+#include "macro-executor.h"
 
 // =============================================================================
 //     MODULE DES RACCOURCIS CLAVIER
 // =============================================================================
 // Ce fichier contient toutes les fonctions qui simulent des frappes
 // ou des raccourcis clavier complexes.
+// Chaque fonction met sa séquence en file (macro-executor.h) et rend la main
+// immédiatement : les attentes sont jouées par macroTick() depuis loop().
 // -----------------------------------------------------------------------------
 
 extern USBHIDKeyboard Keyboard;
@@ -15,7 +18,6 @@ extern USBHIDKeyboard Keyboard;
 // pour que ce fichier sache qu'elles existent.
 void showMessage(const char* msg);
 void wakeUp();
-String fr2en(String text);
 
 
 // --- Définition des fonctions de raccourcis ---
@@ -23,56 +25,84 @@ String fr2en(String text);
 /**
  * @brief Ouvre une application via le raccourci clavier Exécuter (Win+R).
  * @param textToRun La commande à exécuter (ex: "notepad.exe", "invite de commandes").
+ *        Le texte doit rester valide pendant la frappe (chaîne littérale).
+ * @param track La piste sur laquelle jouer la séquence.
  */
-void openViaRun(const char* textToRun) {
+void openViaRun(const char* textToRun, MacroTrackId track = MACRO_TRACK_KEYS) {
+  if (!macroReserve(track, 9)) return;
   // 1. Ouvre la fenêtre "Exécuter"
-  String converted = fr2en(String(textToRun));
-  Keyboard.press(KEY_LEFT_GUI);
-  Keyboard.press('r');
-  delay(120);
-  Keyboard.releaseAll();
-  delay(300);
-  // 2. Valide avec la touche Entrée
-  Keyboard.print(converted); 
-  Keyboard.write(KEY_RETURN);
+  macroPress(track, KEY_LEFT_GUI);
+  macroPress(track, 'r');
+  macroWait(track, 120);
+  macroRelease(track, 'r');
+  macroRelease(track, KEY_LEFT_GUI);
+  macroWait(track, 300);
+  // 2. Tape la commande puis valide avec la touche Entrée
+  macroType(track, textToRun);
+  macroPress(track, KEY_RETURN);
+  macroRelease(track, KEY_RETURN);
 }
 
 // Simule le raccourci clavier Alt + Tab.
-void sendAltTab() {
+void sendAltTab(MacroTrackId track = MACRO_TRACK_KEYS) {
   wakeUp();
   showMessage("Alt + Tab");
-  Keyboard.press(KEY_LEFT_ALT);
-  Keyboard.press(KEY_TAB);
-  delay(50);
-  Keyboard.releaseAll();
+  if (!macroReserve(track, 5)) return;
+  macroPress(track, KEY_LEFT_ALT);
+  macroPress(track, KEY_TAB);
+  macroWait(track, 50);
+  macroRelease(track, KEY_TAB);
+  macroRelease(track, KEY_LEFT_ALT);
 }
 
 // Simule le raccourci clavier Win + D (afficher le bureau).
-void sendWinD() {
+void sendWinD(MacroTrackId track = MACRO_TRACK_KEYS) {
   wakeUp();
   showMessage("Win + D");
-  Keyboard.press(KEY_LEFT_GUI); // 'GUI' est la touche Windows
-  Keyboard.press('d');
-  delay(50);
-  Keyboard.releaseAll();
+  if (!macroReserve(track, 5)) return;
+  macroPress(track, KEY_LEFT_GUI); // 'GUI' est la touche Windows
+  macroPress(track, 'd');
+  macroWait(track, 50);
+  macroRelease(track, 'd');
+  macroRelease(track, KEY_LEFT_GUI);
 }
 
 // Simule le raccourci clavier Ctrl + [touche].
-void sendCombo_Ctrl(char k) {
-  Keyboard.press(KEY_LEFT_CTRL);
-  Keyboard.press(k);
-  delay(40);
-  Keyboard.release(k);
-  Keyboard.release(KEY_LEFT_CTRL);
+void sendCombo_Ctrl(char k, MacroTrackId track = MACRO_TRACK_KEYS) {
+  if (!macroReserve(track, 5)) return;
+  macroPress(track, KEY_LEFT_CTRL);
+  macroPress(track, k);
+  macroWait(track, 40);
+  macroRelease(track, k);
+  macroRelease(track, KEY_LEFT_CTRL);
+}
+
+/**
+ * @brief Ctrl + [touche] répété 'count' fois (crans de l'encodeur).
+ * Une seule étape en file, rejouée une fois par tour ; les crans suivants
+ * dans le même sens s'y ajoutent au lieu d'occuper la file.
+ */
+void repeatCombo_Ctrl(char k, uint8_t count, MacroTrackId track = MACRO_TRACK_KEYS) {
+  macroRepeat(track, STEP_COMBO, k, 0x01 /* Ctrl gauche */, count);
 }
 
 // Simule le raccourci clavier Ctrl + Shift + [touche].
-void sendCombo_CtrlShift(char k) {
-  Keyboard.press(KEY_LEFT_CTRL);
-  Keyboard.press(KEY_LEFT_SHIFT);
-  Keyboard.press(k);
-  delay(40);
-  Keyboard.releaseAll(); // Utiliser releaseAll() est plus sûr ici
+void sendCombo_CtrlShift(char k, MacroTrackId track = MACRO_TRACK_KEYS) {
+  if (!macroReserve(track, 7)) return;
+  macroPress(track, KEY_LEFT_CTRL);
+  macroPress(track, KEY_LEFT_SHIFT);
+  macroPress(track, k);
+  macroWait(track, 40);
+  // Relâchement touche par touche : une autre piste peut tenir ses propres touches
+  macroRelease(track, k);
+  macroRelease(track, KEY_LEFT_SHIFT);
+  macroRelease(track, KEY_LEFT_CTRL);
+}
+
+// Envoie une touche multimédia (Play/Pause, Suivant, Volume...).
+void sendConsumer(uint16_t usage, MacroTrackId track = MACRO_TRACK_KEYS) {
+  if (!macroReserve(track, 1)) return;
+  macroConsumer(track, usage);
 }
 
-/* ------------------------------ Fin du code -------------------------------- */
\ No newline at end of file
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,283 @@
+#pragma once
+#include <esp_partition.h>
+
+// =============================================================================
+//     MODULE DES TOUCHES REDÉFINIES ET ICÔNES UTILISATEUR
+// =============================================================================
+// La table KEYMAP de config.h reste la configuration de base. Par-dessus,
+// chaque touche de chaque couche peut être redéfinie à chaud depuis
+// l'ordinateur (protocol.h) par un KeyRecord (keymap.h). Une case de type
+// KIND_FIRMWARE (valeur 0) garde l'action de KEYMAP.
+//
+// Les redéfinitions sont rangées en Flash, dans la partition "keymap" de
+// partitions.csv, et lues directement en Flash (esp_partition_mmap) : pas
+// d'analyse, pas de copie en RAM, et elles survivent au redémarrage.
+// La partition a deux emplacements. Une nouvelle table est écrite dans
+// l'emplacement inactif ; son en-tête (avec un numéro de génération et le
+// CRC-32 des enregistrements) est écrit en dernier. L'emplacement valide le
+// plus récent devient actif entre deux tours de loop() (keymapStoreTick()),
+// sans redémarrage ni nouvelle énumération USB. Une écriture interrompue
+// laisse l'ancienne table en place (vérifié sur PC, partition dans un
+// fichier projeté en mémoire : host/tests/keymap-store-test.cpp).
+//
+// Les icônes sont désignées par un index : les icônes 16x16 du firmware
+// (KEY_ICONS), puis, à partir de USER_ICON_BASE, des emplacements en RAM
+// remplis depuis l'ordinateur.
+//
+// Dépend de KEYMAP et NUM_LAYERS (config.h) : à inclure après.
+// -----------------------------------------------------------------------------
+
+// Icônes 16x16 du firmware utilisables par une touche redéfinie.
+const unsigned char* const KEY_ICONS[] = {
+  icon_menu_pc_16x16, icon_menu_souris_16x16, icon_menu_clavier_16x16, icon_menu_audio_16x16,
+  icon_menu_wifi_16x16, icon_menu_bluetooth_16x16, icon_menu_macros_16x16, icon_menu_parametres_16x16,
+  icon_layer_0_16x16, icon_layer_1_16x16, icon_layer_2_16x16, icon_layer_3_16x16,
+  icon_mute_16x16, icon_sound_16x16, icon_scroll_16x16, icon_undo_redo_16x16,
+  icon_notpad_16x16
+};
+const uint8_t NUM_KEY_ICONS = sizeof(KEY_ICONS) / sizeof(KEY_ICONS[0]);
+
+const uint8_t USER_ICON_BASE = 0x80;   // Index de la première icône utilisateur
+const uint8_t USER_ICON_SLOTS = 4;
+const uint8_t ICON_BYTES = 32;         // 16x16, format drawBitmap (2 octets par ligne)
+static_assert(NUM_KEY_ICONS < USER_ICON_BASE, "Trop d'icones firmware");
+
+// --- Partition des tables de touches ---
+const esp_partition_subtype_t KEYMAP_PARTITION_SUBTYPE = (esp_partition_subtype_t)0x40; // Voir partitions.csv
+const uint32_t KEYMAP_SLOT_SIZE = 0x10000;     // Un emplacement = une page de 64 Ko de la MMU
+const uint32_t KEYMAP_MAGIC = 0x50414D4B;      // "KMAP"
+const uint16_t KEYMAP_RECORD_COUNT = NUM_LAYERS * NUM_KEYS;
+const uint32_t KEYMAP_RECORDS_SIZE = KEYMAP_RECORD_COUNT * sizeof(KeyRecord);
+
+// En-tête d'un emplacement, suivi de KEYMAP_RECORD_COUNT KeyRecord.
+struct KeymapSlotHeader {
+  uint32_t magic;       // KEYMAP_MAGIC (0xFFFFFFFF = emplacement effacé)
+  uint32_t generation;  // Le plus grand gagne
+  uint16_t layers;      // Doit valoir NUM_LAYERS
+  uint16_t keys;        // Doit valoir NUM_KEYS
+  uint32_t crc;         // CRC-32 des enregistrements
+};
+static_assert(sizeof(KeymapSlotHeader) % 16 == 0, "Les enregistrements doivent rester alignes");
+static_assert(sizeof(KeymapSlotHeader) + KEYMAP_RECORDS_SIZE <= KEYMAP_SLOT_SIZE, "La table ne tient pas dans un emplacement");
+
+// --- Variables propres à ce module ---
+uint8_t userIcons[USER_ICON_SLOTS][ICON_BYTES];
+const esp_partition_t* keymapPartition = nullptr;
+const uint8_t* keymapFlash = nullptr;          // Les deux emplacements, projetés en mémoire
+const KeyRecord* keymapRecords = nullptr;      // Table active (nullptr = KEYMAP seule)
+int8_t keymapActiveSlot = -1;
+int8_t keymapPendingSlot = -1;                 // Emplacement à activer au prochain tour
+int8_t keymapWriteSlot = -1;                   // Emplacement en cours d'écriture
+uint32_t keymapWriteCrc = 0;                   // CRC-32 de ce qui a été écrit
+uint32_t keymapGeneration = 0;                 // Génération de la table active
+
+// CRC-32 (celui de zlib), à enchaîner : crc32(crc32(0, a), b) = crc32(0, a + b).
+uint32_t crc32(uint32_t crc, const uint8_t* data, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// Index d'icône -> données (nullptr si aucune).
+const unsigned char* keyIcon(uint8_t index) {
+  if (index < NUM_KEY_ICONS) return KEY_ICONS[index];
+  if (index >= USER_ICON_BASE && index < USER_ICON_BASE + USER_ICON_SLOTS) return userIcons[index - USER_ICON_BASE];
+  return nullptr;
+}
+
+// Données d'icône -> index (KEY_NO_ICON si inconnue).
+uint8_t keyIconIndex(const unsigned char* icon) {
+  for (uint8_t i = 0; i < NUM_KEY_ICONS; i++) {
+    if (KEY_ICONS[i] == icon) return i;
+  }
+  for (uint8_t i = 0; i < USER_ICON_SLOTS; i++) {
+    if (userIcons[i] == icon) return USER_ICON_BASE + i;
+  }
+  return KEY_NO_ICON;
+}
+
+// Vérifie un enregistrement reçu (type connu, icône existante, textes terminés).
+bool keyRecordValid(const KeyRecord& r) {
+  if (r.kind >= KIND_COUNT) return false;
+  if (r.icon != KEY_NO_ICON && keyIcon(r.icon) == nullptr) return false;
+  if (memchr(r.label, 0, KEY_LABEL_LEN) == nullptr) return false;
+  if (r.kind == KIND_PROGRAM) return macroVmCheck((const uint8_t*)r.text, KEY_TEXT_LEN) != 0;
+  return memchr(r.text, 0, KEY_TEXT_LEN) != nullptr;
+}
+
+// Traduit une action du firmware en enregistrement (lecture depuis l'ordinateur).
+// Un programme trop long pour l'enregistrement est rendu vide (OP_END seul).
+void keyRecordFromAction(const KeyAction& a, KeyRecord& r) {
+  memset(&r, 0, sizeof(r));
+  r.kind = keyActionKind(a);
+  r.icon = (a.icon != nullptr) ? keyIconIndex(a.icon) : KEY_NO_ICON;
+  r.code = a.code;
+  if (a.label != nullptr) strncpy(r.label, a.label, KEY_LABEL_LEN - 1);
+  if (a.text == nullptr) return;
+  if (r.kind == KIND_PROGRAM) {
+    uint16_t size = macroVmCheck((const uint8_t*)a.text, MACRO_VM_MAX_SIZE);
+    if (size <= KEY_TEXT_LEN) memcpy(r.text, a.text, size);
+  } else {
+    strncpy(r.text, a.text, KEY_TEXT_LEN - 1);
+  }
+}
+
+/**
+ * @brief Donne l'action d'une touche : sa redéfinition, sinon celle de KEYMAP.
+ * @param layer La couche.
+ * @param key La touche.
+ * @param scratch Reçoit l'action traduite quand la touche est redéfinie.
+ * @return L'action à exécuter. Ses textes pointent dans la Flash : ils
+ * restent valides tant que leur emplacement n'est pas réécrit (une écriture
+ * attend que toutes les macros soient terminées, voir keymapWriteBegin()).
+ */
+const KeyAction& keymapLookup(uint8_t layer, uint8_t key, KeyAction& scratch) {
+  if (keymapRecords == nullptr) return KEYMAP[layer][key];
+  const KeyRecord& r = keymapRecords[layer * NUM_KEYS + key];
+  if (r.kind == KIND_FIRMWARE || r.kind >= KIND_COUNT) return KEYMAP[layer][key];
+  scratch.handler = KIND_HANDLERS[r.kind];
+  scratch.label = r.label;
+  scratch.icon = keyIcon(r.icon);
+  scratch.text = r.text;
+  scratch.code = r.code;
+  return scratch;
+}
+
+// Enregistrement actif d'une touche (nullptr si la table de config.h s'applique).
+const KeyRecord* keymapRecord(uint8_t layer, uint8_t key) {
+  if (keymapRecords == nullptr) return nullptr;
+  const KeyRecord* r = &keymapRecords[layer * NUM_KEYS + key];
+  return (r->kind != KIND_FIRMWARE) ? r : nullptr;
+}
+
+inline const KeymapSlotHeader* keymapSlotHeader(int8_t slot) {
+  return (const KeymapSlotHeader*)(keymapFlash + slot * KEYMAP_SLOT_SIZE);
+}
+inline const KeyRecord* keymapSlotRecords(int8_t slot) {
+  return (const KeyRecord*)(keymapFlash + slot * KEYMAP_SLOT_SIZE + sizeof(KeymapSlotHeader));
+}
+
+// Vrai si l'emplacement contient une table complète, intacte et de ce firmware.
+bool keymapSlotValid(int8_t slot) {
+  const KeymapSlotHeader* h = keymapSlotHeader(slot);
+  return h->magic == KEYMAP_MAGIC && h->layers == NUM_LAYERS && h->keys == NUM_KEYS
+      && crc32(0, (const uint8_t*)keymapSlotRecords(slot), KEYMAP_RECORDS_SIZE) == h->crc;
+}
+
+/**
+ * @brief Projette la partition "keymap" en mémoire et active la table la plus récente.
+ * Sans partition (autre schéma de partitions), seule la table KEYMAP s'applique.
+ */
+void keymapStoreBegin() {
+  keymapPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, KEYMAP_PARTITION_SUBTYPE, "keymap");
+  if (keymapPartition == nullptr || keymapPartition->size < 2 * KEYMAP_SLOT_SIZE) return;
+  const void* mapped = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_partition_mmap_handle_t handle;
+  if (esp_partition_mmap(keymapPartition, 0, 2 * KEYMAP_SLOT_SIZE, ESP_PARTITION_MMAP_DATA, &mapped, &handle) != ESP_OK) return;
+#else
+  spi_flash_mmap_handle_t handle;
+  if (esp_partition_mmap(keymapPartition, 0, 2 * KEYMAP_SLOT_SIZE, SPI_FLASH_MMAP_DATA, &mapped, &handle) != ESP_OK) return;
+#endif
+  keymapFlash = (const uint8_t*)mapped;
+
+  for (int8_t slot = 0; slot < 2; slot++) {
+    if (keymapSlotValid(slot) && (keymapActiveSlot < 0 || keymapSlotHeader(slot)->generation > keymapGeneration)) {
+      keymapActiveSlot = slot;
+      keymapGeneration = keymapSlotHeader(slot)->generation;
+    }
+  }
+  if (keymapActiveSlot >= 0) keymapRecords = keymapSlotRecords(keymapActiveSlot);
+}
+
+// À appeler au début de chaque tour de loop() : bascule sur une table
+// fraîchement écrite (jamais au milieu du traitement d'une touche).
+void keymapStoreTick() {
+  if (keymapPendingSlot < 0) return;
+  keymapActiveSlot = keymapPendingSlot;
+  keymapPendingSlot = -1;
+  keymapGeneration = keymapSlotHeader(keymapActiveSlot)->generation;
+  keymapRecords = keymapSlotRecords(keymapActiveSlot);
+}
+
+/**
+ * @brief Prépare l'écriture d'une nouvelle table dans l'emplacement inactif.
+ * Efface l'emplacement (quelques dizaines de ms). Refusé tant qu'une macro
+ * joue encore : elle peut lire son texte dans l'emplacement à effacer.
+ * @return false si la partition manque ou si des macros sont en cours.
+ */
+bool keymapWriteBegin() {
+  if (keymapFlash == nullptr || keymapPendingSlot >= 0) return false;
+  for (uint8_t i = 0; i < MACRO_TRACK_COUNT; i++) {
+    if (!macroIdle((MacroTrackId)i)) return false;
+  }
+  int8_t slot = (keymapActiveSlot == 0) ? 1 : 0;
+  const uint32_t eraseSize = (sizeof(KeymapSlotHeader) + KEYMAP_RECORDS_SIZE + 0xFFF) & ~0xFFFUL;
+  if (esp_partition_erase_range(keymapPartition, slot * KEYMAP_SLOT_SIZE, eraseSize) != ESP_OK) return false;
+  keymapWriteSlot = slot;
+  keymapWriteCrc = 0;
+  return true;
+}
+
+/**
+ * @brief Écrit une partie des enregistrements de la nouvelle table, dans l'ordre.
+ * @param offset Position dans la zone des enregistrements (en octets).
+ * @param data Les octets à écrire.
+ * @param len Leur nombre.
+ */
+bool keymapWriteRecords(uint32_t offset, const void* data, uint32_t len) {
+  if (keymapWriteSlot < 0 || offset > KEYMAP_RECORDS_SIZE || len > KEYMAP_RECORDS_SIZE - offset) return false;
+  uint32_t at = keymapWriteSlot * KEYMAP_SLOT_SIZE + sizeof(KeymapSlotHeader) + offset;
+  if (esp_partition_write(keymapPartition, at, data, len) != ESP_OK) return false;
+  keymapWriteCrc = crc32(keymapWriteCrc, (const uint8_t*)data, len);
+  return true;
+}
+
+/**
+ * @brief Termine la nouvelle table : relit la Flash, vérifie, puis écrit l'en-tête.
+ * La table devient active au prochain keymapStoreTick().
+ * @param expectedCrc Le CRC-32 attendu de tous les enregistrements.
+ * @return false si la table est incomplète, abîmée ou invalide (l'ancienne reste active).
+ */
+bool keymapWriteEnd(uint32_t expectedCrc) {
+  int8_t slot = keymapWriteSlot;
+  keymapWriteSlot = -1;
+  if (slot < 0) return false;
+  const KeyRecord* records = keymapSlotRecords(slot);
+  if (crc32(0, (const uint8_t*)records, KEYMAP_RECORDS_SIZE) != expectedCrc) return false;
+  for (uint16_t i = 0; i < KEYMAP_RECORD_COUNT; i++) {
+    if (!keyRecordValid(records[i])) return false;
+  }
+  KeymapSlotHeader h = { KEYMAP_MAGIC, keymapGeneration + 1, NUM_LAYERS, NUM_KEYS, expectedCrc };
+  if (esp_partition_write(keymapPartition, slot * KEYMAP_SLOT_SIZE, &h, sizeof(h)) != ESP_OK) return false;
+  keymapPendingSlot = slot;
+  return true;
+}
+
+// Abandonne la table en cours d'écriture : l'emplacement à moitié écrit reste sans en-tête, donc ignoré.
+void keymapWriteAbort() {
+  keymapWriteSlot = -1;
+}
+
+/**
+ * @brief Écrit une nouvelle table identique à l'active, sauf une touche.
+ * @param layer La couche.
+ * @param key La touche.
+ * @param rec Le nouvel enregistrement (un KeyRecord à zéro rend la touche à KEYMAP).
+ * @param all Si vrai, 'rec' remplace toutes les touches (ex: tout effacer).
+ */
+bool keymapWriteOne(uint8_t layer, uint8_t key, const KeyRecord& rec, bool all = false) {
+  if (!keymapWriteBegin()) return false;
+  static const KeyRecord EMPTY = {};
+  for (uint16_t i = 0; i < KEYMAP_RECORD_COUNT; i++) {
+    const KeyRecord* r = (keymapRecords != nullptr) ? &keymapRecords[i] : &EMPTY;
+    if (all || i == layer * NUM_KEYS + key) r = &rec;
+    if (!keymapWriteRecords(i * sizeof(KeyRecord), r, sizeof(KeyRecord))) { keymapWriteAbort(); return false; }
+  }
+  return keymapWriteEnd(keymapWriteCrc);
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,158 @@
+#pragma once
+
+// =============================================================================
+//     MODULE DE LA TABLE DES TOUCHES (KEYMAP)
+// =============================================================================
+// Chaque touche de chaque couche est décrite par un KeyAction : une fonction
+// à appeler et ses paramètres (texte, icône, code de touche...). La table
+// KEYMAP[couche][touche] est déclarée 'constexpr' dans config.h : elle est
+// construite à la compilation et rangée en Flash.
+//
+// Déclencher une macro = lire une case de la table + appeler sa fonction.
+// Ajouter une couche = ajouter un bloc { ... } dans config.h, rien d'autre.
+// -----------------------------------------------------------------------------
+
+// --- Déclarations des fonctions externes ---
+void showMessage(const char* msg);
+void displayCustomAction(const char* label, const unsigned char* icon);
+
+struct KeyAction;
+typedef void (*KeyActionHandler)(const KeyAction& action);
+
+// Description d'une action. Les champs inutilisés par le gestionnaire
+// restent à leur valeur par défaut.
+struct KeyAction {
+  KeyActionHandler handler;
+  const char* label;           // Texte affiché sur l'écran
+  const unsigned char* icon;   // Icône 16x16 (ou nullptr)
+  const char* text;            // Texte à taper (ex: commande Win+R)
+  uint16_t code;               // Touche, usage multimédia...
+};
+
+// --- Gestionnaires d'actions ---
+void selectLayer(uint8_t layer);
+
+void actMessage(const KeyAction& a)   { showMessage(a.label); }
+void actRun(const KeyAction& a)       { openViaRun(a.text); displayCustomAction(a.label, a.icon); }
+void actCtrl(const KeyAction& a)      { showMessage(a.label); sendCombo_Ctrl((char)a.code); }
+void actCtrlShift(const KeyAction& a) { showMessage(a.label); sendCombo_CtrlShift((char)a.code); }
+void actAltTab(const KeyAction&)      { sendAltTab(); }
+void actWinD(const KeyAction&)        { sendWinD(); }
+void actMedia(const KeyAction& a)     { showMessage(a.label); sendConsumer(a.code); }
+
+void actLayerNext(const KeyAction&)   { selectLayer(SELECT_NEXT); }
+
+void actProgram(const KeyAction& a) {
+  if (a.label != nullptr && a.label[0] != '\0') {
+    if (a.icon != nullptr) displayCustomAction(a.label, a.icon);
+    else showMessage(a.label);
+  }
+  runProgram(a.text);
+}
+
+// --- Constructeurs utilisés dans la table de config.h ---
+constexpr KeyAction Message(const char* label) {
+  return KeyAction{ actMessage, label, nullptr, nullptr, 0 };
+}
+constexpr KeyAction RunCmd(const char* command, const char* label, const unsigned char* icon) {
+  return KeyAction{ actRun, label, icon, command, 0 };
+}
+constexpr KeyAction Ctrl(char key, const char* label) {
+  return KeyAction{ actCtrl, label, nullptr, nullptr, (uint16_t)key };
+}
+constexpr KeyAction CtrlShift(char key, const char* label) {
+  return KeyAction{ actCtrlShift, label, nullptr, nullptr, (uint16_t)key };
+}
+constexpr KeyAction AltTab()  { return KeyAction{ actAltTab, nullptr, nullptr, nullptr, 0 }; }
+constexpr KeyAction WinD()    { return KeyAction{ actWinD, nullptr, nullptr, nullptr, 0 }; }
+constexpr KeyAction Media(uint16_t usage, const char* label) {
+  return KeyAction{ actMedia, label, nullptr, nullptr, usage };
+}
+constexpr KeyAction LayerNext() { return KeyAction{ actLayerNext, nullptr, nullptr, nullptr, 0 }; }
+// 'program' : bytecode produit par tools/macro_asm.py (voir macro-vm.h).
+constexpr KeyAction Program(const char* program, const char* label = nullptr, const unsigned char* icon = nullptr) {
+  return KeyAction{ actProgram, label, icon, program, 0 };
+}
+
+// --- Accords : plusieurs touches pressées ensemble (table COMBOS, voir combo.h) ---
+const uint8_t COMBO_ALL_LAYERS = 0xFF;   // Accord valable sur toutes les couches
+const uint8_t COMBO_NO_KEY = 0xFF;
+
+struct Combo {
+  uint8_t layer;               // Couche, ou COMBO_ALL_LAYERS
+  uint16_t keys;               // Masque des touches (bit 0 = K1 ... bit 8 = K9), voir Keys()
+  KeyAction action;
+};
+
+constexpr uint16_t keyBit(uint8_t key) { return key < 16 ? (uint16_t)(1u << key) : 0; }
+// Masque de 2 à 4 touches : Keys(K1, K2).
+constexpr uint16_t Keys(uint8_t a, uint8_t b, uint8_t c = COMBO_NO_KEY, uint8_t d = COMBO_NO_KEY) {
+  return keyBit(a) | keyBit(b) | keyBit(c) | keyBit(d);
+}
+constexpr Combo Chord(uint8_t layer, uint16_t keys, KeyAction action) {
+  return Combo{ layer, keys, action };
+}
+
+// --- Format binaire d'une touche (protocole série, voir keymap-store.h) ---
+// Une touche peut être redéfinie sans recompiler : l'ordinateur envoie un
+// KeyRecord, de taille fixe et sans pointeur, que l'on traduit en KeyAction
+// au moment de l'appui. Les textes sont lus directement dans l'enregistrement.
+enum KeyActionKind : uint8_t {
+  KIND_FIRMWARE,    // Pas de redéfinition : action de KEYMAP (config.h)
+  KIND_MESSAGE, KIND_RUN, KIND_CTRL, KIND_CTRL_SHIFT,
+  KIND_ALT_TAB, KIND_WIN_D, KIND_MEDIA, KIND_LAYER_NEXT,
+  KIND_PROGRAM,     // 'text' contient le bytecode (au plus KEY_TEXT_LEN octets)
+  KIND_COUNT
+};
+
+const KeyActionHandler KIND_HANDLERS[KIND_COUNT] = {
+  nullptr, actMessage, actRun, actCtrl, actCtrlShift,
+  actAltTab, actWinD, actMedia, actLayerNext, actProgram
+};
+
+const uint8_t KEY_LABEL_LEN = 20;   // Zéro final compris
+const uint8_t KEY_TEXT_LEN = 40;    // Zéro final compris
+const uint8_t KEY_NO_ICON = 0xFF;
+
+struct KeyRecord {
+  uint8_t kind;                 // KeyActionKind
+  uint8_t icon;                 // Index d'icône (keymap-store.h) ou KEY_NO_ICON
+  uint16_t code;                // Touche, usage multimédia...
+  char label[KEY_LABEL_LEN];
+  char text[KEY_TEXT_LEN];
+};
+static_assert(sizeof(KeyRecord) == 64, "KeyRecord doit rester sur 64 octets (format du protocole)");
+
+// Retrouve le type d'une action à partir de son gestionnaire.
+KeyActionKind keyActionKind(const KeyAction& a) {
+  for (uint8_t k = KIND_FIRMWARE + 1; k < KIND_COUNT; k++) {
+    if (KIND_HANDLERS[k] == a.handler) return (KeyActionKind)k;
+  }
+  return KIND_FIRMWARE;
+}
+
+// --- Vérifications à la compilation (utilisées par config.h) ---
+// Vrai si toutes les cases [layer][key..NUM_KEYS-1] ont un gestionnaire.
+template <size_t L, size_t K>
+constexpr bool keymapRowComplete(const KeyAction (&map)[L][K], size_t layer, size_t key) {
+  return key >= K || (map[layer][key].handler != nullptr && keymapRowComplete(map, layer, key + 1));
+}
+template <size_t L, size_t K>
+constexpr bool keymapComplete(const KeyAction (&map)[L][K], size_t layer = 0) {
+  return layer >= L || (keymapRowComplete(map, layer, 0) && keymapComplete(map, layer + 1));
+}
+
+
+// Nombre de touches d'un masque.
+constexpr uint8_t keyCount(uint16_t mask) {
+  return mask == 0 ? 0 : (uint8_t)((mask & 1) + keyCount(mask >> 1));
+}
+// Vrai si chaque accord a au moins 2 touches, toutes parmi les 'keys'
+// premières, une couche existante et une action.
+constexpr bool combosValid(const Combo* combos, size_t count, uint8_t keys, uint8_t layers, size_t i = 0) {
+  return i >= count || (keyCount(combos[i].keys) >= 2 && (combos[i].keys >> keys) == 0
+                        && (combos[i].layer < layers || combos[i].layer == COMBO_ALL_LAYERS)
+                        && combos[i].action.handler != nullptr && combosValid(combos, count, keys, layers, i + 1));
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,297 @@
+#pragma once
+#include <USBHIDKeyboard.h>
+#include <USBHIDConsumerControl.h>
+#include "typist.h"
+#include "profiler.h"
+#include "hires-mouse.h"
+
+// =============================================================================
+//     MODULE D'EXÉCUTION DES MACROS (SANS delay())
+// =============================================================================
+// Une macro n'est plus une suite d'appels bloquants mais une "timeline" :
+// une file d'étapes (appui, relâchement, frappe de texte, attente...) que
+// macroTick() fait avancer à chaque tour de loop() sans jamais attendre.
+//
+// Plusieurs timelines (pistes) indépendantes peuvent jouer en même temps.
+// Sur une même piste, les macros s'enchaînent dans l'ordre d'arrivée : une
+// touche appuyée pendant qu'une macro joue est mise en file, pas perdue.
+//
+// Une étape peut aussi être un programme en bytecode (macro-vm.h) : il est
+// décodé opcode par opcode en étapes ordinaires, jouées par le même code.
+//
+// Une étape peut être jouée plusieurs fois, une par tour (MacroStep::count) :
+// les crans rapides de l'encodeur s'ajoutent à l'étape encore en file au lieu
+// d'envoyer d'un coup des dizaines de rapports HID (macroRepeat()).
+// -----------------------------------------------------------------------------
+
+extern USBHIDKeyboard Keyboard;
+extern USBHIDConsumerControl Consumer;
+extern HiResMouse Mouse;
+
+// --- Pistes disponibles ---
+enum MacroTrackId : uint8_t {
+  MACRO_TRACK_KEYS,     // Macros des touches K1..K9
+  MACRO_TRACK_ENCODER,  // Raccourcis envoyés par l'encodeur
+  MACRO_TRACK_MENU,     // Actions lancées depuis les menus
+  MACRO_TRACK_COUNT
+};
+
+enum MacroStepType : uint8_t {
+  STEP_PRESS,        // Keyboard.press(key)
+  STEP_RELEASE,      // Keyboard.release(key)
+  STEP_RELEASE_ALL,  // Keyboard.releaseAll()
+  STEP_TYPE,         // Tape le texte par lots de 6 touches (typist.h)
+  STEP_WAIT,         // Attend 'value' ms sans bloquer
+  STEP_CONSUMER,     // Appui + relâchement d'une touche multimédia 'value'
+  STEP_TAP,          // Keyboard.write(key) : appui + relâchement
+  STEP_MODS,         // Tient exactement les modificateurs du masque 'key'
+  STEP_MOUSE_MOVE,   // Mouse.move(key, value) (déplacements signés sur 8 bits)
+  STEP_MOUSE_CLICK,  // Mouse.click(key)
+  STEP_LAYER,        // selectLayer(key)
+  STEP_ENCODER_MODE, // selectEncoderMode(key)
+  STEP_LABEL,        // showMessage(text)
+  STEP_PROGRAM,      // Joue le programme en bytecode 'text' (macro-vm.h)
+  STEP_COMBO         // Raccourci : modificateurs du masque 'value' + touche 'key', appui puis relâchement
+};
+
+struct MacroStep {
+  MacroStepType type;
+  uint8_t key;
+  uint16_t value;
+  const char* text;  // Doit rester valide jusqu'à la fin de la frappe
+  uint8_t count;     // Fois où l'étape reste à jouer, une par tour (macroRepeat)
+};
+
+// --- Déclarations des fonctions externes ---
+void showMessage(const char* msg);
+void selectLayer(uint8_t layer);
+void selectEncoderMode(uint8_t mode);
+uint8_t macroVmDecode(const uint8_t* program, uint8_t pc, MacroStep& op); // macro-vm.h
+
+const uint8_t MACRO_QUEUE_SIZE = 32; // Étapes en attente par piste (puissance de 2)
+static_assert((MACRO_QUEUE_SIZE & (MACRO_QUEUE_SIZE - 1)) == 0, "MACRO_QUEUE_SIZE doit etre une puissance de 2");
+const uint8_t MACRO_STEPS_PER_TICK = 4; // Étapes instantanées traitées par tour et par piste
+const uint8_t MACRO_VM_OPS_PER_TICK = 4; // Opcodes d'un programme traités par tour et par piste
+
+// Ce qu'il reste à faire d'une étape après macroRunStep().
+enum MacroStepResult : uint8_t {
+  STEP_DONE,     // Terminée : on passe à la suivante
+  STEP_WAITING,  // Terminée, mais une attente commence
+  STEP_BUSY      // Pas finie (texte ou programme en cours) : à reprendre au prochain tour
+};
+
+struct MacroTrack {
+  MacroStep steps[MACRO_QUEUE_SIZE];
+  uint8_t head = 0, tail = 0;     // Indices libres, masqués à l'usage
+  unsigned long waitStart = 0;    // Début de l'attente en cours
+  uint16_t waitMs = 0;            // Durée de l'attente en cours (0 = aucune)
+  Typist typist;                  // État de la frappe de texte en cours
+  ProfileMark mark;               // Entrée à l'origine de la macro mesurée
+  uint8_t markStep = 0;           // Première étape de cette macro
+  bool marked = false;            // Mesure détection -> rapport HID en cours
+  uint8_t mods = 0;               // Modificateurs tenus par STEP_MODS
+  uint8_t vmPc = 0;               // Position dans le programme en cours
+};
+
+// --- Variables propres à ce module ---
+MacroTrack macroTracks[MACRO_TRACK_COUNT];
+uint16_t macroDropped = 0; // Macros refusées faute de place dans la file
+KeyReport macroHeldKeys = {}; // Ce que Keyboard tient pour toutes les pistes : le texte est tapé par-dessus
+
+// Nombre d'étapes encore libres sur une piste.
+uint8_t macroFree(MacroTrackId track) {
+  const MacroTrack& t = macroTracks[track];
+  return MACRO_QUEUE_SIZE - (uint8_t)(t.head - t.tail);
+}
+
+// Vrai si la piste n'a plus rien à jouer.
+bool macroIdle(MacroTrackId track) {
+  const MacroTrack& t = macroTracks[track];
+  return t.head == t.tail && t.waitMs == 0;
+}
+
+/**
+ * @brief Réserve la place d'une macro complète sur une piste.
+ * Une macro est mise en file entière ou pas du tout (jamais de touche
+ * restée appuyée parce que la file était pleine au milieu).
+ * @return false si la file n'a pas assez de place (macro ignorée).
+ */
+bool macroReserve(MacroTrackId track, uint8_t stepCount) {
+  if (macroFree(track) >= stepCount) {
+    MacroTrack& t = macroTracks[track];
+    if (profileTakeInput(t.mark)) { // Macro déclenchée par une entrée : on mesure
+      t.marked = true;
+      t.markStep = t.head;
+    }
+    return true;
+  }
+  macroDropped++;
+  return false;
+}
+
+void macroPush(MacroTrackId track, MacroStepType type, uint8_t key, uint16_t value = 0, const char* text = nullptr) {
+  MacroTrack& t = macroTracks[track];
+  if ((uint8_t)(t.head - t.tail) >= MACRO_QUEUE_SIZE) { macroDropped++; return; }
+  MacroStep& s = t.steps[t.head & (MACRO_QUEUE_SIZE - 1)];
+  s.type = type; s.key = key; s.value = value; s.text = text; s.count = 1;
+  t.head++;
+}
+
+/**
+ * @brief Met en file une étape jouée 'count' fois, une par tour de loop().
+ * Si la dernière étape en file est la même (type, touche, valeur), elle est
+ * simplement rejouée davantage : une rotation rapide ne remplit pas la file
+ * et ne bloque jamais loop() plus d'une étape par tour.
+ * @param limit Nombre maximal de fois en attente pour cette étape.
+ * @return false si la file est pleine (rien n'est ajouté).
+ */
+bool macroRepeat(MacroTrackId track, MacroStepType type, uint8_t key, uint16_t value, uint8_t count, uint8_t limit = 255) {
+  MacroTrack& t = macroTracks[track];
+  if (t.head != t.tail) {
+    MacroStep& last = t.steps[(uint8_t)(t.head - 1) & (MACRO_QUEUE_SIZE - 1)];
+    if (last.type == type && last.key == key && last.value == value && last.text == nullptr) {
+      last.count = min((uint16_t)limit, (uint16_t)(last.count + count));
+      return true;
+    }
+  }
+  if (!macroReserve(track, 1)) return false;
+  macroPush(track, type, key, value);
+  t.steps[(uint8_t)(t.head - 1) & (MACRO_QUEUE_SIZE - 1)].count = min(count, limit);
+  return true;
+}
+
+// --- Raccourcis pour construire une timeline ---
+inline void macroPress(MacroTrackId track, uint8_t key)        { macroPush(track, STEP_PRESS, key); }
+inline void macroRelease(MacroTrackId track, uint8_t key)      { macroPush(track, STEP_RELEASE, key); }
+inline void macroReleaseAll(MacroTrackId track)                { macroPush(track, STEP_RELEASE_ALL, 0); }
+inline void macroWait(MacroTrackId track, uint16_t ms)         { macroPush(track, STEP_WAIT, 0, ms); }
+inline void macroType(MacroTrackId track, const char* text)    { macroPush(track, STEP_TYPE, 0, 0, text); }
+inline void macroConsumer(MacroTrackId track, uint16_t usage)  { macroPush(track, STEP_CONSUMER, 0, usage); }
+inline void macroProgram(MacroTrackId track, const char* program) { macroPush(track, STEP_PROGRAM, 0, 0, program); }
+
+// Traduit un code de Keyboard.press() comme le cœur : KEY_... spéciales à
+// partir de 0x88, modificateurs de 0x80 à 0x87, sinon caractère QWERTY américain.
+KeyStroke macroKeyStroke(uint8_t k) {
+  if (k >= 0x88) return KeyStroke{ 0, (uint8_t)(k - 0x88) };
+  if (k >= 0x80) return KeyStroke{ (uint8_t)(1 << (k - 0x80)), 0 };
+  return layoutEntryToStroke(KB_MAP_US[k]);
+}
+
+// Keyboard.press() / release(), en tenant macroHeldKeys à jour.
+void macroKeyDown(uint8_t k) {
+  Keyboard.press(k);
+  keyReportPress(macroHeldKeys, macroKeyStroke(k));
+}
+void macroKeyUp(uint8_t k) {
+  Keyboard.release(k);
+  keyReportRelease(macroHeldKeys, macroKeyStroke(k));
+}
+
+// Tape un raccourci en deux rapports (appui, relâchement), par-dessus ce que
+// les pistes tiennent ; l'état de Keyboard n'est pas modifié.
+void macroCombo(uint8_t k, uint8_t mods) {
+  KeyReport report = macroHeldKeys;
+  KeyStroke stroke = macroKeyStroke(k);
+  stroke.modifiers |= mods;
+  keyReportPress(report, stroke);
+  Keyboard.sendReport(&report);
+  Keyboard.sendReport(&macroHeldKeys);
+}
+
+// Met les modificateurs tenus au masque 'mask' (bit 0 = Ctrl gauche ... bit 7 = GUI droite).
+void macroSetMods(MacroTrack& t, uint8_t mask) {
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    uint8_t m = 1 << bit;
+    if ((mask & m) && !(t.mods & m)) macroKeyDown(KEY_LEFT_CTRL + bit);
+    if (!(mask & m) && (t.mods & m)) macroKeyUp(KEY_LEFT_CTRL + bit);
+  }
+  t.mods = mask;
+}
+
+MacroStepResult macroRunProgram(MacroTrack& t, const uint8_t* program);
+
+// Joue une étape sur la piste 't'.
+MacroStepResult macroRunStep(MacroTrack& t, const MacroStep& s) {
+  switch (s.type) {
+    case STEP_PRESS:        macroKeyDown(s.key); break;
+    case STEP_RELEASE:      macroKeyUp(s.key); break;
+    case STEP_RELEASE_ALL:  Keyboard.releaseAll(); macroHeldKeys = KeyReport{}; t.mods = 0; break;
+    case STEP_CONSUMER:     Consumer.press(s.value); Consumer.release(); break;
+    case STEP_TAP:          macroKeyDown(s.key); macroKeyUp(s.key); break; // Keyboard.write()
+    case STEP_COMBO:        macroCombo(s.key, (uint8_t)s.value); break;
+    case STEP_MODS:         macroSetMods(t, s.key); break;
+    case STEP_MOUSE_MOVE:   Mouse.move((int8_t)s.key, (int8_t)s.value); break;
+    case STEP_MOUSE_CLICK:  Mouse.click(s.key); break;
+    case STEP_LAYER:        selectLayer(s.key); break;
+    case STEP_ENCODER_MODE: selectEncoderMode(s.key); break;
+    case STEP_LABEL:        if (s.text != nullptr) showMessage(s.text); break;
+    case STEP_WAIT:
+      t.waitStart = millis();
+      t.waitMs = s.value;
+      return STEP_WAITING;
+    case STEP_TYPE:
+      if (s.text != nullptr && typistRun(t.typist, s.text, macroHeldKeys)) {
+        return STEP_BUSY; // Frappe en cours : les autres pistes continuent
+      }
+      break;
+    case STEP_PROGRAM:
+      return macroRunProgram(t, (const uint8_t*)s.text);
+  }
+  return STEP_DONE;
+}
+
+/**
+ * @brief Fait avancer un programme en bytecode d'au plus MACRO_VM_OPS_PER_TICK opcodes.
+ * Le programme reprend à t.vmPc au tour suivant ; à la fin, les
+ * modificateurs qu'il tenait encore sont relâchés.
+ */
+MacroStepResult macroRunProgram(MacroTrack& t, const uint8_t* program) {
+  for (uint8_t budget = MACRO_VM_OPS_PER_TICK; budget > 0; budget--) {
+    MacroStep op;
+    uint8_t size = macroVmDecode(program, t.vmPc, op);
+    if (size == 0) { // OP_END
+      if (t.mods != 0) macroSetMods(t, 0);
+      t.vmPc = 0;
+      return STEP_DONE;
+    }
+    MacroStepResult r = macroRunStep(t, op);
+    if (r == STEP_BUSY) return STEP_BUSY;
+    t.vmPc += size;
+    if (r == STEP_WAITING) return STEP_BUSY; // Le programme reprend après l'attente
+  }
+  return STEP_BUSY;
+}
+
+/**
+ * @brief Fait avancer une piste sans jamais bloquer.
+ * Les étapes instantanées s'enchaînent (au plus MACRO_STEPS_PER_TICK) ;
+ * une attente ou un caractère de texte rend la main jusqu'au tour suivant.
+ */
+void macroTickTrack(MacroTrack& t) {
+  if (t.waitMs != 0) {
+    if (millis() - t.waitStart < t.waitMs) return;
+    t.waitMs = 0;
+  }
+
+  for (uint8_t budget = MACRO_STEPS_PER_TICK; budget > 0 && t.head != t.tail; budget--) {
+    MacroStep& s = t.steps[t.tail & (MACRO_QUEUE_SIZE - 1)];
+    if (t.marked && s.type != STEP_WAIT && (int8_t)(t.tail - t.markStep) >= 0) {
+      profileHidReport(t.mark); // Première étape HID de la macro mesurée
+      t.marked = false;
+    }
+    MacroStepResult r = macroRunStep(t, s);
+    if (r == STEP_BUSY) return;
+    if (s.count > 1) { s.count--; return; } // Étape répétée : la suite au prochain tour
+    t.tail++;
+    if (r == STEP_WAITING) return;
+  }
+}
+
+// Fait avancer toutes les pistes. À appeler à chaque tour de loop().
+void macroTick() {
+  for (uint8_t i = 0; i < MACRO_TRACK_COUNT; i++) {
+    macroTickTrack(macroTracks[i]);
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
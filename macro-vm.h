@@ -0,0 +1,114 @@
+#pragma once
+#include "macro-executor.h"
+
+// =============================================================================
+//     MODULE DES MACROS EN BYTECODE
+// =============================================================================
+// Une macro peut être décrite par des données plutôt que par du code C++ :
+// une suite d'opcodes d'un octet suivis de leurs paramètres, puis une réserve
+// de textes (terminés par un zéro) désignés par leur position. Un programme
+// fait au plus 255 octets ; Ctrl+C avec son attente en prend 11, là où la
+// même macro mise en file par sendCombo_Ctrl() occupe 5 étapes de 8 octets.
+//
+// Le programme est joué par l'exécuteur de macros (étape STEP_PROGRAM) :
+// chaque opcode est décodé en une étape ordinaire (macroVmDecode()), au plus
+// MACRO_VM_OPS_PER_TICK par tour de loop(), sans jamais bloquer.
+//
+// Les programmes s'écrivent en texte et s'assemblent avec
+// tools/macro_asm.py, qui produit la chaîne à coller dans config.h :
+//   MODS ctrl / TAP 'c' / MODS 0 / END   ->   "\x04\x01\x03" "c\x04\x00\x00"
+// -----------------------------------------------------------------------------
+
+// --- Jeu d'instructions (ne pas renuméroter : format des programmes) ---
+enum MacroOpcode : uint8_t {
+  OP_END,          //         : fin du programme (relâche les modificateurs tenus)
+  OP_DOWN,         // k       : appuie la touche k (code Arduino : 'a', KEY_RETURN...)
+  OP_UP,           // k       : relâche la touche k
+  OP_TAP,          // k       : appuie puis relâche la touche k
+  OP_MODS,         // m       : tient exactement les modificateurs m (bit 0 = Ctrl ... bit 3 = GUI, bits 4-7 à droite)
+  OP_RELEASE_ALL,  //         : relâche tout
+  OP_CONSUMER,     // u16     : touche multimédia (usage HID, poids faible d'abord)
+  OP_MOUSE_MOVE,   // dx dy   : déplacement de la souris (signés)
+  OP_MOUSE_CLICK,  // b       : clic (1 = gauche, 2 = droit, 4 = milieu)
+  OP_WAIT8,        // ms      : attente courte (0 à 255 ms)
+  OP_WAIT,         // u16     : attente en ms
+  OP_TYPE,         // pos     : tape le texte rangé à la position 'pos' du programme
+  OP_LAYER,        // n       : change de couche (MACRO_VM_NEXT = la suivante)
+  OP_MODE,         // n       : change le mode de l'encodeur (MACRO_VM_NEXT = le suivant)
+  OP_LABEL,        // pos     : affiche le texte rangé à la position 'pos'
+  OP_COUNT
+};
+
+// Taille de chaque instruction, opcode compris.
+const uint8_t MACRO_OP_SIZE[OP_COUNT] = { 1, 2, 2, 2, 2, 1, 3, 3, 2, 2, 3, 2, 2, 2, 2 };
+
+const uint8_t MACRO_VM_NEXT = 0xFF;      // Paramètre de OP_LAYER / OP_MODE (devient SELECT_NEXT)
+const uint16_t MACRO_VM_MAX_SIZE = 255;  // Positions sur un octet
+
+/**
+ * @brief Décode l'instruction à la position 'pc' en une étape de l'exécuteur.
+ * @param program Le programme (supposé valide, voir macroVmCheck()).
+ * @param pc La position de l'instruction.
+ * @param op Reçoit l'étape à jouer.
+ * @return La taille de l'instruction, ou 0 à la fin du programme.
+ */
+uint8_t macroVmDecode(const uint8_t* program, uint8_t pc, MacroStep& op) {
+  const uint8_t* p = program + pc;
+  op.key = 0;
+  op.value = 0;
+  op.text = nullptr;
+  switch (p[0]) {
+    case OP_DOWN:        op.type = STEP_PRESS; op.key = p[1]; break;
+    case OP_UP:          op.type = STEP_RELEASE; op.key = p[1]; break;
+    case OP_TAP:         op.type = STEP_TAP; op.key = p[1]; break;
+    case OP_MODS:        op.type = STEP_MODS; op.key = p[1]; break;
+    case OP_RELEASE_ALL: op.type = STEP_RELEASE_ALL; break;
+    case OP_CONSUMER:    op.type = STEP_CONSUMER; op.value = p[1] | (p[2] << 8); break;
+    case OP_MOUSE_MOVE:  op.type = STEP_MOUSE_MOVE; op.key = p[1]; op.value = p[2]; break;
+    case OP_MOUSE_CLICK: op.type = STEP_MOUSE_CLICK; op.key = p[1]; break;
+    case OP_WAIT8:       op.type = STEP_WAIT; op.value = p[1]; break;
+    case OP_WAIT:        op.type = STEP_WAIT; op.value = p[1] | (p[2] << 8); break;
+    case OP_TYPE:        op.type = STEP_TYPE; op.text = (const char*)program + p[1]; break;
+    case OP_LAYER:       op.type = STEP_LAYER; op.key = (p[1] == MACRO_VM_NEXT) ? SELECT_NEXT : p[1]; break;
+    case OP_MODE:        op.type = STEP_ENCODER_MODE; op.key = (p[1] == MACRO_VM_NEXT) ? SELECT_NEXT : p[1]; break;
+    case OP_LABEL:       op.type = STEP_LABEL; op.text = (const char*)program + p[1]; break;
+    default:             return 0; // OP_END (ou opcode inconnu : on s'arrête)
+  }
+  return MACRO_OP_SIZE[p[0]];
+}
+
+/**
+ * @brief Vérifie un programme reçu de l'ordinateur avant de le jouer.
+ * Chaque opcode doit être connu et tenir en entier avant 'maxLen', le code
+ * doit se terminer par OP_END, et chaque texte doit être terminé avant 'maxLen'.
+ * @return La taille totale du programme (textes compris), 0 s'il est invalide.
+ */
+uint16_t macroVmCheck(const uint8_t* program, uint16_t maxLen) {
+  if (maxLen > MACRO_VM_MAX_SIZE) maxLen = MACRO_VM_MAX_SIZE;
+  uint16_t pc = 0, size = 0;
+  while (pc < maxLen && program[pc] != OP_END) {
+    uint8_t opcode = program[pc];
+    if (opcode >= OP_COUNT || pc + MACRO_OP_SIZE[opcode] > maxLen) return 0;
+    if (opcode == OP_TYPE || opcode == OP_LABEL) {
+      uint8_t pos = program[pc + 1];
+      const void* end = (pos < maxLen) ? memchr(program + pos, 0, maxLen - pos) : nullptr;
+      if (end == nullptr) return 0;
+      size = max(size, (uint16_t)((const uint8_t*)end - program + 1));
+    }
+    pc += MACRO_OP_SIZE[opcode];
+  }
+  if (pc >= maxLen) return 0; // Pas de OP_END
+  return max(size, (uint16_t)(pc + 1));
+}
+
+/**
+ * @brief Met un programme en bytecode en file sur une piste.
+ * @param program Le programme ; il doit rester valide jusqu'à la fin de la macro.
+ * @param track La piste sur laquelle le jouer.
+ */
+void runProgram(const char* program, MacroTrackId track = MACRO_TRACK_KEYS) {
+  if (!macroReserve(track, 1)) return;
+  macroProgram(track, program);
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
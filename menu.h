@@ -0,0 +1,348 @@
+#pragma once
+#include "index-seq.h"
+
+// =============================================================================
+//     MODULE DU MOTEUR DE MENUS
+// =============================================================================
+// Un menu est un arbre de MenuNode déclaré 'constexpr' (voir config.h) : les
+// sous-menus pointent vers leur tableau d'enfants, tout est construit à la
+// compilation et rangé en Flash. Quatre sortes d'entrées :
+//   MenuSubmenu("texte", enfants)                : ouvre un sous-menu
+//   MenuAction("texte", fonction, argument)      : ferme le menu et lance l'action
+//   MenuValue("texte", &variable, min, max, pas, fonction) : réglage à l'encodeur
+//   MenuToggle("texte", &booléen, fonction)      : bascule ON / OFF
+//   MenuBack("texte")                            : remonte d'un niveau (ou ferme)
+//
+// Une ligne fait 8 points, soit exactement une page du SSD1306 : l'écran de
+// 32 points montre 4 lignes et une liste plus longue défile (seules les
+// lignes visibles existent à l'écran, une barre à droite situe la fenêtre).
+//
+// Rendu : le texte des lignes visibles est dessiné une fois dans menuCache,
+// sans la sélection. Déplacer la sélection recopie ce cache et inverse les
+// octets d'une seule page ; l'envoi partiel (oled-buffer.h) ne transmet donc
+// que les deux lignes dont la surbrillance a changé. Quand la fenêtre glisse
+// d'une ligne, le cache est décalé d'une page et seule la ligne entrante est
+// dessinée. Une valeur modifiée ne redessine que sa propre ligne.
+// -----------------------------------------------------------------------------
+
+// --- Déclarations des fonctions externes ---
+void showVolume();
+void wakeUp();
+
+// --- Déclaration des variables GLOBALES utilisées par ce module ---
+extern FramebufferSSD1306 display;
+extern bool isInMenu;
+
+enum MenuNodeType : uint8_t {
+  MENU_SUBMENU,
+  MENU_ACTION,
+  MENU_VALUE,
+  MENU_TOGGLE,
+  MENU_BACK
+};
+
+// Une entrée de menu. Les champs inutilisés par son type restent à zéro.
+struct MenuNode {
+  const char* label;
+  MenuNodeType type;
+  uint8_t arg;                 // ACTION : argument de 'run' ; VALUE : pas d'un cran
+  uint8_t min, max;            // VALUE : bornes
+  uint8_t count;               // SUBMENU : nombre d'enfants
+  const MenuNode* children;    // SUBMENU : les enfants
+  void (*run)(uint8_t);        // ACTION : l'action ; VALUE / TOGGLE : applique la nouvelle valeur (ou nullptr)
+  void (*screen)();            // ACTION sans argument (ex: returnToIconMenu)
+  uint8_t* value;              // VALUE : la variable réglée
+  bool* flag;                  // TOGGLE : le booléen basculé
+  const unsigned char* icon;   // Icône 16x16 (menu d'icônes), ou nullptr
+};
+
+// --- Constructeurs utilisés dans les tables de config.h et iconmenu.h ---
+template <size_t N>
+constexpr MenuNode MenuSubmenu(const char* label, const MenuNode (&children)[N], const unsigned char* icon = nullptr) {
+  return MenuNode{ label, MENU_SUBMENU, 0, 0, 0, (uint8_t)N, children, nullptr, nullptr, nullptr, nullptr, icon };
+}
+constexpr MenuNode MenuAction(const char* label, void (*run)(uint8_t), uint8_t arg, const unsigned char* icon = nullptr) {
+  return MenuNode{ label, MENU_ACTION, arg, 0, 0, 0, nullptr, run, nullptr, nullptr, nullptr, icon };
+}
+constexpr MenuNode MenuAction(const char* label, void (*screen)(), const unsigned char* icon = nullptr) {
+  return MenuNode{ label, MENU_ACTION, 0, 0, 0, 0, nullptr, nullptr, screen, nullptr, nullptr, icon };
+}
+constexpr MenuNode MenuValue(const char* label, uint8_t* value, uint8_t min, uint8_t max, uint8_t step, void (*apply)(uint8_t) = nullptr) {
+  return MenuNode{ label, MENU_VALUE, step, min, max, 0, nullptr, apply, nullptr, value, nullptr, nullptr };
+}
+constexpr MenuNode MenuToggle(const char* label, bool* flag, void (*apply)(uint8_t) = nullptr) {
+  return MenuNode{ label, MENU_TOGGLE, 0, 0, 0, 0, nullptr, apply, nullptr, nullptr, flag, nullptr };
+}
+constexpr MenuNode MenuBack(const char* label = "Retour") {
+  return MenuNode{ label, MENU_BACK, 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+}
+
+// --- Listes numérotées, générées à la compilation ---
+// MenuNumberedLabels<N>("Couche ") écrit les textes "Couche 0" ... "Couche N-1",
+// puis MenuNumbered(textes, run, extra) en fait N entrées qui appellent
+// run(0) ... run(N-1), suivies de 'extra' et de MenuBack(). La liste suit
+// N (ex: NUM_LAYERS) sans être recopiée à la main.
+const uint8_t MENU_LABEL_LEN = 16;   // Zéro final compris
+
+template <size_t N>
+struct MenuLabels {
+  char text[N * MENU_LABEL_LEN];     // Texte i à partir de text[i * MENU_LABEL_LEN]
+};
+template <size_t N>
+struct MenuList {
+  MenuNode items[N];                 // À passer à MenuSubmenu()
+};
+
+constexpr size_t menuLabelLen(const char* s) { return *s == '\0' ? 0 : 1 + menuLabelLen(s + 1); }
+
+// Caractère 'i' du texte 'prefix' suivi du nombre 'n' (0 à 99).
+constexpr char menuLabelChar(const char* prefix, size_t len, size_t n, size_t i) {
+  return i < len ? prefix[i]
+       : i == len ? (char)('0' + (n >= 10 ? n / 10 : n))
+       : (i == len + 1 && n >= 10) ? (char)('0' + n % 10)
+       : '\0';
+}
+
+// Vrai si les N textes tiennent dans MENU_LABEL_LEN, zéro final compris.
+constexpr bool menuNumberedFits(const char* prefix, size_t n) {
+  return n <= 100 && menuLabelLen(prefix) + (n > 10 ? 2 : 1) < MENU_LABEL_LEN;
+}
+
+template <size_t N, size_t... K>
+constexpr MenuLabels<N> menuLabelsFrom(const char* prefix, IndexSeq<K...>) {
+  return MenuLabels<N>{ { menuLabelChar(prefix, menuLabelLen(prefix), K / MENU_LABEL_LEN, K % MENU_LABEL_LEN)... } };
+}
+template <size_t N>
+constexpr MenuLabels<N> MenuNumberedLabels(const char* prefix) {
+  return menuLabelsFrom<N>(prefix, typename MakeIndexSeq<N * MENU_LABEL_LEN>::type());
+}
+
+template <size_t N, size_t... I>
+constexpr MenuList<N + 2> menuNumberedFrom(const MenuLabels<N>& labels, void (*run)(uint8_t), const MenuNode& extra, IndexSeq<I...>) {
+  return MenuList<N + 2>{ { MenuAction(labels.text + I * MENU_LABEL_LEN, run, (uint8_t)I)..., extra, MenuBack() } };
+}
+template <size_t N>
+constexpr MenuList<N + 2> MenuNumbered(const MenuLabels<N>& labels, void (*run)(uint8_t), const MenuNode& extra) {
+  return menuNumberedFrom(labels, run, extra, typename MakeIndexSeq<N>::type());
+}
+
+// --- Réglages de l'affichage ---
+const uint8_t MENU_ROW_HEIGHT = 8;                           // Une ligne = une page de l'écran
+const uint8_t MENU_ROWS = SCREEN_HEIGHT / MENU_ROW_HEIGHT;   // Lignes visibles
+const uint8_t MENU_SCROLLBAR_W = 2;                          // Largeur de la barre de défilement
+const uint8_t MENU_TEXT_X = 3;                               // Marge gauche du texte
+const uint8_t MENU_MAX_DEPTH = 4;                            // Niveaux de sous-menus
+static_assert(MENU_ROW_HEIGHT == 8, "Une ligne du menu doit couvrir exactement une page du SSD1306");
+
+// --- Vérification à la compilation (utilisée par config.h) ---
+// Profondeur d'un tableau d'entrées : 1 + celle de son sous-menu le plus profond.
+constexpr uint8_t menuMax(uint8_t a, uint8_t b) { return a > b ? a : b; }
+constexpr uint8_t menuDepthOf(const MenuNode* nodes, uint8_t count) {
+  return count == 0 ? 1
+       : menuMax(nodes[0].type == MENU_SUBMENU ? 1 + menuDepthOf(nodes[0].children, nodes[0].count) : 1,
+                 menuDepthOf(nodes + 1, count - 1));
+}
+template <size_t N>
+constexpr uint8_t menuDepth(const MenuNode (&nodes)[N]) { return menuDepthOf(nodes, N); }
+
+// --- Variables propres à ce module ---
+struct MenuLevel {
+  const MenuNode* node;   // Le sous-menu affiché à ce niveau
+  uint8_t selected;       // L'entrée sélectionnée
+  uint8_t top;            // La première entrée visible
+};
+MenuLevel menuStack[MENU_MAX_DEPTH];
+uint8_t menuLevel = 0;              // Niveau affiché (menuStack[menuLevel])
+bool menuEditing = false;           // Une MENU_VALUE est en cours de réglage
+
+uint8_t menuCache[SCREEN_WIDTH * MENU_ROWS];  // Lignes visibles, sans la sélection
+const MenuNode* menuCacheNode = nullptr;      // Ce que contient le cache
+uint8_t menuCacheTop = 0;
+
+// Dessine l'entrée affichée sur la ligne 'row' dans la page correspondante
+// de l'écran, puis la recopie dans le cache.
+void menuRenderRow(uint8_t row) {
+  const MenuLevel& level = menuStack[menuLevel];
+  uint8_t* page = display.getBuffer() + row * SCREEN_WIDTH;
+  memset(page, 0, SCREEN_WIDTH);
+  uint8_t index = level.top + row;
+  if (index < level.node->count) {
+    const MenuNode& item = level.node->children[index];
+    char right[8] = "";
+    switch (item.type) {
+      case MENU_SUBMENU: strcpy(right, ">"); break;
+      case MENU_VALUE:
+        snprintf(right, sizeof(right), (menuEditing && index == level.selected) ? "<%u>" : "%u", *item.value);
+        break;
+      case MENU_TOGGLE: strcpy(right, *item.flag ? "ON" : "OFF"); break;
+      default: break;
+    }
+    display.drawText(MENU_TEXT_X, row * MENU_ROW_HEIGHT, item.label);
+    // La valeur, alignée à droite, recouvre la fin d'un texte trop long
+    int16_t rightX = SCREEN_WIDTH - MENU_SCROLLBAR_W - 2 - textWidth(right);
+    if (right[0] != '\0') {
+      memset(page + rightX - 2, 0, SCREEN_WIDTH - (rightX - 2));
+      display.drawText(rightX, row * MENU_ROW_HEIGHT, right);
+    }
+  }
+  memcpy(menuCache + row * SCREEN_WIDTH, page, SCREEN_WIDTH);
+}
+
+// Met le cache à jour pour la fenêtre affichée : rien si elle n'a pas bougé,
+// une ligne si elle a glissé d'un cran, tout sinon.
+void menuUpdateCache() {
+  const MenuLevel& level = menuStack[menuLevel];
+  if (menuCacheNode == level.node && menuCacheTop == level.top) return;
+  if (menuCacheNode == level.node && level.top == menuCacheTop + 1) {
+    memmove(menuCache, menuCache + SCREEN_WIDTH, SCREEN_WIDTH * (MENU_ROWS - 1));
+    menuCacheTop = level.top;
+    menuRenderRow(MENU_ROWS - 1);
+    return;
+  }
+  if (menuCacheNode == level.node && level.top + 1 == menuCacheTop) {
+    memmove(menuCache + SCREEN_WIDTH, menuCache, SCREEN_WIDTH * (MENU_ROWS - 1));
+    menuCacheTop = level.top;
+    menuRenderRow(0);
+    return;
+  }
+  menuCacheNode = level.node;
+  menuCacheTop = level.top;
+  for (uint8_t row = 0; row < MENU_ROWS; row++) menuRenderRow(row);
+}
+
+// Affiche le cache, la sélection et la barre de défilement.
+void menuPaint() {
+  const MenuLevel& level = menuStack[menuLevel];
+  uint8_t* buffer = display.getBuffer();
+  memcpy(buffer, menuCache, sizeof(menuCache));
+
+  uint8_t* selected = buffer + (level.selected - level.top) * SCREEN_WIDTH;
+  for (uint8_t x = 0; x < SCREEN_WIDTH - MENU_SCROLLBAR_W - 1; x++) selected[x] ^= 0xFF;
+
+  const uint8_t count = level.node->count;
+  if (count > MENU_ROWS) {
+    int16_t thumb = max(4, SCREEN_HEIGHT * MENU_ROWS / count);
+    int16_t y = (SCREEN_HEIGHT - thumb) * level.top / (count - MENU_ROWS);
+    display.fillRect(SCREEN_WIDTH - MENU_SCROLLBAR_W, y, MENU_SCROLLBAR_W, thumb, SSD1306_WHITE);
+  }
+  display.display();
+}
+
+// Déplace la sélection et fait suivre la fenêtre visible.
+void menuMove(int16_t delta) {
+  MenuLevel& level = menuStack[menuLevel];
+  const int16_t count = level.node->count;
+  level.selected = ((level.selected + delta) % count + count) % count;
+  if (level.selected < level.top) level.top = level.selected;
+  else if (level.selected >= level.top + MENU_ROWS) level.top = level.selected - MENU_ROWS + 1;
+  menuUpdateCache();
+  menuPaint();
+}
+
+/**
+ * @brief Lance l'action d'une entrée MENU_ACTION (menu de configuration ou d'icônes).
+ * @param item L'entrée.
+ */
+void menuRun(const MenuNode& item) {
+  if (item.screen != nullptr) item.screen();
+  else if (item.run != nullptr) item.run(item.arg);
+}
+
+/**
+ * @brief Ouvre un menu à sa première entrée ; ses lignes sont dessinées une fois.
+ * @param root Le sous-menu racine (MenuSubmenu).
+ */
+void menuOpen(const MenuNode& root) {
+  isInMenu = true;
+  menuLevel = 0;
+  menuEditing = false;
+  menuStack[0] = MenuLevel{ &root, 0, 0 };
+  menuCacheNode = nullptr; // Les valeurs ont pu changer depuis la dernière ouverture
+  menuUpdateCache();
+  menuPaint();
+}
+
+// Ferme le menu et revient à l'écran de l'encodeur.
+void menuClose() {
+  isInMenu = false;
+  menuEditing = false;
+  showVolume();
+}
+
+// Remonte d'un niveau, ou ferme le menu depuis la racine.
+void menuBack() {
+  if (menuLevel == 0) { menuClose(); return; }
+  menuLevel--;
+  menuUpdateCache();
+  menuPaint();
+}
+
+// Le bouton sur l'entrée sélectionnée.
+void menuSelect() {
+  MenuLevel& level = menuStack[menuLevel];
+  const MenuNode& item = level.node->children[level.selected];
+  const uint8_t row = level.selected - level.top;
+  switch (item.type) {
+    case MENU_SUBMENU:
+      if (menuLevel + 1 >= MENU_MAX_DEPTH || item.count == 0) return;
+      menuStack[++menuLevel] = MenuLevel{ &item, 0, 0 };
+      menuUpdateCache();
+      break;
+    case MENU_ACTION:
+      isInMenu = false;
+      menuRun(item);
+      return;
+    case MENU_VALUE:
+      menuEditing = !menuEditing;
+      menuRenderRow(row);
+      break;
+    case MENU_TOGGLE:
+      if (item.run != nullptr) item.run(!*item.flag);
+      else *item.flag = !*item.flag;
+      menuRenderRow(row);
+      break;
+    case MENU_BACK:
+      menuBack();
+      return;
+  }
+  menuPaint();
+}
+
+// Un cran pendant le réglage d'une MENU_VALUE : seule sa ligne est redessinée.
+void menuAdjust(int16_t delta) {
+  const MenuLevel& level = menuStack[menuLevel];
+  const MenuNode& item = level.node->children[level.selected];
+  int16_t v = max((int16_t)item.min, min((int16_t)item.max, (int16_t)(*item.value + delta * item.arg)));
+  if (item.run != nullptr) item.run((uint8_t)v);
+  else *item.value = (uint8_t)v;
+  menuRenderRow(level.selected - level.top);
+  menuPaint();
+}
+
+/**
+ * @brief Menu ouvert : l'encodeur choisit (ou règle), le bouton valide,
+ * l'appui très long ferme le menu. Les touches sont ignorées.
+ * @param e L'événement d'entrée.
+ */
+void menuEvent(const InputEvent& e) {
+  switch (e.type) {
+    case EV_DETENT:
+      wakeUp();
+      if (menuEditing) menuAdjust(e.value);
+      else menuMove(e.value);
+      break;
+    case EV_BUTTON_SHORT:
+    case EV_BUTTON_LONG:
+      wakeUp();
+      menuSelect();
+      break;
+    case EV_BUTTON_VERY_LONG: // Même geste que pour entrer : on ressort
+      wakeUp();
+      menuClose();
+      break;
+    default:
+      break;
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
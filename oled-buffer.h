@@ -0,0 +1,237 @@
+#pragma once
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "icon-blit.h"
+#include "text-blit.h"
+
+#ifndef I2C_BUFFER_LENGTH
+  #define I2C_BUFFER_LENGTH 32
+#endif
+
+// =============================================================================
+//     MODULE D'AFFICHAGE : ENVOI PARTIEL DU FRAMEBUFFER
+// =============================================================================
+// Adafruit_SSD1306::display() renvoie les 512 octets de l'écran à chaque
+// appel, même si un seul chiffre a changé. Cette couche garde une copie de
+// ce qui est réellement affiché et, à chaque display(), ne transmet que les
+// fenêtres modifiées : pour chaque page (8 lignes), la plage de colonnes
+// entre le premier et le dernier octet différent, via les commandes
+// COLUMNADDR / PAGEADDR du contrôleur.
+//
+// Le code de dessin ne change pas : on continue à faire clearDisplay(),
+// print(), drawBitmap()... puis display(). Les icônes 16x16 passent par
+// drawIcon16() et le texte par drawText() / drawStrip(), qui écrivent des
+// octets entiers (icon-blit.h, text-blit.h).
+//
+// Avec startFlushTask(), l'envoi part sur l'autre cœur : display() dépose
+// l'image terminée et rend la main aussitôt. Les commandes directes
+// (ssd1306_command) restent possibles depuis loop() : la librairie Wire de
+// l'ESP32 sérialise chaque transaction I2C.
+// -----------------------------------------------------------------------------
+
+class FramebufferSSD1306 : public Adafruit_SSD1306 {
+public:
+  FramebufferSSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin = -1)
+    : Adafruit_SSD1306(w, h, twi, rst_pin) {}
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0) {
+    if (!Adafruit_SSD1306::begin(switchvcc, i2caddr)) return false;
+    bufferSize = WIDTH * ((HEIGHT + 7) / 8);
+    if (shadow == nullptr) shadow = (uint8_t*)malloc(bufferSize);
+    if (shadow == nullptr) return false;
+    invalidate();
+    return true;
+  }
+
+  /**
+   * @brief Démarre la tâche d'envoi sur l'autre cœur de l'ESP32.
+   * Ensuite, display() ne fait plus que déposer l'image terminée et rend la
+   * main ; l'envoi I2C se fait en arrière-plan. Sans appel à cette fonction
+   * (ou sur un ESP32 mono-cœur), display() reste synchrone.
+   * @return false si la tâche n'a pas pu être créée.
+   */
+  bool startFlushTask() {
+  #if CONFIG_FREERTOS_UNICORE
+    return false;
+  #else
+    if (flushTask != nullptr) return true;
+    if (wire == nullptr || shadow == nullptr) return false;
+    if (pending == nullptr) pending = (uint8_t*)malloc(bufferSize);
+    if (front == nullptr) front = (uint8_t*)malloc(bufferSize);
+    if (pending == nullptr || front == nullptr) return false;
+    BaseType_t otherCore = (xPortGetCoreID() == 0) ? 1 : 0;
+    return xTaskCreatePinnedToCore(flushTaskEntry, "oled_flush", 3072, this, 1, &flushTask, otherCore) == pdPASS;
+  #endif
+  }
+
+  /**
+   * @brief Envoie à l'écran uniquement les zones modifiées depuis le dernier envoi.
+   * Remplace (masque) Adafruit_SSD1306::display().
+   * En mode asynchrone, copie l'image dans la boîte aux lettres de la tâche
+   * d'envoi ; une image pas encore envoyée est remplacée (fusionnée).
+   */
+  void display() {
+    if (wire == nullptr || shadow == nullptr) { // Écran SPI : pas de suivi
+      Adafruit_SSD1306::display();
+      return;
+    }
+    if (flushTask == nullptr) {
+      flushFrame(buffer);
+      return;
+    }
+
+    portENTER_CRITICAL(&frameLock);
+    memcpy(pending, buffer, bufferSize);
+    if (pendingReady) framesMerged++;
+    pendingReady = true;
+    framesSubmitted++;
+    portEXIT_CRITICAL(&frameLock);
+    xTaskNotifyGive(flushTask);
+  }
+
+  /**
+   * @brief Dessine une icône 16x16 (format drawBitmap) par octets entiers.
+   * Remplace drawBitmap(x, y, bitmap, 16, 16, color), sans appel à drawPixel().
+   * @param bitmap Une icône de icondata.h (déjà transposée) ou une icône en RAM.
+   * @param color SSD1306_WHITE, SSD1306_BLACK ou SSD1306_INVERSE.
+   */
+  void drawIcon16(int16_t x, int16_t y, const unsigned char* bitmap, uint16_t color) {
+    if (bitmap == nullptr) return;
+    const PageIcon16* icon = pageIcon(bitmap);
+    PageIcon16 converted;
+    if (icon == nullptr) {
+      pageIconConvert(bitmap, converted);
+      icon = &converted;
+    }
+    blitIcon16(getBuffer(), WIDTH, HEIGHT, x, y, *icon, color);
+  }
+
+  /**
+   * @brief Dessine un texte en taille 1 par colonnes entières (text-blit.h).
+   * Remplace setCursor(x, y) + print(text), sans appel à drawPixel().
+   * @param ink TEXT_WHITE (par défaut), TEXT_BLACK, TEXT_XOR, TEXT_OPAQUE ou TEXT_REVERSE.
+   * @param wrap Si vrai, passe à la ligne en bout d'écran comme print().
+   * @return La colonne qui suit le dernier caractère.
+   */
+  int16_t drawText(int16_t x, int16_t y, const char* text, TextInk ink = TEXT_WHITE, bool wrap = false) {
+    return blitText(getBuffer(), WIDTH, HEIGHT, x, y, text, ink, wrap);
+  }
+
+  // Dessine un texte rendu à la compilation par textStrip().
+  template <size_t N>
+  int16_t drawStrip(int16_t x, int16_t y, const TextStrip<N>& strip, TextInk ink = TEXT_WHITE) {
+    blitColumns(getBuffer(), WIDTH, HEIGHT, x, y, strip.cols, N, ink);
+    return x + N;
+  }
+
+  // Oublie le contenu connu de l'écran : le prochain display() envoie tout.
+  void invalidate() { shadowValid = false; }
+
+  // --- Statistiques ---
+  volatile uint16_t lastFlushBytes = 0;   // Octets transmis sur l'I2C par le dernier envoi
+  volatile uint32_t totalFlushBytes = 0;  // Cumul depuis le démarrage
+  volatile uint32_t flushCount = 0;       // Nombre d'envois effectués
+  volatile uint32_t lastFlushUs = 0;      // Durée du dernier envoi
+  volatile uint32_t maxFlushUs = 0;       // Durée du plus long envoi
+  volatile uint32_t framesSubmitted = 0;  // Images déposées par display() (mode asynchrone)
+  volatile uint32_t framesMerged = 0;     // Images remplacées avant d'avoir été envoyées
+  volatile uint32_t framesDropped = 0;    // Envois interrompus par une erreur I2C
+
+private:
+  uint8_t* shadow = nullptr;     // Copie de la RAM du contrôleur
+  uint8_t* pending = nullptr;    // Boîte aux lettres : dernière image terminée
+  uint8_t* front = nullptr;      // Image en cours d'envoi par la tâche
+  uint16_t bufferSize = 0;
+  bool shadowValid = false;
+  volatile bool pendingReady = false;
+  TaskHandle_t flushTask = nullptr;
+  portMUX_TYPE frameLock = portMUX_INITIALIZER_UNLOCKED;
+
+  static void flushTaskEntry(void* self) {
+    static_cast<FramebufferSSD1306*>(self)->flushLoop();
+  }
+
+  // Tâche d'envoi : échange les pointeurs (pas de copie, pas de déchirure)
+  // puis transmet l'image récupérée.
+  void flushLoop() {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      portENTER_CRITICAL(&frameLock);
+      bool ready = pendingReady;
+      if (ready) {
+        uint8_t* swap = front;
+        front = pending;
+        pending = swap;
+        pendingReady = false;
+      }
+      portEXIT_CRITICAL(&frameLock);
+      if (ready) flushFrame(front);
+    }
+  }
+
+  // Compare une image complète au contenu connu de l'écran et envoie les différences.
+  void flushFrame(const uint8_t* frame) {
+    unsigned long startUs = micros();
+    uint16_t bytes = 0;
+    bool ok = true;
+    const uint8_t pages = (HEIGHT + 7) / 8;
+    wire->setClock(wireClk);
+    for (uint8_t page = 0; page < pages && ok; page++) {
+      const uint8_t* row = frame + page * WIDTH;
+      uint8_t* seen = shadow + page * WIDTH;
+
+      // Fenêtre [first, last] des colonnes modifiées sur cette page
+      int16_t first = 0, last = WIDTH - 1;
+      if (shadowValid) {
+        while (first < WIDTH && row[first] == seen[first]) first++;
+        if (first == WIDTH) continue; // Page identique : rien à envoyer
+        while (row[last] == seen[last]) last--;
+      }
+
+      ok = sendWindow(page, first, last, row + first, bytes);
+      memcpy(seen + first, row + first, last - first + 1);
+    }
+    if (restoreClk != wireClk) wire->setClock(restoreClk);
+
+    if (ok) {
+      shadowValid = true;
+    } else {
+      shadowValid = false; // Contenu de l'écran incertain : tout renvoyer la prochaine fois
+      framesDropped++;
+    }
+    lastFlushBytes = bytes;
+    totalFlushBytes += bytes;
+    flushCount++;
+    lastFlushUs = micros() - startUs;
+    if (lastFlushUs > maxFlushUs) maxFlushUs = lastFlushUs;
+  }
+
+  // Transmet une fenêtre d'une page : adressage puis données par paquets.
+  bool sendWindow(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t* data, uint16_t& bytes) {
+    static const uint8_t CHUNK = (I2C_BUFFER_LENGTH > 32 ? 32 : I2C_BUFFER_LENGTH) - 1;
+
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00); // Co = 0, D/C = 0 : suite de commandes
+    wire->write((uint8_t)SSD1306_COLUMNADDR); wire->write(x0); wire->write(x1);
+    wire->write((uint8_t)SSD1306_PAGEADDR);   wire->write(page); wire->write(page);
+    if (wire->endTransmission() != 0) return false;
+    bytes += 7;
+
+    uint16_t count = x1 - x0 + 1;
+    while (count > 0) {
+      uint8_t n = (count > CHUNK) ? CHUNK : count;
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40); // Co = 0, D/C = 1 : données
+      wire->write(data, n);
+      if (wire->endTransmission() != 0) return false;
+      bytes += n + 1;
+      data += n;
+      count -= n;
+    }
+    return true;
+  }
+};
+
+/* ------------------------------ Fin du code -------------------------------- */
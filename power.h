@@ -0,0 +1,291 @@
+#pragma once
+#include <stdint.h>
+
+// =============================================================================
+//     MODULE DE GESTION DE L'ÉNERGIE (VEILLE)
+// =============================================================================
+// Après SLEEP_DELAY, éteindre l'écran ne suffit pas : loop() continuerait de
+// tourner à pleine vitesse pour ne rien lire. Les états :
+//
+//   ACTIVE -> ÉCONOMISEUR -> ÉCRAN ÉTEINT -> SOMNOLENCE (bus USB actif)
+//                                        \-> LIGHT SLEEP (bus USB suspendu)
+//
+//  - Somnolence : le processeur passe à POWER_DOZE_MHZ et loop() s'endort
+//    (tâche bloquée, cœur à l'arrêt) jusqu'au prochain front sur une touche,
+//    l'encodeur ou son bouton, ou au plus POWER_DOZE_TICK_MS. L'USB reste
+//    actif : l'hôte continue d'interroger le clavier normalement.
+//  - Light sleep : seulement quand l'hôte a suspendu le bus (ordinateur en
+//    veille). Réveil par niveau sur les mêmes broches, ou par minuterie pour
+//    suivre la reprise du bus. La RAM est conservée : rien à restaurer.
+//
+// Un front réveille aussitôt la boucle et la garde à pleine vitesse pendant
+// wakeHoldMs : la touche est validée par l'anti-rebond puis sa macro part
+// comme d'habitude (le premier appui n'est jamais perdu). Le délai front ->
+// premier rapport HID est mesuré (profiler.h, type "Reveil").
+//
+// Même écran allumé, quand la file d'événements est vide (input-events.h)
+// et que rien n'est en cours, loop() cède le processeur jusqu'au prochain
+// front ou au tick suivant (1 ms) au lieu de tourner à vide.
+//
+// Comme le moteur de debounce.h, la décision (powerNextState) ne dépend pas
+// d'Arduino. Elle est testée sur PC, seule puis dans le sketch entier sur
+// l'horloge virtuelle (host/tests/power-test.cpp).
+// -----------------------------------------------------------------------------
+
+enum PowerState : uint8_t {
+  POWER_ACTIVE,       // Écran allumé
+  POWER_SCREENSAVER,  // Économiseur d'écran
+  POWER_DISPLAY_OFF,  // Écran éteint, boucle à pleine vitesse (travail en cours, front récent)
+  POWER_DOZE,         // Écran éteint, processeur ralenti, boucle endormie entre deux fronts
+  POWER_LIGHT_SLEEP,  // Bus USB suspendu : light sleep
+  POWER_STATE_COUNT
+};
+
+const char* const POWER_STATE_NAMES[POWER_STATE_COUNT] = { "Actif", "Economiseur", "Ecran eteint", "Somnolence", "Light sleep" };
+
+// Délais de la machine à états.
+struct PowerTimings {
+  uint32_t screensaverMs;  // Inactivité avant l'économiseur d'écran
+  uint32_t displayOffMs;   // Inactivité avant d'éteindre l'écran
+  uint32_t wakeHoldMs;     // Pleine vitesse gardée après un front
+};
+
+// Ce que la machine à états observe à chaque tour.
+struct PowerInputs {
+  uint32_t idleMs;       // Temps depuis la dernière action (lastActionTime)
+  uint32_t sinceEdgeMs;  // Temps depuis le dernier front sur une entrée
+  bool busy;             // Macro, écriture ou transfert en cours
+  bool usbSuspended;     // Bus USB suspendu par l'hôte
+};
+
+/**
+ * @brief Choisit l'état d'énergie.
+ * L'état ne dépend que des entrées : une action remet idleMs à zéro, ce qui
+ * suffit à revenir en POWER_ACTIVE quel que soit l'état précédent.
+ */
+inline PowerState powerNextState(const PowerInputs& in, const PowerTimings& t) {
+  if (in.idleMs <= t.screensaverMs) return POWER_ACTIVE;
+  if (in.idleMs <= t.displayOffMs) return POWER_SCREENSAVER;
+  if (in.busy || in.sinceEdgeMs < t.wakeHoldMs) return POWER_DISPLAY_OFF;
+  return in.usbSuspended ? POWER_LIGHT_SLEEP : POWER_DOZE;
+}
+
+// Temps passé dans chaque état.
+struct PowerStats {
+  uint32_t ms[POWER_STATE_COUNT];
+  uint32_t entries[POWER_STATE_COUNT];
+
+  void reset() {
+    for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) ms[i] = entries[i] = 0;
+  }
+  void leave(PowerState s, uint32_t elapsedMs) { ms[s] += elapsedMs; }
+  void enter(PowerState s) { entries[s]++; }
+};
+
+
+#if defined(ARDUINO)
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+// --- Déclaration des variables GLOBALES utilisées ---
+extern FramebufferSSD1306 display;
+extern bool isSleeping;
+extern unsigned long lastActionTime;
+extern bool settingsDirty;   // settings.h
+extern bool uploadActive;    // protocol.h
+extern bool protoInFrame;    // protocol.h
+
+// --- Déclarations des fonctions externes ---
+void settingsCommit();
+
+// --- Réglages ---
+const PowerTimings POWER_TIMINGS = { SCREENSAVER_DELAY, SLEEP_DELAY, 50 };
+const uint32_t POWER_DOZE_MHZ = 80;         // Le plus bas sans toucher à l'horloge APB (I2C, USB)
+const uint16_t POWER_DOZE_TICK_MS = 20;     // Réveil de contrôle en somnolence
+const uint16_t POWER_SLEEP_TICK_MS = 100;   // Réveil de contrôle en light sleep (reprise du bus)
+
+// Consommation supposée de la carte par état (mA, écran compris) : des
+// ordres de grandeur, pas des mesures. Ils ne servent qu'à l'estimation de
+// la commande 'veille'. À remplacer par vos propres mesures (multimètre USB
+// en série) : le firmware ne peut pas mesurer son courant.
+const uint16_t POWER_STATE_MA[POWER_STATE_COUNT] = { 60, 55, 45, 20, 3 };
+
+const uint8_t POWER_MAX_WAKE_PINS = 16;
+
+// --- Variables propres à ce module ---
+volatile PowerState powerState = POWER_ACTIVE;
+unsigned long powerStateSince = 0;        // Entrée dans l'état courant (millis())
+PowerStats powerStats;
+uint32_t powerFullMhz = 240;              // Fréquence d'origine, rétablie au réveil
+TaskHandle_t powerLoopTask = nullptr;     // Tâche de loop(), réveillée par les fronts
+volatile uint32_t powerEdgeUs = 0;        // Date du dernier front (micros())
+volatile bool powerUsbSuspended = false;
+volatile bool powerLoopWaiting = false;   // loop() attend un front (powerWait)
+uint8_t powerWakePins[POWER_MAX_WAKE_PINS]; // Numéros GPIO des broches de réveil
+uint8_t powerWakePinCount = 0;
+uint32_t powerWakes = 0;                  // Réveils par un front
+
+// Front sur une touche, le bouton ou l'encodeur.
+void IRAM_ATTR powerEdgeISR() {
+  powerEdgeUs = micros();
+  if (powerLoopWaiting && powerLoopTask != nullptr) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(powerLoopTask, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+// Suivi de la suspension du bus par l'hôte.
+void powerUsbEvent(void*, esp_event_base_t base, int32_t id, void*) {
+  if (base != ARDUINO_USB_EVENTS) return;
+  if (id == ARDUINO_USB_SUSPEND_EVENT) powerUsbSuspended = true;
+  else if (id == ARDUINO_USB_RESUME_EVENT || id == ARDUINO_USB_STARTED_EVENT) powerUsbSuspended = false;
+}
+
+// Vrai s'il reste du travail : la boucle ne doit pas dormir.
+bool powerBusy() {
+  for (uint8_t i = 0; i < MACRO_TRACK_COUNT; i++) {
+    if (!macroIdle((MacroTrackId)i)) return true;
+  }
+  return settingsDirty || uploadActive || protoInFrame;
+}
+
+void powerAddWakePin(uint8_t pin) {
+  if (powerWakePinCount < POWER_MAX_WAKE_PINS) powerWakePins[powerWakePinCount++] = digitalPinToGPIONumber(pin);
+}
+
+/**
+ * @brief Prépare les sources de réveil. À appeler à la fin de setup(), depuis
+ * la tâche de loop(), après inputBegin() et encoderBegin().
+ * @param keyPins Les broches des touches.
+ * @param keyCount Le nombre de touches.
+ * @param buttonPin La broche du bouton de l'encodeur.
+ * @param encoderA La broche A de l'encodeur (interruption déjà attachée).
+ * @param encoderB La broche B de l'encodeur.
+ */
+void powerBegin(const uint8_t* keyPins, uint8_t keyCount, uint8_t buttonPin, uint8_t encoderA, uint8_t encoderB) {
+  powerLoopTask = xTaskGetCurrentTaskHandle();
+  powerFullMhz = getCpuFrequencyMhz();
+  for (uint8_t i = 0; i < keyCount; i++) {
+    powerAddWakePin(keyPins[i]);
+    attachInterrupt(digitalPinToInterrupt(keyPins[i]), powerEdgeISR, CHANGE);
+  }
+  powerAddWakePin(buttonPin);
+  attachInterrupt(digitalPinToInterrupt(buttonPin), powerEdgeISR, CHANGE);
+  powerAddWakePin(encoderA);
+  powerAddWakePin(encoderB);
+  encoderEdgeHook = powerEdgeISR; // A et B ont déjà leur interruption (encoder.h)
+  USB.onEvent(powerUsbEvent);
+  powerStats.reset();
+  powerStats.enter(POWER_ACTIVE);
+  powerStateSince = millis();
+}
+
+// Change d'état : comptabilise le temps passé et applique les effets.
+void powerSetState(PowerState next, unsigned long now) {
+  if (next == powerState) return;
+  powerStats.leave(powerState, now - powerStateSince);
+  powerStats.enter(next);
+  powerStateSince = now;
+
+  if (powerState == POWER_DOZE) setCpuFrequencyMhz(powerFullMhz);
+  powerState = next;
+
+  if (next == POWER_SCREENSAVER) screensaverStart(now);
+  if (next >= POWER_DISPLAY_OFF && !isSleeping) {
+    display.ssd1306_command(SSD1306_DISPLAYOFF);
+    isSleeping = true;
+    settingsCommit(); // Rien ne doit rester en attente pendant la veille
+  }
+  if (next == POWER_DOZE) setCpuFrequencyMhz(POWER_DOZE_MHZ);
+}
+
+// Endort loop() jusqu'au prochain front ou au plus 'ticks'. Vrai si réveillée par un front.
+bool powerWait(TickType_t ticks) {
+  powerLoopWaiting = true;
+  bool byEdge = ulTaskNotifyTake(pdTRUE, ticks) > 0;
+  powerLoopWaiting = false;
+  return byEdge;
+}
+
+// Light sleep jusqu'à un changement de niveau sur une broche de réveil ou la minuterie.
+void powerLightSleep() {
+  // Réveil sur le niveau opposé à l'état actuel de chaque broche. Les
+  // interruptions des broches sont coupées pendant ce temps : en mode niveau,
+  // elles se déclencheraient sans fin au réveil.
+  for (uint8_t i = 0; i < powerWakePinCount; i++) {
+    gpio_num_t gpio = (gpio_num_t)powerWakePins[i];
+    gpio_intr_disable(gpio);
+    gpio_sleep_sel_dis(gpio); // Garde le tirage au plus pendant le sommeil
+    gpio_wakeup_enable(gpio, gpio_get_level(gpio) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)POWER_SLEEP_TICK_MS * 1000);
+  esp_light_sleep_start();
+  bool byEdge = (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO);
+
+  for (uint8_t i = 0; i < powerWakePinCount; i++) {
+    gpio_num_t gpio = (gpio_num_t)powerWakePins[i];
+    gpio_wakeup_disable(gpio);
+    gpio_set_intr_type(gpio, GPIO_INTR_ANYEDGE);
+    gpio_intr_enable(gpio);
+  }
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  if (byEdge) {
+    powerEdgeUs = micros();
+    powerWakes++;
+    profileWake(powerEdgeUs);
+  }
+}
+
+/**
+ * @brief Gère l'inactivité ; à appeler à la fin de chaque tour de loop().
+ * Peut endormir la boucle (somnolence, light sleep) jusqu'au prochain front.
+ */
+void powerTick() {
+  unsigned long now = millis();
+  PowerInputs in;
+  in.idleMs = now - lastActionTime;
+  in.sinceEdgeMs = (micros() - powerEdgeUs) / 1000;
+  in.busy = powerBusy();
+  in.usbSuspended = powerUsbSuspended;
+  powerSetState(powerNextState(in, POWER_TIMINGS), now);
+
+  switch (powerState) {
+    case POWER_SCREENSAVER:
+      screensaverTick(now);
+      if (!in.busy && inputIdle()) powerWait(1);
+      break;
+    case POWER_DOZE:
+      if (powerWait(pdMS_TO_TICKS(POWER_DOZE_TICK_MS))) {
+        // Réveil par un front : pleine vitesse tout de suite, sans attendre le prochain tour
+        powerWakes++;
+        profileWake(powerEdgeUs);
+        powerSetState(POWER_DISPLAY_OFF, millis());
+      }
+      break;
+    case POWER_LIGHT_SLEEP:
+      powerLightSleep();
+      break;
+    default:
+      // Rien à traiter : on cède le processeur jusqu'au prochain front ou tick
+      // (les touches restent échantillonnées au moins une fois par tick).
+      if (!in.busy && inputIdle()) powerWait(1);
+      break;
+  }
+}
+
+// Consommation moyenne estimée depuis le démarrage (mA), d'après les valeurs supposées de POWER_STATE_MA.
+float powerAverageMa() {
+  uint64_t total = 0, weighted = 0;
+  for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) {
+    uint32_t ms = powerStats.ms[i] + ((i == powerState) ? millis() - powerStateSince : 0);
+    total += ms;
+    weighted += (uint64_t)ms * POWER_STATE_MA[i];
+  }
+  return total ? (float)weighted / total : 0;
+}
+
+#endif // ARDUINO
+
+/* ------------------------------ Fin du code -------------------------------- */
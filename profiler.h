@@ -0,0 +1,187 @@
+#pragma once
+#include <stdint.h>
+
+// =============================================================================
+//     MODULE DE MESURE DE LA BOUCLE (PROFILAGE SUR LA CARTE)
+// =============================================================================
+// Mesure, pour chaque état du programme (menu d'icônes, mode normal, menu de
+// configuration) :
+//  - le coût d'un tour de loop() (moyenne et pire cas, donc le plus long
+//    blocage : delay(), envoi à l'écran, boucle d'attente...),
+//  - le délai entre la détection d'une entrée (touche, cran de l'encodeur)
+//    et le premier rapport HID qu'elle provoque.
+// Ces délais sont aussi rangés, par type d'entrée, dans des histogrammes à
+// échelle logarithmique (cases de 1, 2, 4, 8... µs) : taille fixe, ajout en
+// temps constant, et médiane / 99e centile calculables à la demande.
+//
+// Une entrée est marquée au moment où elle est distribuée (profileInput) ;
+// la première macro mise en file ensuite reprend la marque, et l'exécuteur
+// la referme juste avant d'envoyer la première étape HID de cette macro.
+// Une entrée qui n'envoie rien (simple message) n'est pas comptée.
+//
+// Après une veille (power.h), la première touche est mesurée depuis le front
+// qui a réveillé la carte (profileWake), et rangée à part : "Reveil".
+// -----------------------------------------------------------------------------
+
+enum ProfileSlot : uint8_t {
+  PROFILE_ICON_MENU,    // currentState == STATE_ICON_MENU
+  PROFILE_NORMAL,       // currentState == STATE_NORMAL
+  PROFILE_CONFIG_MENU,  // STATE_NORMAL avec isInMenu
+  PROFILE_SLOT_COUNT
+};
+
+const char* const PROFILE_SLOT_NAMES[PROFILE_SLOT_COUNT] = { "Menu icones", "Normal", "Menu config" };
+
+// Types d'entrées suivis par les histogrammes de délai.
+enum LatencyClass : uint8_t {
+  LATENCY_KEY,          // Touche K1..K9 -> premier rapport de sa macro
+  LATENCY_VOLUME,       // Cran en mode Volume -> rapport multimédia
+  LATENCY_SCROLL,       // Cran en mode Scroll -> rapport souris
+  LATENCY_SHORTCUT,     // Cran en mode Undo/Redo -> premier rapport clavier
+  LATENCY_WAKE,         // Front qui réveille la carte -> premier rapport de la macro
+  LATENCY_CLASS_COUNT
+};
+
+const char* const LATENCY_CLASS_NAMES[LATENCY_CLASS_COUNT] = { "Touches", "Volume", "Scroll", "Undo/Redo", "Reveil" };
+
+// Case i : délais de 2^i à 2^(i+1)-1 µs (la case 0 prend aussi 0 µs,
+// la dernière prend tout ce qui dépasse, soit plus d'une seconde environ).
+const uint8_t LATENCY_BUCKETS = 21;
+
+// Un front de réveil n'est rattaché qu'à une touche validée dans ce délai.
+const uint32_t PROFILE_WAKE_WINDOW_US = 100000;
+
+struct LatencyHistogram {
+  uint32_t buckets[LATENCY_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+};
+
+// Marque d'une entrée : date de détection, état du programme et type d'entrée.
+struct ProfileMark {
+  uint32_t detectedUs;
+  ProfileSlot slot;
+  LatencyClass cls;
+};
+
+struct LoopProfile {
+  uint32_t iterations;      // Tours de loop() mesurés
+  uint64_t totalUs;         // Temps cumulé de ces tours
+  uint32_t maxUs;           // Tour le plus long
+  uint32_t inputs;          // Entrées suivies jusqu'au rapport HID
+  uint64_t latencyTotalUs;  // Cumul détection -> rapport HID
+  uint32_t latencyMaxUs;    // Pire délai détection -> rapport HID
+};
+
+// --- Variables propres à ce module ---
+LoopProfile loopProfiles[PROFILE_SLOT_COUNT];
+ProfileSlot profileSlot = PROFILE_ICON_MENU;  // État du tour en cours
+uint32_t profileLoopStartUs = 0;
+bool profileInputPending = false;             // Entrée en cours de distribution
+ProfileMark profileInputMark = { 0, PROFILE_ICON_MENU, LATENCY_KEY };
+LatencyHistogram latencyHistograms[LATENCY_CLASS_COUNT];
+bool profileWakePending = false;              // Réveil pas encore rattaché à une entrée
+uint32_t profileWakeUs = 0;                   // Date du front de réveil
+
+// Début d'un tour de loop(), dans l'état 'slot'.
+inline void profileLoopBegin(ProfileSlot slot) {
+  profileSlot = slot;
+  profileLoopStartUs = micros();
+}
+
+// Fin du tour de loop() commencé par profileLoopBegin().
+inline void profileLoopEnd() {
+  uint32_t us = micros() - profileLoopStartUs;
+  LoopProfile& p = loopProfiles[profileSlot];
+  p.iterations++;
+  p.totalUs += us;
+  if (us > p.maxUs) p.maxUs = us;
+}
+
+// Construit la marque d'une entrée détectée à 'detectedUs' pendant ce tour.
+inline ProfileMark profileMark(uint32_t detectedUs, LatencyClass cls) {
+  return ProfileMark{ detectedUs, profileSlot, cls };
+}
+
+/**
+ * @brief Marque une entrée sur le point d'être distribuée.
+ * @param detectedUs Date (micros()) à laquelle l'entrée a été détectée.
+ * @param cls Le type d'entrée (histogramme où ranger le délai).
+ */
+inline void profileInput(uint32_t detectedUs, LatencyClass cls) {
+  if (profileWakePending) { // Première entrée après un réveil : mesurée depuis le front
+    profileWakePending = false;
+    if (detectedUs - profileWakeUs < PROFILE_WAKE_WINDOW_US) {
+      detectedUs = profileWakeUs;
+      cls = LATENCY_WAKE;
+    }
+  }
+  profileInputPending = true;
+  profileInputMark = profileMark(detectedUs, cls);
+}
+
+// La carte vient d'être réveillée par un front sur une entrée, à 'edgeUs'.
+inline void profileWake(uint32_t edgeUs) {
+  profileWakePending = true;
+  profileWakeUs = edgeUs;
+}
+
+// Fin de la distribution : une marque non reprise par une macro est oubliée.
+inline void profileInputDone() { profileInputPending = false; }
+
+/**
+ * @brief Reprend la marque de l'entrée en cours (une seule fois).
+ * @param mark Reçoit la marque de l'entrée.
+ * @return false s'il n'y a pas d'entrée en cours de distribution.
+ */
+inline bool profileTakeInput(ProfileMark& mark) {
+  if (!profileInputPending) return false;
+  profileInputPending = false;
+  mark = profileInputMark;
+  return true;
+}
+
+// Le premier rapport HID provoqué par l'entrée 'mark' part maintenant.
+void profileHidReport(const ProfileMark& mark) {
+  uint32_t us = micros() - mark.detectedUs;
+  LoopProfile& p = loopProfiles[mark.slot];
+  p.inputs++;
+  p.latencyTotalUs += us;
+  if (us > p.latencyMaxUs) p.latencyMaxUs = us;
+
+  LatencyHistogram& h = latencyHistograms[mark.cls];
+  uint8_t bucket = 31 - __builtin_clz(us | 1);
+  h.buckets[min(bucket, (uint8_t)(LATENCY_BUCKETS - 1))]++;
+  h.count++;
+  if (us > h.maxUs) h.maxUs = us;
+}
+
+/**
+ * @brief Estime un centile d'un histogramme.
+ * @param h L'histogramme.
+ * @param percent Le centile voulu (50 = médiane, 99...).
+ * @return La borne haute (en µs) de la case qui contient ce centile, sans
+ * dépasser le maximum observé (le maximum pour la dernière case). 0 si l'histogramme est vide.
+ */
+uint32_t latencyPercentile(const LatencyHistogram& h, uint8_t percent) {
+  if (h.count == 0) return 0;
+  uint32_t rank = ((uint64_t)h.count * percent + 99) / 100; // Rang arrondi au-dessus
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += h.buckets[i];
+    if (seen >= rank && i < LATENCY_BUCKETS - 1) return min(h.maxUs, (uint32_t)((2UL << i) - 1));
+  }
+  return h.maxUs;
+}
+
+// Remet à zéro les profils de boucle par écran (commande "boucle raz").
+void profileLoopReset() {
+  memset(loopProfiles, 0, sizeof(loopProfiles));
+}
+
+// Remet à zéro les histogrammes de délai par type d'entrée (commande "stats raz").
+void profileLatencyReset() {
+  memset(latencyHistograms, 0, sizeof(latencyHistograms));
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,329 @@
+#pragma once
+
+// =============================================================================
+//     MODULE DU PROTOCOLE DE CONFIGURATION (USB CDC)
+// =============================================================================
+// Le port série USB accepte deux choses :
+//  - les commandes texte de debug.h (une ligne terminée par '\n'),
+//  - des trames binaires pour configurer le macropad depuis l'ordinateur.
+//
+// Trame binaire : 0x00, paquet encodé en COBS (aucun 0x00 à l'intérieur), 0x00.
+// Paquet        : commande, numéro de séquence, données..., CRC-16 (poids faible d'abord)
+// Réponse       : commande | 0x80, même séquence, statut, données..., CRC-16
+// Le CRC-16 est le CCITT-FALSE (poly 0x1021, départ 0xFFFF) sur tout ce qui précède.
+//
+// Les gros blocs (toute la table des touches, toutes les icônes) s'envoient
+// par morceaux : UPLOAD_BEGIN (cible, taille, CRC-32), puis des UPLOAD_CHUNK
+// acquittés un par un (la réponse donne la prochaine position attendue), puis
+// UPLOAD_END qui vérifie le CRC-32 et remplace le bloc d'un coup. Un morceau
+// renvoyé en double (acquittement perdu) est simplement ré-acquitté.
+// La table des touches est écrite directement dans l'emplacement inactif de
+// la partition "keymap" (keymap-store.h) ; les icônes passent par la RAM.
+//
+// Tout se fait dans des tampons fixes (aucune allocation) et au plus
+// PROTO_POLL_BUDGET octets sont lus par tour de loop() : un envoi à pleine
+// vitesse ne retarde jamais la lecture des touches.
+// Un client en Python est fourni dans tools/macropad_proto.py.
+// -----------------------------------------------------------------------------
+
+// --- Déclarations des fonctions externes ---
+void setBrightness(uint8_t brightness);
+
+const uint8_t PROTO_VERSION = 1;
+const uint16_t PROTO_MAX_PAYLOAD = 256;                        // Données d'un paquet reçu
+const uint16_t PROTO_MAX_PACKET = PROTO_MAX_PAYLOAD + 5;       // + commande, séquence, statut, CRC
+const uint16_t PROTO_MAX_FRAME = PROTO_MAX_PACKET + PROTO_MAX_PACKET / 254 + 2;
+const uint16_t PROTO_MAX_CHUNK = PROTO_MAX_PAYLOAD - 4;        // Données d'un UPLOAD_CHUNK
+const uint16_t PROTO_POLL_BUDGET = 512;                        // Octets lus par tour de loop()
+const uint8_t PROTO_LINE_LEN = 64;                             // Commande texte la plus longue
+
+enum ProtoCommand : uint8_t {
+  PROTO_PING            = 0x01, // -> version, couches, touches, tailles
+  PROTO_KEY_READ        = 0x10, // couche, touche -> source (0 = KEYMAP, 1 = redéfinie), KeyRecord
+  PROTO_KEY_WRITE       = 0x11, // couche, touche, KeyRecord
+  PROTO_KEYMAP_CLEAR    = 0x12, // Revient à la table KEYMAP de config.h
+  PROTO_SETTINGS_READ   = 0x20, // -> SettingsBlob
+  PROTO_SETTINGS_WRITE  = 0x21, // SettingsBlob
+  PROTO_ICON_READ       = 0x30, // emplacement -> 32 octets
+  PROTO_ICON_WRITE      = 0x31, // emplacement, 32 octets
+  PROTO_UPLOAD_BEGIN    = 0x40, // cible, taille (u32), CRC-32 (u32) -> taille max d'un morceau (u16)
+  PROTO_UPLOAD_CHUNK    = 0x41, // position (u32), données -> prochaine position attendue (u32)
+  PROTO_UPLOAD_END      = 0x42, // Vérifie et applique
+  PROTO_UPLOAD_ABORT    = 0x43
+};
+
+enum ProtoStatus : uint8_t {
+  PROTO_OK,
+  PROTO_ERR_CRC,       // Paquet abîmé : le renvoyer
+  PROTO_ERR_UNKNOWN,   // Commande inconnue
+  PROTO_ERR_ARG,       // Paramètres invalides
+  PROTO_ERR_STATE,     // Envoi absent ou en cours, morceau hors séquence, Flash occupée
+  PROTO_ERR_CHECK      // CRC-32 du bloc complet faux
+};
+
+enum UploadTarget : uint8_t {
+  UPLOAD_KEYMAP,       // NUM_LAYERS x NUM_KEYS KeyRecord
+  UPLOAD_ICONS,        // USER_ICON_SLOTS x ICON_BYTES
+  UPLOAD_TARGET_COUNT
+};
+
+// --- Variables propres à ce module ---
+uint8_t protoRx[PROTO_MAX_FRAME];        // Trame reçue, décodée sur place
+uint16_t protoRxLen = 0;
+bool protoInFrame = false;
+bool protoRxOverflow = false;
+uint8_t protoPacket[PROTO_MAX_PACKET];   // Réponse avant encodage
+uint8_t protoTx[PROTO_MAX_FRAME];        // Réponse encodée
+char protoLine[PROTO_LINE_LEN];          // Commande texte en cours
+uint8_t protoLineLen = 0;
+uint32_t protoFramesOk = 0, protoFramesBad = 0;
+
+uint8_t uploadStaging[sizeof(userIcons)];  // Icônes en cours de réception
+bool uploadActive = false;
+UploadTarget uploadTarget = UPLOAD_KEYMAP;
+uint32_t uploadSize = 0, uploadOffset = 0, uploadCrc = 0;
+
+// --- Sommes de contrôle ---
+uint16_t crc16Ccitt(const uint8_t* data, uint16_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+}
+
+inline uint32_t protoGet32(const uint8_t* p) {
+  return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+inline void protoPut32(uint8_t* p, uint32_t v) {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+// --- COBS ---
+// Décode sur place. Retourne la longueur décodée, 0 si la trame est invalide.
+uint16_t cobsDecode(uint8_t* buf, uint16_t len) {
+  uint16_t in = 0, out = 0;
+  while (in < len) {
+    uint8_t code = buf[in++];
+    if (code == 0 || in + code - 1 > len) return 0;
+    for (uint8_t i = 1; i < code; i++) buf[out++] = buf[in++];
+    if (code != 0xFF && in < len) buf[out++] = 0;
+  }
+  return out;
+}
+
+// Encode 'len' octets de 'src' dans 'dst'. Retourne la longueur encodée.
+uint16_t cobsEncode(const uint8_t* src, uint16_t len, uint8_t* dst) {
+  uint16_t codeAt = 0, out = 1;
+  uint8_t code = 1;
+  for (uint16_t i = 0; i < len; i++) {
+    if (src[i] != 0) {
+      dst[out++] = src[i];
+      code++;
+    }
+    if (src[i] == 0 || code == 0xFF) {
+      dst[codeAt] = code;
+      codeAt = out++;
+      code = 1;
+    }
+  }
+  dst[codeAt] = code;
+  return out;
+}
+
+/**
+ * @brief Envoie une réponse encadrée (0x00, COBS, 0x00).
+ * @param cmd La commande à laquelle on répond.
+ * @param seq Le numéro de séquence reçu.
+ * @param status Le résultat.
+ * @param data Les données de la réponse (ou nullptr).
+ * @param len Leur taille (au plus PROTO_MAX_PAYLOAD).
+ */
+void protoReply(uint8_t cmd, uint8_t seq, ProtoStatus status, const void* data = nullptr, uint16_t len = 0) {
+  if (len > PROTO_MAX_PAYLOAD) return; // Réponse impossible : jamais envoyée tronquée
+  protoPacket[0] = cmd | 0x80;
+  protoPacket[1] = seq;
+  protoPacket[2] = status;
+  if (len > 0) memcpy(protoPacket + 3, data, len);
+  uint16_t crc = crc16Ccitt(protoPacket, 3 + len);
+  protoPacket[3 + len] = crc & 0xFF;
+  protoPacket[4 + len] = crc >> 8;
+  protoTx[0] = 0;
+  uint16_t n = cobsEncode(protoPacket, 5 + len, protoTx + 1);
+  protoTx[n + 1] = 0;
+  Serial.write(protoTx, n + 2);
+}
+
+// Taille attendue d'un bloc envoyé par morceaux.
+uint32_t uploadTargetSize(uint8_t target) {
+  switch (target) {
+    case UPLOAD_KEYMAP: return KEYMAP_RECORDS_SIZE;
+    case UPLOAD_ICONS:  return sizeof(userIcons);
+    default:            return 0;
+  }
+}
+
+// Vérifie puis applique le bloc reçu en entier.
+ProtoStatus uploadFinish() {
+  if (uploadOffset != uploadSize) return PROTO_ERR_STATE;
+  uploadActive = false;
+  if (uploadTarget == UPLOAD_KEYMAP) {
+    return keymapWriteEnd(uploadCrc) ? PROTO_OK : PROTO_ERR_CHECK; // Active au prochain tour
+  }
+  if (crc32(0, uploadStaging, uploadSize) != uploadCrc) return PROTO_ERR_CHECK;
+  memcpy(userIcons, uploadStaging, uploadSize);
+  return PROTO_OK;
+}
+
+// Traite un paquet décodé (CRC compris).
+void protoHandlePacket(const uint8_t* p, uint16_t len) {
+  if (len < 4) { protoFramesBad++; return; }
+  uint8_t cmd = p[0], seq = p[1];
+  if (crc16Ccitt(p, len - 2) != (uint16_t)(p[len - 2] | (p[len - 1] << 8))) {
+    protoFramesBad++;
+    protoReply(cmd, seq, PROTO_ERR_CRC);
+    return;
+  }
+  protoFramesOk++;
+  const uint8_t* arg = p + 2;
+  uint16_t argLen = len - 4;
+  uint8_t out[1 + sizeof(KeyRecord)];
+
+  switch (cmd) {
+    case PROTO_PING: {
+      out[0] = PROTO_VERSION; out[1] = NUM_LAYERS; out[2] = NUM_KEYS; out[3] = sizeof(KeyRecord);
+      out[4] = USER_ICON_SLOTS; out[5] = ICON_BYTES; out[6] = PROTO_MAX_CHUNK & 0xFF; out[7] = PROTO_MAX_CHUNK >> 8;
+      protoReply(cmd, seq, PROTO_OK, out, 8);
+      break;
+    }
+    case PROTO_KEY_READ: {
+      if (argLen != 2 || arg[0] >= NUM_LAYERS || arg[1] >= NUM_KEYS) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      const KeyRecord* r = keymapRecord(arg[0], arg[1]);
+      KeyRecord rec;
+      out[0] = (r != nullptr) ? 1 : 0;
+      if (r != nullptr) rec = *r;
+      else keyRecordFromAction(KEYMAP[arg[0]][arg[1]], rec);
+      memcpy(out + 1, &rec, sizeof(rec));
+      protoReply(cmd, seq, PROTO_OK, out, sizeof(out));
+      break;
+    }
+    case PROTO_KEY_WRITE: {
+      KeyRecord rec;
+      if (argLen != 2 + sizeof(rec) || arg[0] >= NUM_LAYERS || arg[1] >= NUM_KEYS) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      memcpy(&rec, arg + 2, sizeof(rec));
+      if (!keyRecordValid(rec)) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      if (uploadActive) { protoReply(cmd, seq, PROTO_ERR_STATE); break; }
+      protoReply(cmd, seq, keymapWriteOne(arg[0], arg[1], rec) ? PROTO_OK : PROTO_ERR_STATE);
+      break;
+    }
+    case PROTO_KEYMAP_CLEAR: {
+      static const KeyRecord EMPTY = {};
+      protoReply(cmd, seq, (!uploadActive && keymapWriteOne(0, 0, EMPTY, true)) ? PROTO_OK : PROTO_ERR_STATE);
+      break;
+    }
+    case PROTO_SETTINGS_READ: {
+      SettingsBlob s = settingsCapture();
+      protoReply(cmd, seq, PROTO_OK, &s, sizeof(s));
+      break;
+    }
+    case PROTO_SETTINGS_WRITE: {
+      SettingsBlob s;
+      if (argLen != sizeof(s)) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      memcpy(&s, arg, sizeof(s));
+      if (!settingsApply(s)) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      setBrightness(oledBrightness);
+      protoReply(cmd, seq, PROTO_OK);
+      break;
+    }
+    case PROTO_ICON_READ:
+      if (argLen != 1 || arg[0] >= USER_ICON_SLOTS) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      protoReply(cmd, seq, PROTO_OK, userIcons[arg[0]], ICON_BYTES);
+      break;
+    case PROTO_ICON_WRITE:
+      if (argLen != 1 + ICON_BYTES || arg[0] >= USER_ICON_SLOTS) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      memcpy(userIcons[arg[0]], arg + 1, ICON_BYTES);
+      protoReply(cmd, seq, PROTO_OK);
+      break;
+    case PROTO_UPLOAD_BEGIN:
+      if (argLen != 9 || arg[0] >= UPLOAD_TARGET_COUNT || protoGet32(arg + 1) != uploadTargetSize(arg[0])) {
+        protoReply(cmd, seq, PROTO_ERR_ARG);
+        break;
+      }
+      if (arg[0] == UPLOAD_KEYMAP && !keymapWriteBegin()) { protoReply(cmd, seq, PROTO_ERR_STATE); break; }
+      uploadActive = true;
+      uploadTarget = (UploadTarget)arg[0];
+      uploadSize = protoGet32(arg + 1);
+      uploadCrc = protoGet32(arg + 5);
+      uploadOffset = 0;
+      out[0] = PROTO_MAX_CHUNK & 0xFF; out[1] = PROTO_MAX_CHUNK >> 8;
+      protoReply(cmd, seq, PROTO_OK, out, 2);
+      break;
+    case PROTO_UPLOAD_CHUNK: {
+      if (!uploadActive) { protoReply(cmd, seq, PROTO_ERR_STATE); break; }
+      if (argLen < 4) { protoReply(cmd, seq, PROTO_ERR_ARG); break; }
+      uint32_t offset = protoGet32(arg);
+      uint16_t n = argLen - 4;
+      ProtoStatus status = PROTO_OK;
+      if (offset > uploadSize || n > uploadSize - offset) status = PROTO_ERR_ARG;
+      else if (offset == uploadOffset) {
+        if (uploadTarget == UPLOAD_ICONS) memcpy(uploadStaging + offset, arg + 4, n);
+        else if (!keymapWriteRecords(offset, arg + 4, n)) status = PROTO_ERR_STATE;
+        if (status == PROTO_OK) uploadOffset += n;
+      }
+      else if (offset + n > uploadOffset) status = PROTO_ERR_STATE; // Trou : reprendre à uploadOffset
+      protoPut32(out, uploadOffset);
+      protoReply(cmd, seq, status, out, 4);
+      break;
+    }
+    case PROTO_UPLOAD_END:
+      protoReply(cmd, seq, uploadActive ? uploadFinish() : PROTO_ERR_STATE);
+      break;
+    case PROTO_UPLOAD_ABORT:
+      uploadActive = false;
+      keymapWriteAbort();
+      protoReply(cmd, seq, PROTO_OK);
+      break;
+    default:
+      protoReply(cmd, seq, PROTO_ERR_UNKNOWN);
+      break;
+  }
+}
+
+/**
+ * @brief Lit le port série : trames binaires et commandes texte.
+ * À appeler à chaque tour de loop() ; traite au plus PROTO_POLL_BUDGET octets.
+ */
+void protocolPoll() {
+  for (uint16_t budget = PROTO_POLL_BUDGET; budget > 0 && Serial.available() > 0; budget--) {
+    int c = Serial.read();
+    if (c < 0) break;
+
+    if (c == 0) { // Délimiteur : fin de la trame en cours, ou début d'une nouvelle
+      if (protoInFrame && protoRxLen > 0) {
+        uint16_t n = protoRxOverflow ? 0 : cobsDecode(protoRx, protoRxLen);
+        if (n > 0) protoHandlePacket(protoRx, n);
+        else protoFramesBad++;
+        protoInFrame = false;
+      } else {
+        protoInFrame = true;
+      }
+      protoRxLen = 0;
+      protoRxOverflow = false;
+      protoLineLen = 0;
+    } else if (protoInFrame) {
+      if (protoRxLen < sizeof(protoRx)) protoRx[protoRxLen++] = c;
+      else protoRxOverflow = true;
+    } else if (c == '\n') {
+      protoLine[protoLineLen] = 0;
+      #if defined(DEBUG_MODE_ENABLED)
+        if (protoLineLen > 0) parseSerialCommand(String(protoLine));
+      #endif
+      protoLineLen = 0;
+    } else if (c >= 32 && protoLineLen < PROTO_LINE_LEN - 1) {
+      protoLine[protoLineLen++] = c;
+    }
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,102 @@
+#pragma once
+#include "asset-draw.h"
+
+// =============================================================================
+//     MODULE DE L'ÉCONOMISEUR D'ÉCRAN
+// =============================================================================
+// Une icône 16x16 qui tourne sur elle-même et rebondit sur les bords.
+//
+// La position et l'image de l'animation sont calculées à partir du temps
+// écoulé depuis le lancement, et non du nombre d'appels : la vitesse reste la
+// même quelle que soit la charge de loop(). Une nouvelle image n'est dessinée
+// qu'au rythme de SCREENSAVER_FPS ; entre deux, screensaverTick() rend la main
+// aussitôt, sans delay(), et les touches restent lues à chaque tour.
+//
+// Pour une image, seules les pages couvertes par l'icône sont touchées :
+// l'ancienne fenêtre est effacée, la nouvelle dessinée. L'écran n'est vidé
+// qu'au lancement ; l'envoi partiel (oled-buffer.h) ne transmet ensuite que
+// ces quelques octets.
+// -----------------------------------------------------------------------------
+
+extern FramebufferSSD1306 display;
+
+// --- Réglages de l'animation ---
+const uint8_t SCREENSAVER_FPS = 25;          // Images par seconde
+const uint16_t SCREENSAVER_SPEED = 40;       // Vitesse de déplacement, en points par seconde
+const uint16_t SCREENSAVER_SPIN_MS = 120;    // Durée d'une image de la rotation
+const uint8_t SCREENSAVER_SIZE = 16;         // Taille de l'icône
+
+// --- Variables propres à ce module ---
+// Les 4 frames de l'animation de rotation (assets.h)
+const AssetId screensaverFrames[] = {
+  ASSET_SCREENSAVER_0,
+  ASSET_SCREENSAVER_90,
+  ASSET_SCREENSAVER_180,
+  ASSET_SCREENSAVER_270
+};
+const uint8_t NUM_SCREENSAVER_FRAMES = sizeof(screensaverFrames) / sizeof(screensaverFrames[0]);
+
+unsigned long screensaverStartMs = 0;  // Instant du lancement (origine de l'animation)
+unsigned long screensaverFrameMs = 0;  // Instant de la dernière image dessinée
+int16_t iconX = 0, iconY = 0;          // Position de l'icône affichée
+uint8_t currentFrame = 0;              // Image de la rotation affichée
+
+// Position sur un aller-retour entre 0 et 'range' après 'distance' points parcourus.
+int16_t screensaverBounce(uint32_t distance, int16_t range) {
+  if (range <= 0) return 0;
+  uint32_t d = distance % (2 * (uint32_t)range);
+  return (d <= (uint32_t)range) ? d : 2 * range - d;
+}
+
+// Efface les pages de l'écran couvertes par l'icône placée en (x, y).
+void screensaverErase(int16_t x, int16_t y) {
+  uint8_t* buffer = display.getBuffer();
+  const int16_t width = display.width();
+  const int16_t pages = (display.height() + 7) / 8;
+  const int16_t x0 = max((int16_t)0, x), x1 = min(width, (int16_t)(x + SCREENSAVER_SIZE));
+  if (x0 >= x1) return;
+  for (int16_t page = max((int16_t)0, (int16_t)(y / 8)); page <= (y + SCREENSAVER_SIZE - 1) / 8 && page < pages; page++) {
+    memset(buffer + page * width + x0, 0, x1 - x0);
+  }
+}
+
+/**
+ * @brief Lance l'économiseur d'écran : vide l'écran et dessine la première image.
+ * @param now L'instant présent (millis()).
+ */
+void screensaverStart(unsigned long now) {
+  screensaverStartMs = now;
+  screensaverFrameMs = now;
+  iconX = 0; iconY = 0;
+  currentFrame = 0;
+  display.clearDisplay();
+  drawAsset(screensaverFrames[currentFrame], iconX, iconY, SSD1306_WHITE);
+  display.display();
+}
+
+/**
+ * @brief Fait avancer l'animation ; à appeler à chaque tour de loop().
+ * Ne dessine que si une nouvelle image est due (SCREENSAVER_FPS).
+ * @param now L'instant présent (millis()).
+ */
+void screensaverTick(unsigned long now) {
+  const unsigned long period = 1000 / SCREENSAVER_FPS;
+  if (now - screensaverFrameMs < period) return;
+  // Rythme fixe ; après un long retard, on repart de maintenant au lieu de rattraper
+  screensaverFrameMs = (now - screensaverFrameMs < 2 * period) ? screensaverFrameMs + period : now;
+
+  const uint32_t elapsed = now - screensaverStartMs;
+  const uint32_t distance = (uint64_t)elapsed * SCREENSAVER_SPEED / 1000;
+  const int16_t x = screensaverBounce(distance, display.width() - SCREENSAVER_SIZE);
+  const int16_t y = screensaverBounce(distance, display.height() - SCREENSAVER_SIZE);
+  const uint8_t frame = (elapsed / SCREENSAVER_SPIN_MS) % NUM_SCREENSAVER_FRAMES;
+  if (x == iconX && y == iconY && frame == currentFrame) return; // Rien n'a bougé
+
+  screensaverErase(iconX, iconY);
+  iconX = x; iconY = y;
+  currentFrame = frame;
+  drawAsset(screensaverFrames[currentFrame], iconX, iconY, SSD1306_WHITE);
+  display.display();
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
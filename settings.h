@@ -0,0 +1,124 @@
+#pragma once
+#include <Preferences.h>
+
+// =============================================================================
+//     MODULE DE SAUVEGARDE DES RÉGLAGES (NVS)
+// =============================================================================
+// Les réglages (luminosité, couche, mode de l'encodeur, mute, profil du menu
+// d'icônes, disposition clavier de l'hôte) sont rangés ensemble dans un seul
+// bloc de la mémoire NVS de l'ESP32 : une seule lecture au démarrage.
+//
+// Le programme continue de modifier ses variables habituelles. À chaque tour,
+// settingsTick() les compare à la copie en RAM de ce qui est enregistré ; un
+// changement marque le bloc "modifié", et l'écriture n'a lieu qu'après
+// SETTINGS_QUIET_MS sans nouveau changement (ou à la mise en veille). Tourner
+// l'encodeur dans le réglage de luminosité ne fait donc qu'une seule écriture
+// en Flash, pas une par cran.
+// -----------------------------------------------------------------------------
+
+// --- Déclaration des variables GLOBALES sauvegardées ---
+extern uint8_t oledBrightness;
+extern uint8_t currentLayer;
+extern const uint8_t NUM_LAYERS;
+extern EncoderMode currentEncoderMode;
+extern bool muted;
+extern int8_t activeProfile;
+extern KeyboardLayoutId hostLayout;
+
+const uint8_t SETTINGS_VERSION = 1;             // À changer si SettingsBlob change
+const unsigned long SETTINGS_QUIET_MS = 3000;   // Délai sans changement avant écriture
+
+// Le bloc enregistré tel quel dans la NVS.
+struct SettingsBlob {
+  uint8_t version;
+  uint8_t brightness;
+  uint8_t layer;
+  uint8_t encoderMode;
+  uint8_t muted;
+  uint8_t iconProfile;
+  uint8_t hostLayout;
+  uint8_t reserved;
+};
+
+// --- Variables propres à ce module ---
+Preferences settingsPrefs;
+SettingsBlob settingsShadow;         // Copie en RAM du bloc (en avance sur la Flash si modifié)
+bool settingsDirty = false;
+unsigned long settingsChangedAt = 0; // Date du dernier changement constaté
+uint16_t settingsWrites = 0;         // Écritures en Flash depuis le démarrage
+
+// Photographie des variables du programme.
+SettingsBlob settingsCapture() {
+  SettingsBlob s;
+  s.version = SETTINGS_VERSION;
+  s.brightness = oledBrightness;
+  s.layer = currentLayer;
+  s.encoderMode = (uint8_t)currentEncoderMode;
+  s.muted = muted ? 1 : 0;
+  s.iconProfile = (uint8_t)activeProfile;
+  s.hostLayout = (uint8_t)hostLayout;
+  s.reserved = 0;
+  return s;
+}
+
+// Vrai si le bloc est de la bonne version et que toutes ses valeurs sont utilisables.
+bool settingsValid(const SettingsBlob& s) {
+  return s.version == SETTINGS_VERSION
+      && s.layer < NUM_LAYERS
+      && s.encoderMode < NUM_ENCODER_MODES
+      && s.iconProfile < NUM_ICONS
+      && s.hostLayout < LAYOUT_COUNT;
+}
+
+/**
+ * @brief Recopie un bloc de réglages dans les variables du programme.
+ * L'écriture en Flash suit toute seule (settingsTick()).
+ * @return false si le bloc n'est pas valide (rien n'est modifié).
+ */
+bool settingsApply(const SettingsBlob& s) {
+  if (!settingsValid(s)) return false;
+  oledBrightness = s.brightness;
+  currentLayer = s.layer;
+  currentEncoderMode = (EncoderMode)s.encoderMode;
+  muted = (s.muted != 0);
+  activeProfile = (int8_t)s.iconProfile;
+  hostLayout = (KeyboardLayoutId)s.hostLayout;
+  return true;
+}
+
+/**
+ * @brief Ouvre la NVS et restaure tous les réglages en une seule lecture.
+ * Un bloc absent, d'une autre version ou hors limites laisse les valeurs
+ * par défaut du programme.
+ */
+void settingsBegin() {
+  settingsPrefs.begin("macropad", false);
+  SettingsBlob s;
+  if (settingsPrefs.getBytes("cfg", &s, sizeof(s)) == sizeof(s)) settingsApply(s);
+  settingsShadow = settingsCapture();
+  settingsDirty = false;
+}
+
+// Écrit le bloc tout de suite s'il a changé (ex: avant la mise en veille).
+void settingsCommit() {
+  if (!settingsDirty) return;
+  settingsPrefs.putBytes("cfg", &settingsShadow, sizeof(settingsShadow));
+  settingsDirty = false;
+  settingsWrites++;
+}
+
+// À appeler à chaque tour de loop() : repère les changements et écrit
+// après la période de calme.
+void settingsTick() {
+  SettingsBlob now = settingsCapture();
+  if (memcmp(&now, &settingsShadow, sizeof(now)) != 0) {
+    settingsShadow = now;
+    settingsDirty = true;
+    settingsChangedAt = millis();
+  }
+  if (settingsDirty && millis() - settingsChangedAt >= SETTINGS_QUIET_MS) {
+    settingsCommit();
+  }
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
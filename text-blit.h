@@ -0,0 +1,155 @@
+#pragma once
+#include "icon-blit.h"
+#include "font5x7.h"
+#include "index-seq.h"
+
+// =============================================================================
+//     MODULE DE DESSIN RAPIDE DU TEXTE
+// =============================================================================
+// print() d'Adafruit GFX passe par drawChar(), qui relit la police bit par
+// bit et appelle drawPixel() pour chacun des 35 points d'un caractère (48
+// avec un fond). Ici les glyphes sont copiés colonne par colonne depuis
+// l'atlas FONT5X7 (font5x7.h), déjà au format page du SSD1306 :
+//  - si y est un multiple de 8, chaque colonne est un seul octet de l'écran,
+//  - sinon elle est décalée et répartie sur deux pages.
+// Un caractère occupe une cellule de 6x8 points, comme print() en taille 1.
+//
+// Les textes constants peuvent aussi être rendus à la compilation :
+// textStrip("Mode: Volume") est un tableau constexpr de colonnes prêtes à
+// copier, dessiné par drawStrip() (oled-buffer.h) sans lire la police.
+//
+// L'écran est supposé sans rotation (setRotation() n'est pas utilisé).
+// Le résultat est comparé point par point à print() sur PC
+// (host/tests/text-blit-test.cpp).
+// -----------------------------------------------------------------------------
+
+// Façon de combiner le texte avec l'écran.
+enum TextInk : uint8_t {
+  TEXT_WHITE,     // Points allumés, fond inchangé (comme setTextColor(SSD1306_WHITE))
+  TEXT_BLACK,     // Points éteints, fond inchangé
+  TEXT_XOR,       // Points inversés
+  TEXT_OPAQUE,    // Blanc sur noir : toute la cellule est écrite
+  TEXT_REVERSE    // Noir sur blanc : vidéo inverse (sélection d'un menu)
+};
+
+const uint8_t TEXT_CELL_W = 6;   // Largeur d'un caractère, espacement compris
+const uint8_t TEXT_CELL_H = 8;   // Hauteur d'une ligne de texte
+
+// --- Atlas ---
+// Colonne 'col' (0 à 5) de la cellule du caractère 'c' ; '?' hors de l'atlas.
+constexpr uint8_t glyphColumn(char c, uint8_t col) {
+  return col >= FONT_GLYPH_W ? 0
+       : FONT5X7[((uint8_t)c >= FONT_FIRST && (uint8_t)c <= FONT_LAST ? (uint8_t)c - FONT_FIRST : '?' - FONT_FIRST) * FONT_GLYPH_W + col];
+}
+
+// Largeur en points d'un texte sur une ligne.
+inline int16_t textWidth(const char* text) {
+  return text == nullptr ? 0 : (int16_t)strlen(text) * TEXT_CELL_W;
+}
+
+// --- Texte pré-rendu à la compilation ---
+template <size_t N>
+struct TextStrip {
+  uint8_t cols[N];
+};
+
+template <size_t N, size_t... I>
+constexpr TextStrip<sizeof...(I)> textStripFrom(const char (&text)[N], IndexSeq<I...>) {
+  return TextStrip<sizeof...(I)>{ { glyphColumn(text[I / TEXT_CELL_W], I % TEXT_CELL_W)... } };
+}
+
+// Rend un texte constant en colonnes : utilisable dans un constexpr.
+template <size_t N>
+constexpr TextStrip<(N - 1) * TEXT_CELL_W> textStrip(const char (&text)[N]) {
+  return textStripFrom(text, typename MakeIndexSeq<(N - 1) * TEXT_CELL_W>::type());
+}
+
+// --- Copie des colonnes ---
+// Combine 'bits' avec un octet de l'écran ; 'mask' = lignes de la cellule dans cet octet.
+inline void textPut(uint8_t& dst, uint8_t bits, uint8_t mask, TextInk ink) {
+  switch (ink) {
+    case TEXT_WHITE:   dst |= bits; break;
+    case TEXT_BLACK:   dst &= ~bits; break;
+    case TEXT_XOR:     dst ^= bits; break;
+    case TEXT_OPAQUE:  dst = (dst & ~mask) | bits; break;
+    case TEXT_REVERSE: dst = (dst & ~mask) | (mask & ~bits); break;
+  }
+}
+
+/**
+ * @brief Copie 'count' colonnes de 8 points dans un framebuffer SSD1306 (format page).
+ * @param buffer Le framebuffer (getBuffer()), 'width' octets par page.
+ * @param width La largeur de l'écran.
+ * @param height La hauteur de l'écran.
+ * @param x La colonne de la première colonne (peut sortir de l'écran).
+ * @param y La ligne du haut (peut sortir de l'écran).
+ * @param cols Les colonnes, bit 0 en haut.
+ * @param count Le nombre de colonnes.
+ * @param ink La façon de combiner avec l'écran.
+ */
+void blitColumns(uint8_t* buffer, int16_t width, int16_t height, int16_t x, int16_t y,
+                 const uint8_t* cols, int16_t count, TextInk ink) {
+  if (buffer == nullptr || x >= width || x + count <= 0 || y <= -TEXT_CELL_H || y >= height) return;
+  const int16_t c0 = (x < 0) ? -x : 0;                     // Colonnes visibles
+  const int16_t c1 = (x + count > width) ? width - x : count;
+  const int16_t pages = (height + 7) / 8;
+  const int16_t top = (y >= 0) ? y / 8 : -1;              // Page de la ligne y (y > -8)
+  const uint8_t shift = y - top * 8;
+
+  if (shift == 0) { // Cas rapide : une colonne = un octet de l'écran
+    uint8_t* row = buffer + top * width;
+    switch (ink) {
+      case TEXT_WHITE:   blitSpan(row, x, cols, c0, c1, SSD1306_WHITE); break;
+      case TEXT_BLACK:   blitSpan(row, x, cols, c0, c1, SSD1306_BLACK); break;
+      case TEXT_XOR:     blitSpan(row, x, cols, c0, c1, SSD1306_INVERSE); break;
+      case TEXT_OPAQUE:  memcpy(row + x + c0, cols + c0, c1 - c0); break;
+      case TEXT_REVERSE: for (int16_t c = c0; c < c1; c++) row[x + c] = ~cols[c]; break;
+    }
+    return;
+  }
+
+  // Cas décalé : le haut de la cellule dans la page 'top', le bas dans la suivante
+  if (top >= 0) {
+    uint8_t* row = buffer + top * width + x;
+    const uint8_t mask = 0xFF << shift;
+    for (int16_t c = c0; c < c1; c++) textPut(row[c], cols[c] << shift, mask, ink);
+  }
+  if (top + 1 < pages) {
+    uint8_t* row = buffer + (top + 1) * width + x;
+    const uint8_t mask = 0xFF >> (8 - shift);
+    for (int16_t c = c0; c < c1; c++) textPut(row[c], cols[c] >> (8 - shift), mask, ink);
+  }
+}
+
+/**
+ * @brief Dessine un texte avec la police 5x7, par colonnes entières.
+ * Remplace setCursor(x, y) + print(text) en taille 1.
+ * @param buffer Le framebuffer (getBuffer()).
+ * @param width La largeur de l'écran.
+ * @param height La hauteur de l'écran.
+ * @param x La colonne du premier caractère.
+ * @param y La ligne du haut du texte.
+ * @param text Le texte ('\n' passe à la ligne suivante, en x = 0).
+ * @param ink La façon de combiner avec l'écran.
+ * @param wrap Si vrai, un caractère qui dépasse à droite passe à la ligne (comme print()).
+ * @return La colonne qui suit le dernier caractère.
+ */
+int16_t blitText(uint8_t* buffer, int16_t width, int16_t height, int16_t x, int16_t y,
+                 const char* text, TextInk ink, bool wrap) {
+  if (text == nullptr) return x;
+  uint8_t cell[TEXT_CELL_W];
+  cell[TEXT_CELL_W - 1] = 0; // Colonne d'espacement
+  for (; *text != '\0'; text++) {
+    if (*text == '\n') { x = 0; y += TEXT_CELL_H; continue; }
+    if (*text == '\r') continue;
+    if (wrap && x + TEXT_CELL_W > width) { x = 0; y += TEXT_CELL_H; }
+    uint8_t c = (uint8_t)*text;
+    if (c < FONT_FIRST || c > FONT_LAST) c = '?';
+    memcpy(cell, FONT5X7 + (c - FONT_FIRST) * FONT_GLYPH_W, FONT_GLYPH_W);
+    blitColumns(buffer, width, height, x, y, cell, TEXT_CELL_W, ink);
+    x += TEXT_CELL_W;
+  }
+  return x;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# =============================================================================
+#     COMPILATION DES IMAGES BMP EN DONNÉES COMPRESSÉES (assets.h)
+# =============================================================================
+# Lit la liste tools/assets.txt, convertit chaque BMP (1, 4, 8, 24 ou 32 bits,
+# non compressé) au format de l'écran SSD1306 (pages de 8 points verticaux,
+# page 0 de gauche à droite, puis page 1...), le compresse et écrit assets.h :
+# un seul tableau d'octets et une table d'index (taille, position).
+# Les images sont décodées au vol dans l'écran par drawAsset() (asset-draw.h).
+#
+# Compression (octet de contrôle c) :
+#   c < 0x80  : les c+1 octets suivants sont copiés tels quels
+#   c >= 0x80 : l'octet suivant est répété (c & 0x7F) + 2 fois
+#
+# Exemple : python3 tools/assets.py            (depuis n'importe où)
+#           python3 tools/assets.py liste.txt sortie.h
+# -----------------------------------------------------------------------------
+
+import os
+import struct
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+
+def read_bmp(path):
+    """Retourne (largeur, hauteur, lignes de points) ; 1 = point allumé (sombre dans l'image)."""
+    d = open(path, "rb").read()
+    if d[:2] != b"BM":
+        raise ValueError("%s : pas un fichier BMP" % path)
+    offset, = struct.unpack_from("<I", d, 10)
+    header, width, height, _, bpp, compression = struct.unpack_from("<IiiHHI", d, 14)
+    if compression not in (0, 3) or bpp not in (1, 4, 8, 24, 32):
+        raise ValueError("%s : format BMP non pris en charge (%d bits, compression %d)" % (path, bpp, compression))
+    palette = []
+    if bpp <= 8:
+        colors, = struct.unpack_from("<I", d, 46)
+        base = 14 + header
+        palette = [d[base + 4 * i:base + 4 * i + 3] for i in range(colors or (1 << bpp))]
+    top_down, height = height < 0, abs(height)
+    stride = ((width * bpp + 31) // 32) * 4
+    rows = []
+    for y in range(height):
+        row = d[offset + (y if top_down else height - 1 - y) * stride:][:stride]
+        line = []
+        for x in range(width):
+            if bpp <= 8:
+                per = 8 // bpp
+                index = (row[x // per] >> ((per - 1 - x % per) * bpp)) & ((1 << bpp) - 1)
+                b, g, r = palette[index]
+            else:
+                b, g, r = row[x * bpp // 8:x * bpp // 8 + 3]
+            line.append(1 if (r * 77 + g * 150 + b * 29) >> 8 < 128 else 0)
+        rows.append(line)
+    return width, height, rows
+
+
+def to_pages(width, height, rows):
+    out = bytearray()
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and rows[y][x]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return bytes(out)
+
+
+def rle(data):
+    out, literal, i = bytearray(), bytearray(), 0
+
+    def flush():
+        while literal:
+            chunk = literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literal[:128]
+
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 129:
+            run += 1
+        if run >= 3:
+            flush()
+            out += bytes([0x80 | (run - 2), data[i]])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def unrle(data):
+    out, i = bytearray(), 0
+    while i < len(data):
+        c = data[i]
+        if c & 0x80:
+            out += bytes([data[i + 1]]) * ((c & 0x7F) + 2)
+            i += 2
+        else:
+            out += data[i + 1:i + 2 + c]
+            i += c + 2
+    return bytes(out)
+
+
+def main(argv):
+    manifest = argv[1] if len(argv) > 1 else os.path.join(ROOT, "tools", "assets.txt")
+    output = argv[2] if len(argv) > 2 else os.path.join(ROOT, "assets.h")
+    assets = []
+    for line in open(manifest, encoding="utf-8"):
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+        name, path = line.split(None, 1)
+        width, height, rows = read_bmp(os.path.join(ROOT, path))
+        if width > 255 or height > 255:
+            raise ValueError("%s : image trop grande (255x255 au plus)" % path)
+        pages = to_pages(width, height, rows)
+        packed = rle(pages)
+        assert unrle(packed) == pages
+        assets.append((name.upper(), path, width, height, (width * height + 7) // 8, packed))
+
+    blob = b"".join(a[5] for a in assets)
+    if len(blob) > 0xFFFF:
+        raise ValueError("trop de donnees (%d octets, 65535 au plus)" % len(blob))
+    with open(output, "w", encoding="utf-8", newline="\n") as f:
+        f.write("#pragma once\n\n")
+        f.write("// =============================================================================\n")
+        f.write("//     IMAGES COMPRESSÉES (FICHIER GÉNÉRÉ PAR tools/assets.py, NE PAS MODIFIER)\n")
+        f.write("// =============================================================================\n")
+        f.write("// Sources : tools/assets.txt. Format : voir tools/assets.py et asset-draw.h.\n")
+        f.write("// -----------------------------------------------------------------------------\n\n")
+        f.write("struct AssetInfo {\n  uint8_t width;\n  uint8_t height;\n  uint16_t offset;  // Position dans ASSET_DATA\n  uint16_t size;    // Octets compressés\n};\n\n")
+        f.write("enum AssetId : uint8_t {\n")
+        for a in assets:
+            f.write("  ASSET_%s,\n" % a[0])
+        f.write("  ASSET_COUNT\n};\n\n")
+        f.write("const uint8_t ASSET_DATA[] PROGMEM = {\n")
+        offset = 0
+        for a in assets:
+            f.write("  // ASSET_%s : %s\n" % (a[0], a[1]))
+            for i in range(0, len(a[5]), 16):
+                f.write("  " + " ".join("0x%02x," % b for b in a[5][i:i + 16]) + "\n")
+        f.write("};\n\n")
+        f.write("const AssetInfo ASSETS[ASSET_COUNT] = {\n")
+        for a in assets:
+            f.write("  { %d, %d, %d, %d },  // ASSET_%s\n" % (a[2], a[3], offset, len(a[5]), a[0]))
+            offset += len(a[5])
+        f.write("};\n\n")
+        f.write("/* ------------------------------ Fin du code -------------------------------- */\n")
+
+    print("%-20s %9s %6s %10s %6s" % ("Image", "Taille", "Brut", "Compresse", "Gain"))
+    raw_total = 0
+    for name, _, width, height, raw, packed in assets:
+        raw_total += raw
+        print("%-20s %4dx%-4d %6d %10d %5d%%" % (name, width, height, raw, len(packed), 100 - 100 * len(packed) // raw))
+    print("%-20s %9s %6d %10d %5d%%" % ("Total", "", raw_total, len(blob), 100 - 100 * len(blob) // max(1, raw_total)))
+    print("Ecrit : %s" % output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+# =============================================================================
+#     GÉNÉRATION DES TABLES DE DISPOSITIONS CLAVIER (kb-layout.h)
+# =============================================================================
+# Décrit chaque disposition (US, US_INTL, UK, FR, DE) touche par touche : pour
+# chaque usage HID, le caractère produit seul, avec Shift, avec AltGr et avec
+# Shift+AltGr. En déduit la table de 256 entrées (caractère Latin-1 -> touche)
+# et la table des touches mortes, au format décrit en tête de kb-layout.h :
+#   bits 0-7   : usage HID          bit 8 : Shift          bit 9 : AltGr
+#   bits 12-14 : touche morte à taper avant (index dans KB_DEAD_xxx)
+#
+# Un caractère produit par plusieurs touches garde la première (usage HID le
+# plus petit, puis le niveau le plus simple). Un caractère accentué absent du
+# clavier est obtenu par touche morte + lettre ; le signe d'une touche morte
+# seul, par touche morte + espace.
+#
+# Le bloc des tables de kb-layout.h (de "// US : touches mortes" à KB_DEAD_DE)
+# est remplacé sur place ; le reste du fichier n'est pas touché.
+#
+# Exemple : python3 tools/kb_layouts.py            (met à jour kb-layout.h)
+#           python3 tools/kb_layouts.py --stdout   (affiche les tables)
+# -----------------------------------------------------------------------------
+
+import os
+import re
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+SHIFT = 0x100
+ALTGR = 0x200
+LEVELS = (0, SHIFT, ALTGR, SHIFT | ALTGR)
+CONTROLS = (("\n", 0x28), ("\t", 0x2B), ("\b", 0x2A), (" ", 0x2C))
+
+
+def dead(glyph):
+    """Touche morte : le signe qu'elle pose sur la lettre suivante."""
+    return ("mort", glyph)
+
+
+def letters(swaps=None):
+    """Les 26 lettres (usages 0x04 à 0x1D), avec des lettres échangées (AZERTY, QWERTZ)."""
+    swaps = swaps or {}
+    keys = {}
+    for i, c in enumerate("abcdefghijklmnopqrstuvwxyz"):
+        c = swaps.get(c, c)
+        keys[0x04 + i] = [c, c.upper()]
+    return keys
+
+
+def layout(keys, rows):
+    keys = dict(keys)
+    keys.update({usage: list(chars) for usage, chars in rows.items()})
+    return keys
+
+
+# --- Lettres obtenues par touche morte ---
+ACUTE = dict(zip("aeiouyAEIOUY", "áéíóúýÁÉÍÓÚÝ"))
+GRAVE = dict(zip("aeiouAEIOU", "àèìòùÀÈÌÒÙ"))
+CIRC = dict(zip("aeiouAEIOU", "âêîôûÂÊÎÔÛ"))
+DIAER = dict(zip("aeiouyAEIOU", "äëïöüÿÄËÏÖÜ"))
+TILDE = dict(zip("aonAON", "ãõñÃÕÑ"))
+ACUTE_INTL = dict(ACUTE, c="ç", C="Ç")
+
+# --- Dispositions ---
+US_ROWS = {
+    0x1E: "1!", 0x1F: "2@", 0x20: "3#", 0x21: "4$", 0x22: "5%", 0x23: "6^", 0x24: "7&",
+    0x25: "8*", 0x26: "9(", 0x27: "0)", 0x2D: "-_", 0x2E: "=+", 0x2F: "[{", 0x30: "]}",
+    0x31: "\\|", 0x33: ";:", 0x34: "'\"", 0x35: "`~", 0x36: ",<", 0x37: ".>", 0x38: "/?",
+}
+
+US_INTL_ROWS = dict(US_ROWS)
+US_INTL_ROWS[0x23] = ["6", dead("^")]
+US_INTL_ROWS[0x34] = [dead("'"), dead('"')]
+US_INTL_ROWS[0x35] = [dead("`"), dead("~")]
+
+UK_ROWS = {
+    0x1E: "1!", 0x1F: "2\"", 0x20: "3£", 0x21: "4$", 0x22: "5%", 0x23: "6^", 0x24: "7&",
+    0x25: "8*", 0x26: "9(", 0x27: "0)", 0x2D: "-_", 0x2E: "=+", 0x2F: "[{", 0x30: "]}",
+    0x32: "#~", 0x33: ";:", 0x34: "'@", 0x35: ["`", "¬", "¦"], 0x36: ",<", 0x37: ".>",
+    0x38: "/?", 0x64: "\\|",
+}
+
+FR_LETTERS = letters({"q": "a", "a": "q", "w": "z", "z": "w"})
+del FR_LETTERS[0x10]  # La touche M du QWERTY est la virgule en AZERTY
+FR_ROWS = {
+    0x1E: ["&", "1"], 0x1F: ["é", "2", dead("~")], 0x20: ['"', "3", "#"], 0x21: ["'", "4", "{"],
+    0x22: ["(", "5", "["], 0x23: ["-", "6", "|"], 0x24: ["è", "7", dead("`")], 0x25: ["_", "8", "\\"],
+    0x26: ["ç", "9", "^"], 0x27: ["à", "0", "@"], 0x2D: [")", "°", "]"], 0x2E: ["=", "+", "}"],
+    0x2F: [dead("^"), dead("¨")], 0x30: ["$", "£", "¤"], 0x32: ["*", "µ"], 0x33: ["m", "M"],
+    0x34: ["ù", "%"], 0x35: ["²"], 0x10: [",", "?"], 0x36: [";", "."], 0x37: [":", "/"],
+    0x38: ["!", "§"], 0x64: ["<", ">"],
+}
+
+DE_LETTERS = letters({"y": "z", "z": "y"})
+DE_LETTERS[0x14] = ["q", "Q", "@"]
+DE_LETTERS[0x10] = ["m", "M", "µ"]
+DE_ROWS = {
+    0x1E: ["1", "!"], 0x1F: ["2", '"', "²"], 0x20: ["3", "§", "³"], 0x21: ["4", "$"],
+    0x22: ["5", "%"], 0x23: ["6", "&"], 0x24: ["7", "/", "{"], 0x25: ["8", "(", "["],
+    0x26: ["9", ")", "]"], 0x27: ["0", "=", "}"], 0x2D: ["ß", "?", "\\"],
+    0x2E: [dead("´"), dead("`")], 0x2F: ["ü", "Ü"], 0x30: ["+", "*", "~"], 0x32: ["#", "'"],
+    0x33: ["ö", "Ö"], 0x34: ["ä", "Ä"], 0x35: [dead("^"), "°"], 0x36: [",", ";"],
+    0x37: [".", ":"], 0x38: ["-", "_"], 0x64: ["<", ">", "|"],
+}
+
+# Dans l'ordre de KeyboardLayoutId (kb-layout.h).
+LAYOUTS = (
+    ("US", layout(letters(), US_ROWS), {}),
+    ("US_INTL", layout(letters(), US_INTL_ROWS), {"'": ACUTE_INTL, '"': DIAER, "`": GRAVE, "~": TILDE, "^": CIRC}),
+    ("UK", layout(letters(), UK_ROWS), {}),
+    ("FR", layout(FR_LETTERS, FR_ROWS), {"^": CIRC, "¨": DIAER, "~": TILDE, "`": GRAVE}),
+    ("DE", layout(DE_LETTERS, DE_ROWS), {"´": ACUTE, "`": GRAVE, "^": CIRC}),
+)
+
+
+def build(name, keys, compose):
+    """Retourne (table de 256 entrées, table des touches mortes, signes des touches mortes)."""
+    table = [0] * 256
+    deads = []  # (signe, touche)
+    for usage, chars in sorted(keys.items()):
+        for level, ch in enumerate(chars):
+            if ch is None:
+                continue
+            code = usage | LEVELS[level]
+            if isinstance(ch, tuple):
+                deads.append((ch[1], code))
+            elif ord(ch) < 256 and table[ord(ch)] == 0:
+                table[ord(ch)] = code
+    for ch, usage in CONTROLS:
+        table[ord(ch)] = usage
+    if len(deads) > 7:
+        raise ValueError("%s : plus de 7 touches mortes" % name)
+    for index, (glyph, _) in enumerate(deads, 1):
+        if ord(glyph) < 256 and table[ord(glyph)] == 0:
+            table[ord(glyph)] = (index << 12) | 0x2C  # Touche morte + espace
+        for base, result in compose.get(glyph, {}).items():
+            if table[ord(result)] == 0:
+                code = table[ord(base)]
+                if code == 0 or code >> 12:
+                    raise ValueError("%s : '%s' n'est pas sur une touche simple" % (name, base))
+                table[ord(result)] = (index << 12) | code
+    dead_table = [0] * 8
+    for index, (_, code) in enumerate(deads, 1):
+        dead_table[index] = code
+    return table, dead_table, [glyph for glyph, _ in deads]
+
+
+def render():
+    out = []
+    for name, keys, compose in LAYOUTS:
+        table, dead_table, glyphs = build(name, keys, compose)
+        names = ", ".join("%d = '%s'" % (i, g) for i, g in enumerate(glyphs, 1)) or "aucune"
+        out.append("// %s : touches mortes %s" % (name, names))
+        out.append("constexpr uint16_t KB_MAP_%s[256] PROGMEM = {" % name)
+        for row in range(0, 256, 16):
+            out.append("  /* 0x%02X */ " % row + ", ".join("0x%04X" % v for v in table[row:row + 16]) + ",")
+        out.append("};")
+        out.append("constexpr uint16_t KB_DEAD_%s[8] PROGMEM = { %s };" % (name, ", ".join("0x%04X" % v for v in dead_table)))
+        out.append("")
+    return "\n".join(out) + "\n"
+
+
+def main(args):
+    tables = render()
+    if args[:1] == ["--stdout"]:
+        sys.stdout.write(tables)
+        return
+    path = os.path.join(ROOT, "kb-layout.h")
+    text = open(path, encoding="utf-8", newline="").read()
+    block = re.compile(r"^// US : touches mortes.*?^constexpr uint16_t KB_DEAD_DE\[8\][^\n]*\n\n", re.S | re.M)
+    if not block.search(text):
+        raise SystemExit("kb-layout.h : bloc des tables introuvable")
+    updated = block.sub(lambda m: tables, text, count=1)
+    if updated != text:
+        open(path, "w", encoding="utf-8", newline="").write(updated)
+    print("kb-layout.h : %d dispositions%s" % (len(LAYOUTS), "" if updated != text else " (inchangé)"))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
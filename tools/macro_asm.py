@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+# =============================================================================
+#     ASSEMBLEUR / DÉSASSEMBLEUR DES MACROS EN BYTECODE (voir macro-vm.h)
+# =============================================================================
+# Exemples :
+#   python3 macro_asm.py capture.mac                  # chaîne C pour config.h
+#   python3 macro_asm.py capture.mac -o capture.bin   # programme binaire
+#   python3 macro_asm.py -d capture.bin               # binaire -> texte
+#   python3 macro_asm.py -d --hex "04 0a 03 73 04 00 00"
+#
+# Une instruction par ligne, '#' commence un commentaire :
+#   LABEL "Capture"          affiche un texte
+#   MODS gui shift           tient ces modificateurs (MODS 0 : aucun)
+#   TAP s                    appuie puis relâche une touche
+#   DOWN enter / UP enter    appuie / relâche une touche
+#   RELEASE_ALL              relâche tout
+#   WAIT 40                  attente en ms
+#   TYPE "notepad.exe"       tape un texte (disposition de l'hôte, kb-layout.h)
+#   CONSUMER play_pause      touche multimédia (nom ou usage HID : 0xCD)
+#   MOVE 10 -5 / CLICK left  souris
+#   LAYER 1 / LAYER next     couche
+#   MODE scroll / MODE next  mode de l'encodeur
+#   END                      fin (ajoutée si absente)
+# Touches : un caractère ('a', '1'...), un nom (enter, esc, tab, f5, left...)
+# ou un code Arduino (0xB0).
+# -----------------------------------------------------------------------------
+
+import shlex
+import sys
+
+OPCODES = ["END", "DOWN", "UP", "TAP", "MODS", "RELEASE_ALL", "CONSUMER", "MOVE", "CLICK",
+           "WAIT8", "WAIT", "TYPE", "LAYER", "MODE", "LABEL"]
+OP = {name: i for i, name in enumerate(OPCODES)}
+SIZE = [1, 2, 2, 2, 2, 1, 3, 3, 2, 2, 3, 2, 2, 2, 2]  # MACRO_OP_SIZE
+MAX_SIZE = 255
+NEXT = 0xFF
+
+# Codes des touches spéciales de USBHIDKeyboard.h
+KEYS = {
+    "ctrl": 0x80, "shift": 0x81, "alt": 0x82, "gui": 0x83, "win": 0x83,
+    "rctrl": 0x84, "rshift": 0x85, "ralt": 0x86, "altgr": 0x86, "rgui": 0x87,
+    "up": 0xDA, "down": 0xD9, "left": 0xD8, "right": 0xD7,
+    "backspace": 0xB2, "tab": 0xB3, "enter": 0xB0, "return": 0xB0, "esc": 0xB1,
+    "insert": 0xD1, "delete": 0xD4, "pageup": 0xD3, "pagedown": 0xD6,
+    "home": 0xD2, "end": 0xD5, "capslock": 0xC1, "printscreen": 0xCE, "space": 0x20,
+}
+KEYS.update({"f%d" % n: 0xC1 + n for n in range(1, 13)})
+MODS = {"ctrl": 0x01, "shift": 0x02, "alt": 0x04, "gui": 0x08, "win": 0x08,
+        "rctrl": 0x10, "rshift": 0x20, "ralt": 0x40, "altgr": 0x40, "rgui": 0x80}
+CONSUMER = {"play_pause": 0xCD, "next": 0xB5, "previous": 0xB6, "stop": 0xB7,
+            "mute": 0xE2, "volume_up": 0xE9, "volume_down": 0xEA}
+BUTTONS = {"left": 1, "right": 2, "middle": 4}
+MODES = ["volume", "scroll", "hscroll", "undo_redo"]  # EncoderMode
+
+
+def number(word):
+    return int(word, 0)
+
+
+def key_code(word):
+    if len(word) == 1:
+        return ord(word)
+    if word.lower() in KEYS:
+        return KEYS[word.lower()]
+    return number(word)
+
+
+def named(word, table):
+    word = word.lower()
+    if word == "next":
+        return NEXT
+    if isinstance(table, dict) and word in table:
+        return table[word]
+    if isinstance(table, list) and word in table:
+        return table.index(word)
+    return number(word)
+
+
+def assemble(source):
+    """Texte -> bytecode (bytes). Lève ValueError avec le numéro de ligne."""
+    code, ended = bytearray(), False
+    fixups = []  # (position de l'opérande, texte)
+    for lineno, line in enumerate(source.splitlines(), 1):
+        try:
+            words = shlex.split(line, comments=True)
+        except ValueError as e:
+            raise ValueError("ligne %d : %s" % (lineno, e))
+        if not words:
+            continue
+        op, args = words[0].upper(), words[1:]
+        try:
+            if op in ("DOWN", "UP", "TAP"):
+                code += bytes([OP[op], key_code(args[0])])
+            elif op == "MODS":
+                mask = 0
+                for word in args:
+                    mask |= MODS[word.lower()] if word.lower() in MODS else number(word)
+                code += bytes([OP[op], mask])
+            elif op in ("RELEASE_ALL", "END"):
+                code.append(OP[op])
+                if op == "END":
+                    ended = True
+                    break
+            elif op == "CONSUMER":
+                usage = named(args[0], CONSUMER)
+                code += bytes([OP[op], usage & 0xFF, usage >> 8])
+            elif op == "MOVE":
+                code += bytes([OP[op], number(args[0]) & 0xFF, number(args[1]) & 0xFF])
+            elif op == "CLICK":
+                code += bytes([OP[op], named(args[0], BUTTONS)])
+            elif op == "WAIT":
+                ms = number(args[0])
+                code += bytes([OP["WAIT8"], ms]) if ms <= 0xFF else bytes([OP["WAIT"], ms & 0xFF, ms >> 8])
+            elif op in ("TYPE", "LABEL"):
+                code += bytes([OP[op], 0])
+                fixups.append((len(code) - 1, args[0]))
+            elif op == "LAYER":
+                code += bytes([OP[op], named(args[0], {})])
+            elif op == "MODE":
+                code += bytes([OP[op], named(args[0], MODES)])
+            else:
+                raise ValueError("instruction inconnue '%s'" % words[0])
+        except (IndexError, KeyError, ValueError) as e:
+            raise ValueError("ligne %d : %s" % (lineno, e if str(e) else "parametre manquant"))
+    if not ended:
+        code.append(OP["END"])
+    # Réserve de textes après le code, un exemplaire par texte
+    pool, where = bytearray(), {}
+    for text in [t for _, t in fixups]:
+        if text not in where:
+            where[text] = len(code) + len(pool)
+            pool += text.encode("utf-8") + b"\0"
+    for pos, text in fixups:
+        code[pos] = where[text]
+    program = bytes(code + pool)
+    if len(program) > MAX_SIZE or any(v > 0xFF for v in where.values()):
+        raise ValueError("programme trop long (%d octets, %d au plus)" % (len(program), MAX_SIZE))
+    return program
+
+
+def disassemble(program):
+    """Bytecode -> texte (une instruction par ligne)."""
+    lines, pc = [], 0
+
+    def text_at(pos):
+        end = program.index(b"\0", pos)
+        return '"%s"' % program[pos:end].decode("utf-8", "replace").replace('"', '\\"')
+
+    def key_name(code):
+        for name, value in KEYS.items():
+            if value == code and name not in ("win", "return", "altgr", "space"):
+                return name
+        return chr(code) if 0x21 <= code < 0x7F else "0x%02X" % code
+
+    while pc < len(program):
+        op = program[pc]
+        if op >= len(OPCODES) or pc + SIZE[op] > len(program):
+            lines.append("# octet invalide 0x%02X a la position %d" % (op, pc))
+            break
+        a = program[pc + 1:pc + SIZE[op]]
+        name = OPCODES[op]
+        if name == "END":
+            lines.append("END")
+            break
+        elif name in ("DOWN", "UP", "TAP"):
+            lines.append("%s %s" % (name, key_name(a[0])))
+        elif name == "MODS":
+            words = [m for m, bit in MODS.items() if a[0] & bit and m not in ("win", "altgr")]
+            lines.append("MODS " + (" ".join(words) if words else "0"))
+        elif name == "RELEASE_ALL":
+            lines.append(name)
+        elif name == "CONSUMER":
+            usage = a[0] | (a[1] << 8)
+            names = [n for n, v in CONSUMER.items() if v == usage]
+            lines.append("CONSUMER " + (names[0] if names else "0x%02X" % usage))
+        elif name == "MOVE":
+            lines.append("MOVE %d %d" % (a[0] - 256 * (a[0] > 127), a[1] - 256 * (a[1] > 127)))
+        elif name == "CLICK":
+            names = [n for n, v in BUTTONS.items() if v == a[0]]
+            lines.append("CLICK " + (names[0] if names else str(a[0])))
+        elif name in ("WAIT8", "WAIT"):
+            lines.append("WAIT %d" % (a[0] | ((a[1] << 8) if name == "WAIT" else 0)))
+        elif name in ("TYPE", "LABEL"):
+            lines.append("%s %s" % (name, text_at(a[0])))
+        elif name == "LAYER":
+            lines.append("LAYER " + ("next" if a[0] == NEXT else str(a[0])))
+        elif name == "MODE":
+            lines.append("MODE " + ("next" if a[0] == NEXT else MODES[a[0]] if a[0] < len(MODES) else str(a[0])))
+        pc += SIZE[op]
+    return "\n".join(lines)
+
+
+def c_string(program):
+    """Bytecode -> chaîne littérale C (le zéro final du C n'est pas compté)."""
+    out, last_hex = '"', False
+    for b in program:
+        c = chr(b)
+        if 0x20 <= b < 0x7F and c not in '"\\?':
+            if last_hex and c in "0123456789abcdefABCDEF":
+                out += '" "'  # Sinon le caractère prolongerait l'échappement \x précédent
+            out += c
+            last_hex = False
+        else:
+            out += "\\x%02x" % b
+            last_hex = True
+    return out + '"'
+
+
+def main(argv):
+    if len(argv) < 2:
+        print("Usage : macro_asm.py FICHIER.mac [-o sortie.bin] | -d FICHIER.bin | -d --hex \"04 01 ...\"")
+        return 1
+    if argv[1] == "-d":
+        program = bytes.fromhex(argv[3]) if argv[2] == "--hex" else open(argv[2], "rb").read()
+        print(disassemble(program))
+        return 0
+    try:
+        program = assemble(open(argv[1], encoding="utf-8").read())
+    except ValueError as e:
+        print("Erreur : %s" % e)
+        return 1
+    if "-o" in argv:
+        open(argv[argv.index("-o") + 1], "wb").write(program)
+    print("// %d octets" % len(program))
+    print(c_string(program))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
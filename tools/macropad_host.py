@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+# =============================================================================
+#     COMPAGNON DU MACROPAD : CANAL HID VENDEUR (voir host-link.h)
+# =============================================================================
+# Pousse vers le macropad le vrai volume, l'état muet et l'application au
+# premier plan, et mesure l'aller-retour d'un rapport.
+#
+# Accès au périphérique : module 'hid' (pip install hidapi) s'il est installé,
+# sinon /dev/hidraw* directement sous Linux (droits de lecture/écriture
+# nécessaires, par ex. une règle udev pour le VID 303a).
+#
+# Exemples :
+#   python3 macropad_host.py etat
+#   python3 macropad_host.py volume 35            # 35 %, son actif
+#   python3 macropad_host.py volume 35 muet
+#   python3 macropad_host.py appli Code.exe
+#   python3 macropad_host.py ping 1000            # p50 / p99 / max de l'aller-retour
+#   python3 macropad_host.py suivre               # Linux : pactl + xdotool, en continu
+#   python3 macropad_host.py --boucle ping 1000   # sans carte : firmware simulé
+#
+# --boucle remplace la carte par une doublure en Python (FirmwareStandIn)
+# qui répond comme hostLinkPoll() à travers un tube : utile pour tester ce
+# script et mesurer son propre coût sur l'aller-retour.
+# -----------------------------------------------------------------------------
+
+import glob
+import os
+import select
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+REPORT_SIZE = 32
+SET_VOLUME, SET_APP, PING, GET_STATE = 0x01, 0x02, 0x03, 0x04
+PONG, STATE = 0x83, 0x84
+VENDOR_COLLECTION = bytes([0x06, 0x00, 0xFF, 0x09, 0x01, 0xA1, 0x01, 0x85])  # HOST_LINK_DESCRIPTOR
+ESPRESSIF_VID = 0x303A
+MODES = ["volume", "scroll", "scroll H", "undo/redo"]
+
+
+def pad(data):
+    return bytes(data)[:REPORT_SIZE].ljust(REPORT_SIZE, b"\0")
+
+
+class HidrawLink:
+    """Linux sans dépendance : /dev/hidrawN dont le descripteur contient la collection vendeur."""
+
+    def __init__(self, path=None):
+        for node in ([path] if path else sorted(glob.glob("/dev/hidraw*"))):
+            desc = "/sys/class/hidraw/%s/device/report_descriptor" % os.path.basename(node)
+            try:
+                data = open(desc, "rb").read()
+            except OSError:
+                continue
+            at = data.find(VENDOR_COLLECTION)
+            if at >= 0:
+                self.report_id = data[at + len(VENDOR_COLLECTION)]
+                self.fd = os.open(node, os.O_RDWR)
+                return
+        raise RuntimeError("macropad introuvable (aucun /dev/hidraw* avec la collection vendeur)")
+
+    def write(self, data):
+        os.write(self.fd, bytes([self.report_id]) + pad(data))
+
+    def read(self, timeout):
+        end = time.monotonic() + timeout
+        while True:
+            left = end - time.monotonic()
+            if left <= 0 or not select.select([self.fd], [], [], left)[0]:
+                return None
+            data = os.read(self.fd, 64)
+            if data and data[0] == self.report_id:  # Les autres rapports (clavier, souris) sont ignorés
+                return data[1:]
+
+
+class HidapiLink:
+    """Multiplateforme, avec le module 'hid' (hidapi)."""
+
+    def __init__(self, hid, report_id=6):
+        for info in hid.enumerate(ESPRESSIF_VID):
+            if info.get("usage_page") == 0xFF00:
+                self.dev = hid.device()
+                self.dev.open_path(info["path"])
+                self.report_id = report_id
+                return
+        raise RuntimeError("macropad introuvable (VID 303a, page d'usage 0xFF00)")
+
+    def write(self, data):
+        self.dev.write(bytes([self.report_id]) + pad(data))
+
+    def read(self, timeout):
+        data = self.dev.read(REPORT_SIZE + 1, int(timeout * 1000))
+        if not data:
+            return None
+        data = bytes(data)
+        return data[1:] if len(data) > REPORT_SIZE else data
+
+
+class FirmwareStandIn:
+    """Doublure du firmware : traite les rapports comme hostLinkPoll(), via deux tubes."""
+
+    def __init__(self):
+        self.to_fw_r, self.to_fw_w = os.pipe()
+        self.from_fw_r, self.from_fw_w = os.pipe()
+        self.state = {"layer": 0, "mode": 0, "volume": 50, "muted": 0, "profile": 0xFF}
+        threading.Thread(target=self._run, daemon=True).start()
+
+    def _run(self):
+        while True:
+            report = os.read(self.to_fw_r, REPORT_SIZE)
+            if report[0] == SET_VOLUME:
+                self.state["volume"], self.state["muted"] = report[1], report[2]
+            elif report[0] == PING:
+                os.write(self.from_fw_w, bytes([PONG]) + report[1:])
+            elif report[0] == GET_STATE:
+                s = self.state
+                os.write(self.from_fw_w, pad([STATE, s["layer"], s["mode"], s["volume"], s["muted"], s["profile"], 1]))
+
+    def write(self, data):
+        os.write(self.to_fw_w, pad(data))
+
+    def read(self, timeout):
+        if not select.select([self.from_fw_r], [], [], timeout)[0]:
+            return None
+        return os.read(self.from_fw_r, REPORT_SIZE)
+
+
+def open_link(loopback):
+    if loopback:
+        return FirmwareStandIn()
+    try:
+        import hid
+        return HidapiLink(hid)
+    except ImportError:
+        return HidrawLink()
+
+
+def request(link, data, expect, timeout=0.5):
+    link.write(data)
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        reply = link.read(end - time.monotonic())
+        if reply and reply[0] == expect:
+            return reply
+    raise RuntimeError("pas de reponse (0x%02x)" % expect)
+
+
+def ping(link, count):
+    times = []
+    for i in range(count):
+        stamp = struct.pack("<IQ", i, time.perf_counter_ns())
+        start = time.perf_counter_ns()
+        link.write(bytes([PING]) + stamp)
+        end = time.monotonic() + 0.5
+        while True:
+            reply = link.read(max(0.0, end - time.monotonic()))
+            if reply is None:
+                break
+            if reply[0] == PONG and reply[1:1 + len(stamp)] == stamp:
+                times.append((time.perf_counter_ns() - start) / 1000.0)
+                break
+    if not times:
+        raise RuntimeError("aucun PONG recu")
+    times.sort()
+    pct = lambda p: times[min(len(times) - 1, int(len(times) * p / 100))]
+    print("%d/%d reponses, aller-retour (us) : p50 %.0f   p99 %.0f   max %.0f"
+          % (len(times), count, pct(50), pct(99), times[-1]))
+
+
+def linux_volume():
+    try:
+        vol = subprocess.run(["pactl", "get-sink-volume", "@DEFAULT_SINK@"], capture_output=True, text=True).stdout
+        mute = subprocess.run(["pactl", "get-sink-mute", "@DEFAULT_SINK@"], capture_output=True, text=True).stdout
+        percent = int(vol.split("%")[0].split()[-1])
+        return min(100, percent), 1 if "yes" in mute else 0
+    except (OSError, ValueError, IndexError):
+        return None
+
+
+def linux_foreground_app():
+    try:
+        pid = subprocess.run(["xdotool", "getactivewindow", "getwindowpid"], capture_output=True, text=True).stdout.strip()
+        return open("/proc/%s/comm" % pid).read().strip() if pid else None
+    except OSError:
+        return None
+
+
+def follow(link, period=0.2, refresh=5.0):
+    """Pousse le volume et l'application dès qu'ils changent (et toutes les 'refresh' s)."""
+    last_volume, last_app, last_push = None, None, 0.0
+    while True:
+        now = time.monotonic()
+        force = now - last_push >= refresh
+        volume, app = linux_volume(), linux_foreground_app()
+        if volume is not None and (volume != last_volume or force):
+            link.write(bytes([SET_VOLUME, volume[0], volume[1]]))
+            last_volume = volume
+        if app is not None and (app != last_app or force):
+            link.write(bytes([SET_APP]) + app.encode("utf-8")[:REPORT_SIZE - 2])
+            if app != last_app:
+                print("Application : " + app)
+            last_app = app
+        if force:
+            last_push = now
+        time.sleep(period)
+
+
+def main(argv):
+    loopback = "--boucle" in argv
+    args = [a for a in argv[1:] if a != "--boucle"]
+    if not args:
+        print("Usage : macropad_host.py [--boucle] etat|volume N [muet]|appli NOM|ping [N]|suivre")
+        return 1
+    link, cmd = open_link(loopback), args[0]
+    if cmd == "etat":
+        r = request(link, [GET_STATE], STATE)
+        print({"couche": r[1], "mode": MODES[r[2]] if r[2] < len(MODES) else r[2], "volume": r[3],
+               "muet": bool(r[4]), "profil": None if r[5] == 0xFF else r[5], "version": r[6]})
+    elif cmd == "volume":
+        link.write(bytes([SET_VOLUME, int(args[1]), 1 if "muet" in args[2:] else 0]))
+    elif cmd == "appli":
+        link.write(bytes([SET_APP]) + args[1].encode("utf-8")[:REPORT_SIZE - 2])
+    elif cmd == "ping":
+        ping(link, int(args[1]) if len(args) > 1 else 100)
+    elif cmd == "suivre":
+        follow(link)
+    else:
+        print("Commande inconnue : " + cmd)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
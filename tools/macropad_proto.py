@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+# =============================================================================
+#     CLIENT DU PROTOCOLE DE CONFIGURATION DU MACROPAD (voir protocol.h)
+# =============================================================================
+# Dépendance : pyserial (pip install pyserial)
+#
+# Exemples :
+#   python3 macropad_proto.py COM5 ping
+#   python3 macropad_proto.py /dev/ttyACM0 lire 0 3          # couche 0, touche K4
+#   python3 macropad_proto.py /dev/ttyACM0 envoyer keymap.json
+#   python3 macropad_proto.py /dev/ttyACM0 effacer
+#   python3 macropad_proto.py /dev/ttyACM0 reglages
+#   python3 macropad_proto.py /dev/ttyACM0 icone 0 mon_icone.bin  # 32 octets, format drawBitmap
+#
+# Format de keymap.json : une liste de couches, chacune une liste de 9 touches.
+# Une touche vaut null (garder l'action de config.h) ou un objet :
+#   {"type": "run", "texte": "notepad.exe", "label": "NOTEPAD", "icone": 16}
+#   {"type": "ctrl", "code": "c", "label": "Copier"}
+#   {"type": "media", "code": 205, "label": "Play/Pause"}
+#   {"type": "program", "label": "Capture", "macro": ["MODS gui shift", "TAP s"]}
+# Types : message, run, ctrl, ctrl_shift, alt_tab, win_d, media, layer_next,
+# program (macro en bytecode, voir macro_asm.py ; 40 octets au plus).
+# -----------------------------------------------------------------------------
+
+import json
+import struct
+import sys
+import zlib
+
+import serial
+
+from macro_asm import assemble, disassemble
+
+PING, KEY_READ, KEY_WRITE, KEYMAP_CLEAR = 0x01, 0x10, 0x11, 0x12
+SETTINGS_READ, SETTINGS_WRITE = 0x20, 0x21
+ICON_READ, ICON_WRITE = 0x30, 0x31
+UPLOAD_BEGIN, UPLOAD_CHUNK, UPLOAD_END, UPLOAD_ABORT = 0x40, 0x41, 0x42, 0x43
+UPLOAD_KEYMAP, UPLOAD_ICONS = 0, 1
+
+STATUS = ["OK", "CRC", "commande inconnue", "parametres invalides", "hors sequence", "CRC-32 faux"]
+KINDS = ["firmware", "message", "run", "ctrl", "ctrl_shift", "alt_tab", "win_d", "media", "layer_next", "program"]
+LABEL_LEN, TEXT_LEN, NO_ICON = 20, 40, 0xFF
+RECORD = struct.Struct("<BBH%ds%ds" % (LABEL_LEN, TEXT_LEN))  # KeyRecord (keymap.h)
+SETTINGS = struct.Struct("<8B")                                # SettingsBlob (settings.h)
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out, block = bytearray(), bytearray()
+    for b in data:
+        if b == 0:
+            out += bytes([len(block) + 1]) + block
+            block = bytearray()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out += b"\xff" + block
+                block = bytearray()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out, i = bytearray(), 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("trame COBS invalide")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Macropad:
+    def __init__(self, port):
+        self.port = serial.Serial(port, 115200, timeout=1)
+        self.seq = 0
+
+    def request(self, cmd, payload=b"", retries=3):
+        """Envoie une commande et retourne les données de la réponse."""
+        for _ in range(retries):
+            self.seq = (self.seq + 1) & 0xFF
+            packet = bytes([cmd, self.seq]) + payload
+            packet += struct.pack("<H", crc16_ccitt(packet))
+            self.port.write(b"\x00" + cobs_encode(packet) + b"\x00")
+            reply = self._read_reply()
+            if reply is None or reply[2] == 1:  # Perdue ou abîmée : on renvoie
+                continue
+            if reply[2] != 0:
+                raise RuntimeError("commande 0x%02x : %s" % (cmd, STATUS[reply[2]] if reply[2] < len(STATUS) else reply[2]))
+            return reply[3:-2]
+        raise RuntimeError("commande 0x%02x : pas de reponse" % cmd)
+
+    def _read_reply(self):
+        while True:
+            frame = self.port.read_until(b"\x00")
+            if not frame.endswith(b"\x00"):
+                return None  # Délai dépassé
+            frame = frame[:-1]
+            if not frame:
+                continue  # Délimiteur d'ouverture
+            try:
+                packet = cobs_decode(frame)
+            except ValueError:
+                continue
+            if len(packet) < 5 or crc16_ccitt(packet[:-2]) != struct.unpack("<H", packet[-2:])[0]:
+                continue
+            if packet[1] == self.seq:
+                return packet
+
+    def ping(self):
+        v = self.request(PING)
+        return {"version": v[0], "couches": v[1], "touches": v[2], "record": v[3],
+                "icones": v[4], "octets_icone": v[5], "morceau_max": v[6] | (v[7] << 8)}
+
+    def upload(self, target, blob):
+        """Envoi par morceaux acquittés (reprise à la position donnée par la carte)."""
+        chunk = struct.unpack("<H", self.request(UPLOAD_BEGIN, struct.pack("<BII", target, len(blob), zlib.crc32(blob))))[0]
+        offset = 0
+        try:
+            while offset < len(blob):
+                ack = self.request(UPLOAD_CHUNK, struct.pack("<I", offset) + blob[offset:offset + chunk])
+                offset = struct.unpack("<I", ack)[0]
+            self.request(UPLOAD_END)
+        except Exception:
+            self.request(UPLOAD_ABORT)
+            raise
+
+
+def encode_key(key):
+    if key is None:
+        return bytes(RECORD.size)
+    code = key.get("code", 0)
+    if isinstance(code, str):
+        code = ord(code)
+    if key["type"] == "program":
+        text = assemble("\n".join(key["macro"]))
+        if len(text) > TEXT_LEN:
+            raise ValueError("macro trop longue pour une touche (%d octets, %d au plus)" % (len(text), TEXT_LEN))
+    else:
+        text = key.get("texte", "").encode("utf-8")[:TEXT_LEN - 1]
+    return RECORD.pack(KINDS.index(key["type"]), key.get("icone", NO_ICON), code,
+                       key.get("label", "").encode("latin-1")[:LABEL_LEN - 1], text)
+
+
+def decode_key(data):
+    kind, icon, code, label, text = RECORD.unpack(data)
+    key = {"type": KINDS[kind] if kind < len(KINDS) else kind, "icone": icon, "code": code,
+           "label": label.split(b"\0")[0].decode("latin-1")}
+    if key["type"] == "program":
+        key["macro"] = disassemble(text).split("\n")
+    else:
+        key["texte"] = text.split(b"\0")[0].decode("utf-8", "replace")
+    return key
+
+
+def main(argv):
+    if len(argv) < 3:
+        print("Usage : macropad_proto.py PORT ping|lire|envoyer|effacer|reglages|icone [args]")
+        return 1
+    pad, cmd, args = Macropad(argv[1]), argv[2], argv[3:]
+    if cmd == "ping":
+        print(pad.ping())
+    elif cmd == "lire":
+        data = pad.request(KEY_READ, bytes([int(args[0]), int(args[1])]))
+        print(("redefinie " if data[0] else "config.h ") + json.dumps(decode_key(data[1:]), ensure_ascii=False))
+    elif cmd == "envoyer":
+        info = pad.ping()
+        layers = json.load(open(args[0], encoding="utf-8"))
+        blob = b""
+        for layer in range(info["couches"]):
+            keys = layers[layer] if layer < len(layers) else []
+            for key in range(info["touches"]):
+                blob += encode_key(keys[key] if key < len(keys) else None)
+        pad.upload(UPLOAD_KEYMAP, blob)
+        print("Table envoyee (%d octets)." % len(blob))
+    elif cmd == "effacer":
+        pad.request(KEYMAP_CLEAR)
+        print("Retour a la table de config.h.")
+    elif cmd == "reglages":
+        print(dict(zip(["version", "luminosite", "couche", "mode_encodeur", "muet", "profil", "clavier", "_"],
+                       SETTINGS.unpack(pad.request(SETTINGS_READ)))))
+    elif cmd == "icone":
+        data = open(args[1], "rb").read()
+        pad.request(ICON_WRITE, bytes([int(args[0])]) + data[:32].ljust(32, b"\0"))
+        print("Icone %s envoyee (index %d pour une touche)." % (args[0], 0x80 + int(args[0])))
+    else:
+        print("Commande inconnue : " + cmd)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,181 @@
+#pragma once
+#include <USBHIDKeyboard.h>
+#include "kb-layout.h"
+
+// =============================================================================
+//     MODULE DE FRAPPE DE TEXTE (6 TOUCHES PAR RAPPORT)
+// =============================================================================
+// Keyboard.print() envoie deux rapports HID par caractère (appui puis
+// relâchement). Ici, les caractères consécutifs sont regroupés : jusqu'à six
+// touches différentes appuyées dans le même rapport, puis un seul rapport de
+// relâchement. Un lot est coupé quand :
+//  - les modificateurs changent (ex: minuscule puis majuscule),
+//  - une touche se répète (on ne peut pas appuyer deux fois la même touche),
+//  - un caractère demande une touche morte (elle part seule, avant sa base),
+//  - six touches sont déjà dans le lot.
+// L'hôte traite les touches d'un même rapport dans l'ordre du tableau keys[].
+//
+// Le texte est tapé par-dessus les touches et modificateurs tenus par les
+// autres pistes de macros (ex: Ctrl de l'encodeur) : chaque rapport les
+// reprend, et le relâchement d'un lot ne retire que les touches du texte.
+//
+// La frappe est non bloquante : typistRun() est appelée à chaque tour par
+// l'exécuteur de macros et n'envoie un rapport que lorsque le délai
+// correspondant à la vitesse visée (typistTargetCps) est écoulé.
+// -----------------------------------------------------------------------------
+
+extern USBHIDKeyboard Keyboard;
+
+const uint16_t TYPIST_TARGET_CPS = 250; // Vitesse visée par défaut (caractères / seconde)
+const uint8_t TYPIST_MAX_KEYS = 6;      // Rapport clavier "boot protocol"
+
+struct Typist {
+  const char* next = nullptr;   // Prochain caractère à lire (nullptr = au repos)
+  KeyStroke carry = {0, 0};     // Touche de base à taper après une touche morte
+  bool keysDown = false;        // Un lot est actuellement appuyé
+  uint8_t batchChars = 0;       // Caractères du lot en cours
+  unsigned long readyAtUs = 0;  // Date du prochain rapport autorisé
+  unsigned long startUs = 0;    // Début de la frappe du texte en cours
+};
+
+// --- Variables propres à ce module ---
+uint16_t typistTargetCps = TYPIST_TARGET_CPS;
+uint32_t typistReports = 0;     // Rapports HID envoyés
+uint32_t typistChars = 0;       // Caractères tapés
+uint32_t typistBusyUs = 0;      // Temps total passé à taper
+
+// Durée d'une demi-période (appui ou relâchement) pour un lot de 'chars' caractères.
+inline unsigned long typistHalfSlotUs(uint8_t chars) {
+  return 500000UL * max((uint8_t)1, chars) / max((uint16_t)1, typistTargetCps);
+}
+
+void typistSend(const KeyReport& report) {
+  Keyboard.sendReport(const_cast<KeyReport*>(&report));
+  typistReports++;
+}
+
+// Ajoute une frappe à un rapport, comme Keyboard.pressRaw() (rien si le rapport est plein).
+void keyReportPress(KeyReport& report, const KeyStroke& stroke) {
+  report.modifiers |= stroke.modifiers;
+  if (stroke.usage == 0) return;
+  int8_t freeSlot = -1;
+  for (int8_t i = TYPIST_MAX_KEYS - 1; i >= 0; i--) {
+    if (report.keys[i] == stroke.usage) return;
+    if (report.keys[i] == 0) freeSlot = i;
+  }
+  if (freeSlot >= 0) report.keys[freeSlot] = stroke.usage;
+}
+
+// Retire une frappe d'un rapport, comme Keyboard.releaseRaw().
+void keyReportRelease(KeyReport& report, const KeyStroke& stroke) {
+  report.modifiers &= ~stroke.modifiers;
+  if (stroke.usage == 0) return;
+  for (uint8_t i = 0; i < TYPIST_MAX_KEYS; i++) {
+    if (report.keys[i] == stroke.usage) report.keys[i] = 0;
+  }
+}
+
+// Nombre de touches (hors modificateurs) d'un rapport.
+uint8_t keyReportCount(const KeyReport& report) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < TYPIST_MAX_KEYS; i++) n += (report.keys[i] != 0);
+  return n;
+}
+
+// Ajoute une frappe au lot si elle est compatible. Retourne false sinon.
+bool typistAdd(KeyReport& report, uint8_t& count, const KeyStroke& stroke, uint8_t maxKeys = TYPIST_MAX_KEYS) {
+  if (count >= maxKeys) return false;
+  if (count > 0 && stroke.modifiers != report.modifiers) return false;
+  for (uint8_t i = 0; i < count; i++) {
+    if (report.keys[i] == stroke.usage) return false;
+  }
+  report.modifiers = stroke.modifiers;
+  report.keys[count++] = stroke.usage;
+  return true;
+}
+
+// Construit le prochain lot à partir du texte, d'au plus 'maxKeys' touches. Retourne le nombre de touches.
+uint8_t typistBuildBatch(Typist& ty, KeyReport& report, uint8_t& chars, uint8_t maxKeys) {
+  uint8_t count = 0;
+  chars = 0;
+  if (ty.carry.usage != 0) {
+    typistAdd(report, count, ty.carry);
+    ty.carry.usage = 0;
+    chars++;
+  }
+
+  const KeyboardLayout& layout = KEYBOARD_LAYOUTS[hostLayout];
+  while (count < maxKeys) {
+    const char* p = ty.next;
+    int16_t ch = utf8NextLatin1(p);
+    if (ch == 0) break;                  // Fin du texte
+
+    KeyStroke strokes[2];
+    uint8_t n = (ch > 0) ? layoutCharToStrokes(layout, (uint8_t)ch, strokes) : 0;
+    if (n == 0) { ty.next = p; continue; } // Caractère impossible : ignoré
+
+    if (n == 2) {                        // Touche morte : elle part seule
+      if (count > 0) break;
+      typistAdd(report, count, strokes[0]);
+      ty.carry = strokes[1];
+      ty.next = p;
+      break;
+    }
+    if (!typistAdd(report, count, strokes[0], maxKeys)) break;
+    ty.next = p;
+    chars++;
+  }
+  return count;
+}
+
+/**
+ * @brief Fait avancer la frappe d'un texte sans bloquer.
+ * @param ty L'état de frappe (un par piste de macros).
+ * @param text Le texte UTF-8 à taper.
+ * @param held Les touches et modificateurs tenus par ailleurs, gardés dans chaque rapport.
+ * @return true tant que la frappe n'est pas terminée.
+ */
+bool typistRun(Typist& ty, const char* text, const KeyReport& held) {
+  unsigned long now = micros();
+  if (ty.next == nullptr) {
+    ty.next = text;
+    ty.carry.usage = 0;
+    ty.keysDown = false;
+    ty.readyAtUs = now;
+    ty.startUs = now;
+  }
+  if ((long)(now - ty.readyAtUs) < 0) return true;
+
+  // Chaque lot dure batchChars / typistTargetCps : moitié appuyé, moitié relâché
+  if (ty.keysDown) {
+    typistSend(held); // Relâche les touches du texte seulement
+    ty.keysDown = false;
+    ty.readyAtUs = now + typistHalfSlotUs(ty.batchChars);
+    if (*ty.next == 0 && ty.carry.usage == 0) {
+      typistBusyUs += now - ty.startUs;
+      ty.next = nullptr;
+      return false;
+    }
+    return true;
+  }
+
+  // Le lot prend les places laissées libres par les touches tenues
+  KeyReport batch = {};
+  uint8_t room = max(1, TYPIST_MAX_KEYS - keyReportCount(held));
+  uint8_t count = typistBuildBatch(ty, batch, ty.batchChars, room);
+  if (count == 0) {
+    typistBusyUs += now - ty.startUs;
+    ty.next = nullptr;
+    return false;
+  }
+  KeyReport report = held;
+  report.modifiers |= batch.modifiers;
+  for (uint8_t i = 0; i < count; i++) keyReportPress(report, KeyStroke{ 0, batch.keys[i] });
+  typistSend(report);
+  typistChars += ty.batchChars;
+  ty.keysDown = true;
+  ty.readyAtUs = now + typistHalfSlotUs(ty.batchChars);
+  return true;
+}
+
+/* ------------------------------ Fin du code -------------------------------- */